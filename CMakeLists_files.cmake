@@ -35,6 +35,7 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/flow_ebos_oilwater_polymer.cpp
 
   opm/autodiff/Compat.cpp
+  opm/autodiff/ConnectionOperator.cpp
   opm/autodiff/ExtractParallelGridInformationToISTL.cpp
   opm/autodiff/NewtonIterationBlackoilCPR.cpp
   opm/autodiff/NewtonIterationBlackoilInterleaved.cpp
@@ -51,6 +52,7 @@ list (APPEND MAIN_SOURCE_FILES
   opm/autodiff/BlackoilModelParameters.cpp
   opm/autodiff/WellDensitySegmented.cpp
   opm/autodiff/LinearisedBlackoilResidual.cpp
+  opm/autodiff/LinearSystemSnapshot.cpp
   opm/autodiff/VFPProperties.cpp
   opm/autodiff/VFPProdProperties.cpp
   opm/autodiff/VFPInjProperties.cpp
@@ -93,6 +95,7 @@ list (APPEND MAIN_SOURCE_FILES
   opm/core/simulator/TwophaseState.cpp
   opm/core/simulator/SimulatorReport.cpp
   opm/core/transport/TransportSolverTwophaseInterface.cpp
+  opm/core/transport/reorder/ComponentLevels.cpp
   opm/core/transport/reorder/ReorderSolverInterface.cpp
   opm/core/transport/reorder/TransportSolverCompressibleTwophaseReorder.cpp
   opm/core/transport/reorder/TransportSolverTwophaseReorder.cpp
@@ -123,6 +126,9 @@ list (APPEND MAIN_SOURCE_FILES
   opm/simulators/ensureDirectoryExists.cpp
   opm/simulators/SimulatorCompressibleTwophase.cpp
   opm/simulators/WellSwitchingLogger.cpp
+  opm/simulators/BatchedAllReduce.cpp
+  opm/simulators/Tracer.cpp
+  opm/simulators/vtk/VtkWriter.cpp
   opm/simulators/vtk/writeVtkData.cpp
   opm/simulators/timestepping/TimeStepControl.cpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.cpp
@@ -138,10 +144,14 @@ endif()
 # find tests -name '*.cpp' -a ! -wholename '*/not-unit/*' -printf '\t%p\n' | sort
 list (APPEND TEST_SOURCE_FILES
   tests/test_autodiffhelpers.cpp
+  tests/test_connectionoperator.cpp
   tests/test_autodiffmatrix.cpp
+  tests/test_autodiffproduct.cpp
   tests/test_blackoil_amg.cpp
+  tests/test_mixedprecisionpreconditioner.cpp
   tests/test_block.cpp
   tests/test_boprops_ad.cpp
+  tests/test_pvtcellgroups.cpp
   tests/test_rateconverter.cpp
   tests/test_span.cpp
   tests/test_syntax.cpp
@@ -155,11 +165,18 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_wellmodel.cpp
 #  tests/test_thresholdpressure.cpp
   tests/test_wellswitchlogger.cpp
+  tests/test_batchedallreduce.cpp
+  tests/test_tracer.cpp
   tests/test_timer.cpp
+  tests/test_statecheckpoint.cpp
   tests/test_invert.cpp
   tests/test_event.cpp
   tests/test_dgbasis.cpp
   tests/test_flowdiagnostics.cpp
+  tests/test_componentlevels.cpp
+  tests/test_vtkwriter.cpp
+  tests/test_linearsystemsnapshot.cpp
+  tests/test_wellindexmap.cpp
   tests/test_wells.cpp
   tests/test_linearsolver.cpp
   tests/test_satfunc.cpp
@@ -184,6 +201,7 @@ endif()
 
 list (APPEND TEST_DATA_FILES
   tests/fluid.data
+  tests/pvt_regions.DATA
   tests/VFPPROD1
   tests/VFPPROD2
   tests/msw.data
@@ -235,6 +253,7 @@ list (APPEND EXAMPLE_SOURCE_FILES
   examples/compute_initial_state.cpp
   examples/compute_tof_from_files.cpp
   examples/diagnose_relperm.cpp
+  examples/replay_linear_system.cpp
   tutorials/sim_tutorial1.cpp
   )
 
@@ -258,11 +277,23 @@ list (APPEND PROGRAM_SOURCE_FILES
   examples/sim_poly2p_incomp_reorder.cpp
   )
 
+# micro-benchmarks of the computational kernels; not built by default,
+# but with the target "benchmarks"
+list (APPEND BENCHMARK_SOURCE_FILES
+  benchmarks/bench_amg.cpp
+  benchmarks/bench_autodiff.cpp
+  benchmarks/bench_ilu0.cpp
+  benchmarks/bench_rateconverter.cpp
+  benchmarks/bench_reorder.cpp
+  benchmarks/bench_vfp.cpp
+  )
+
 # originally generated with the command:
 # find opm -name '*.h*' -a ! -name '*-pch.hpp' -printf '\t%p\n' | sort
 list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/AutoDiffBlock.hpp
   opm/autodiff/AutoDiffHelpers.hpp
+  opm/autodiff/AutoDiffProduct.hpp
   opm/autodiff/AutoDiffMatrix.hpp
   opm/autodiff/AutoDiff.hpp
   opm/autodiff/BlackoilAmg.hpp
@@ -276,6 +307,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/BlackoilPressureModel.hpp
   opm/autodiff/BlackoilPropsAdFromDeck.hpp
   opm/autodiff/Compat.hpp
+  opm/autodiff/ConnectionOperator.hpp
   opm/autodiff/CPRPreconditioner.hpp
   opm/autodiff/createGlobalCellArray.hpp
   opm/autodiff/DefaultBlackoilSolutionState.hpp
@@ -295,6 +327,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/ImpesTPFAAD.hpp
   opm/autodiff/ISTLSolver.hpp
   opm/autodiff/IterationReport.hpp
+  opm/autodiff/LinearSystemSnapshot.hpp
   opm/autodiff/moduleVersion.hpp
   opm/autodiff/multiPhaseUpwind.hpp
   opm/autodiff/NewtonIterationBlackoilCPR.hpp
@@ -308,6 +341,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/ParallelDebugOutput.hpp
   opm/autodiff/ParallelOverlappingILU0.hpp
   opm/autodiff/ParallelRestrictedAdditiveSchwarz.hpp
+  opm/autodiff/PvtCellGroups.hpp
   opm/autodiff/RateConverter.hpp
   opm/autodiff/RedistributeDataHandles.hpp
   opm/autodiff/SimFIBODetails.hpp
@@ -341,6 +375,7 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/BlackoilWellModel.hpp
   opm/autodiff/BlackoilWellModel_impl.hpp
   opm/autodiff/MissingFeatures.hpp
+  opm/autodiff/MixedPrecisionPreconditioner.hpp
   opm/core/flowdiagnostics/AnisotropicEikonal.hpp
   opm/core/flowdiagnostics/DGBasis.hpp
   opm/core/flowdiagnostics/FlowDiagnostics.hpp
@@ -397,12 +432,14 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/core/simulator/ExplicitArraysSatDerivativesFluidState.hpp
   opm/core/simulator/SimulatorReport.hpp
   opm/core/simulator/TwophaseState.hpp
+  opm/core/simulator/WellIndexMap.hpp
   opm/core/simulator/WellState.hpp
   opm/core/simulator/initState.hpp
   opm/core/simulator/initStateEquil.hpp
   opm/core/simulator/initStateEquil_impl.hpp
   opm/core/simulator/initState_impl.hpp
   opm/core/transport/TransportSolverTwophaseInterface.hpp
+  opm/core/transport/reorder/ComponentLevels.hpp
   opm/core/transport/reorder/ReorderSolverInterface.hpp
   opm/core/transport/reorder/TransportSolverCompressibleTwophaseReorder.hpp
   opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp
@@ -454,6 +491,9 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/SimulatorCompressibleTwophase.hpp
   opm/simulators/thresholdPressures.hpp
   opm/simulators/WellSwitchingLogger.hpp
+  opm/simulators/BatchedAllReduce.hpp
+  opm/simulators/Tracer.hpp
+  opm/simulators/vtk/VtkWriter.hpp
   opm/simulators/vtk/writeVtkData.hpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp
   opm/simulators/timestepping/AdaptiveTimeStepping.hpp
@@ -462,4 +502,5 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/simulators/timestepping/TimeStepControlInterface.hpp
   opm/simulators/timestepping/SimulatorTimer.hpp
   opm/simulators/timestepping/SimulatorTimerInterface.hpp
+  opm/simulators/timestepping/StateCheckpoint.hpp
   )
@@ -0,0 +1,392 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BENCHMARK_HEADER_INCLUDED
+#define OPM_BENCHMARK_HEADER_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// A minimal micro-benchmark harness following the interface of Google
+/// Benchmark, so the kernels can be timed without an additional dependency.
+/// The results are printed as a table and can be written as JSON in the
+/// format of Google Benchmark with --benchmark_out=<file>, which allows to
+/// compare runs with its tools.
+///
+/// A benchmark is a function taking a State that runs the timed code in a
+/// `while (state.KeepRunning())` loop. It is registered with OPM_BENCHMARK,
+/// which returns the Benchmark to add arguments to, e.g.
+///
+///     OPM_BENCHMARK(BM_ilu0Apply)->Arg(100000)->Arg(1000000);
+///
+/// and the executable ends with OPM_BENCHMARK_MAIN().
+namespace Opm
+{
+namespace benchmark
+{
+
+    /// The state of a running benchmark.
+    class State
+    {
+    public:
+        State(const std::vector<std::int64_t>& args, const double minTime)
+            : args_(args),
+              minTime_(minTime),
+              iterations_(0),
+              running_(false),
+              itemsProcessed_(0),
+              bytesProcessed_(0)
+        {
+        }
+
+        /// Whether another iteration should be run. The first call starts the timer.
+        bool KeepRunning()
+        {
+            if (!running_) {
+                running_ = true;
+                realTime_ = Clock::duration::zero();
+                cpuTime_ = 0;
+                ResumeTiming();
+                return true;
+            }
+            ++iterations_;
+            if (iterations_ % checkInterval_ != 0) {
+                return true;
+            }
+            PauseTiming();
+            const double elapsed = std::chrono::duration<double>(realTime_).count();
+            if (elapsed >= minTime_ || iterations_ >= maxIterations_) {
+                return false;
+            }
+            // check the time less frequently for fast kernels
+            if (elapsed < 0.1 * minTime_) {
+                checkInterval_ *= 2;
+            }
+            ResumeTiming();
+            return true;
+        }
+
+        /// Stop the timer, e.g. to exclude the setup of the next iteration.
+        void PauseTiming()
+        {
+            realTime_ += Clock::now() - realStart_;
+            cpuTime_ += std::clock() - cpuStart_;
+        }
+
+        /// Restart the timer stopped by PauseTiming().
+        void ResumeTiming()
+        {
+            cpuStart_ = std::clock();
+            realStart_ = Clock::now();
+        }
+
+        /// The argument with the given index.
+        std::int64_t range(const std::size_t idx = 0) const
+        {
+            return args_.at(idx);
+        }
+
+        std::int64_t iterations() const
+        {
+            return iterations_;
+        }
+
+        /// The number of items (e.g. cells) processed in total by all iterations.
+        void SetItemsProcessed(const std::int64_t items)
+        {
+            itemsProcessed_ = items;
+        }
+
+        /// The number of bytes processed in total by all iterations.
+        void SetBytesProcessed(const std::int64_t bytes)
+        {
+            bytesProcessed_ = bytes;
+        }
+
+        /// A label printed with the result, e.g. the problem size.
+        void SetLabel(const std::string& label)
+        {
+            label_ = label;
+        }
+
+        double realTime() const
+        {
+            return std::chrono::duration<double>(realTime_).count();
+        }
+
+        double cpuTime() const
+        {
+            return static_cast<double>(cpuTime_) / CLOCKS_PER_SEC;
+        }
+
+        std::int64_t itemsProcessed() const
+        {
+            return itemsProcessed_;
+        }
+
+        std::int64_t bytesProcessed() const
+        {
+            return bytesProcessed_;
+        }
+
+        const std::string& label() const
+        {
+            return label_;
+        }
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        static const std::int64_t maxIterations_ = 1000000000;
+
+        std::vector<std::int64_t> args_;
+        double minTime_;
+        std::int64_t iterations_;
+        std::int64_t checkInterval_ = 1;
+        bool running_;
+        Clock::time_point realStart_;
+        Clock::duration realTime_;
+        std::clock_t cpuStart_;
+        std::clock_t cpuTime_;
+        std::int64_t itemsProcessed_;
+        std::int64_t bytesProcessed_;
+        std::string label_;
+    };
+
+    typedef void (*Function)(State&);
+
+    /// A registered benchmark and the argument sets it is run with.
+    class Benchmark
+    {
+    public:
+        Benchmark(const std::string& name, Function function)
+            : name_(name),
+              function_(function)
+        {
+        }
+
+        /// Run the benchmark with a single argument.
+        Benchmark* Arg(const std::int64_t arg)
+        {
+            args_.push_back(std::vector<std::int64_t>(1, arg));
+            return this;
+        }
+
+        /// Run the benchmark with several arguments.
+        Benchmark* Args(const std::vector<std::int64_t>& args)
+        {
+            args_.push_back(args);
+            return this;
+        }
+
+        /// The names of the runs, one for each argument set.
+        std::vector<std::string> runNames() const
+        {
+            if (args_.empty()) {
+                return std::vector<std::string>(1, name_);
+            }
+            std::vector<std::string> names;
+            for (const auto& args : args_) {
+                std::ostringstream name;
+                name << name_;
+                for (const auto arg : args) {
+                    name << '/' << arg;
+                }
+                names.push_back(name.str());
+            }
+            return names;
+        }
+
+        const std::vector<std::vector<std::int64_t> >& args() const
+        {
+            return args_;
+        }
+
+        Function function() const
+        {
+            return function_;
+        }
+
+    private:
+        std::string name_;
+        Function function_;
+        std::vector<std::vector<std::int64_t> > args_;
+    };
+
+    inline std::vector<std::unique_ptr<Benchmark> >& registry()
+    {
+        static std::vector<std::unique_ptr<Benchmark> > benchmarks;
+        return benchmarks;
+    }
+
+    inline Benchmark* registerBenchmark(const char* name, Function function)
+    {
+        registry().emplace_back(new Benchmark(name, function));
+        return registry().back().get();
+    }
+
+    /// The number of cells in each direction of a cube with about n cells,
+    /// used to create the synthetic problems of a given size.
+    inline int cubeSide(const std::int64_t n)
+    {
+        return std::max(2, static_cast<int>(std::round(std::cbrt(double(n)))));
+    }
+
+    /// Prevent the compiler from optimising away the computation of a value.
+    template <class T>
+    inline void DoNotOptimize(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /// Run the registered benchmarks selected by the command line options
+    ///   --benchmark_filter=<regex>  only run the benchmarks matching the regex
+    ///   --benchmark_min_time=<s>    minimum time each benchmark is run for
+    ///   --benchmark_out=<file>      write the results as JSON to file
+    inline int runBenchmarks(int argc, char** argv)
+    {
+        std::string filter = ".*";
+        std::string outFile;
+        double minTime = 0.5;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg(argv[i]);
+            const auto value = arg.substr(arg.find('=') + 1);
+            if (arg.find("--benchmark_filter=") == 0) {
+                filter = value;
+            } else if (arg.find("--benchmark_min_time=") == 0) {
+                minTime = std::stod(value);
+            } else if (arg.find("--benchmark_out=") == 0) {
+                outFile = value;
+            } else if (arg.find("--benchmark_") == 0) {
+                std::cerr << "Unknown option " << arg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        const std::regex filterRegex(filter);
+
+        std::ostringstream json;
+        json << "{\n  \"context\": {\n"
+             << "    \"executable\": \"" << argv[0] << "\",\n"
+             << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+             << "    \"library_build_type\": \"release\"\n"
+#else
+             << "    \"library_build_type\": \"debug\"\n"
+#endif
+             << "  },\n  \"benchmarks\": [";
+
+        std::cout << std::left << std::setw(50) << "Benchmark"
+                  << std::right << std::setw(14) << "Time (ms)"
+                  << std::setw(14) << "CPU (ms)"
+                  << std::setw(12) << "Iterations"
+                  << std::setw(16) << "Items/s" << '\n'
+                  << std::string(106, '-') << std::endl;
+
+        bool first = true;
+        for (const auto& benchmark : registry()) {
+            const auto names = benchmark->runNames();
+            for (std::size_t run = 0; run < names.size(); ++run) {
+                if (!std::regex_search(names[run], filterRegex)) {
+                    continue;
+                }
+                const std::vector<std::int64_t> args = benchmark->args().empty()
+                    ? std::vector<std::int64_t>() : benchmark->args()[run];
+                State state(args, minTime);
+                benchmark->function()(state);
+
+                const double iterations = std::max<std::int64_t>(state.iterations(), 1);
+                const double realTime = 1e3 * state.realTime() / iterations;
+                const double cpuTime = 1e3 * state.cpuTime() / iterations;
+                const double itemsPerSecond = state.realTime() > 0.0
+                    ? state.itemsProcessed() / state.realTime() : 0.0;
+                const double bytesPerSecond = state.realTime() > 0.0
+                    ? state.bytesProcessed() / state.realTime() : 0.0;
+
+                std::cout << std::left << std::setw(50) << names[run]
+                          << std::right << std::fixed << std::setprecision(3)
+                          << std::setw(14) << realTime
+                          << std::setw(14) << cpuTime
+                          << std::setw(12) << state.iterations()
+                          << std::setw(16) << std::scientific << std::setprecision(3)
+                          << itemsPerSecond << std::defaultfloat
+                          << ' ' << state.label() << std::endl;
+
+                json << (first ? "\n" : ",\n")
+                     << "    {\n"
+                     << "      \"name\": \"" << names[run] << "\",\n"
+                     << "      \"iterations\": " << state.iterations() << ",\n"
+                     << "      \"real_time\": " << realTime << ",\n"
+                     << "      \"cpu_time\": " << cpuTime << ",\n"
+                     << "      \"time_unit\": \"ms\"";
+                if (state.itemsProcessed() > 0) {
+                    json << ",\n      \"items_per_second\": " << itemsPerSecond;
+                }
+                if (state.bytesProcessed() > 0) {
+                    json << ",\n      \"bytes_per_second\": " << bytesPerSecond;
+                }
+                if (!state.label().empty()) {
+                    json << ",\n      \"label\": \"" << state.label() << "\"";
+                }
+                json << "\n    }";
+                first = false;
+            }
+        }
+        json << "\n  ]\n}\n";
+
+        if (!outFile.empty()) {
+            std::ofstream os(outFile);
+            if (!os) {
+                std::cerr << "Could not open " << outFile << std::endl;
+                return EXIT_FAILURE;
+            }
+            os << json.str();
+        }
+        return EXIT_SUCCESS;
+    }
+
+} // namespace benchmark
+} // namespace Opm
+
+#define OPM_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define OPM_BENCHMARK_CONCAT(a, b) OPM_BENCHMARK_CONCAT_IMPL(a, b)
+
+/// Register a benchmark function.
+#define OPM_BENCHMARK(function) \
+    static ::Opm::benchmark::Benchmark* OPM_BENCHMARK_CONCAT(opmBenchmark, __LINE__) = \
+        ::Opm::benchmark::registerBenchmark(#function, function)
+
+/// Define the main function running the registered benchmarks.
+#define OPM_BENCHMARK_MAIN() \
+    int main(int argc, char** argv) \
+    { \
+        return ::Opm::benchmark::runBenchmarks(argc, argv); \
+    }
+
+#endif // OPM_BENCHMARK_HEADER_INCLUDED
@@ -0,0 +1,84 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BENCHMARK_SYNTHETICSYSTEMS_HEADER_INCLUDED
+#define OPM_BENCHMARK_SYNTHETICSYSTEMS_HEADER_INCLUDED
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+namespace Opm
+{
+namespace benchmark
+{
+
+    /// The Jacobian of a black-oil like system on a Cartesian grid with nx^3
+    /// cells and a seven point stencil. The pressure (index 0) couples like
+    /// a Laplacian, the other unknowns mostly to the cell itself, which
+    /// mimics the structure the CPR preconditioner relies on.
+    template <class Matrix>
+    Matrix blackoilJacobian(const int nx)
+    {
+        typedef typename Matrix::block_type Block;
+        const int numCells = nx*nx*nx;
+        const int stride[3] = { 1, nx, nx*nx };
+
+        Matrix A(numCells, numCells, 7*numCells, Matrix::row_wise);
+        for (auto row = A.createbegin(); row != A.createend(); ++row) {
+            const int c = row.index();
+            const int ijk[3] = { c % nx, (c / nx) % nx, c / (nx*nx) };
+            for (int dim = 2; dim >= 0; --dim) {
+                if (ijk[dim] > 0) {
+                    row.insert(c - stride[dim]);
+                }
+            }
+            row.insert(c);
+            for (int dim = 0; dim < 3; ++dim) {
+                if (ijk[dim] + 1 < nx) {
+                    row.insert(c + stride[dim]);
+                }
+            }
+        }
+
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                Block& block = *col;
+                block = 0.0;
+                if (col.index() == row.index()) {
+                    for (int i = 0; i < Block::rows; ++i) {
+                        for (int j = 0; j < Block::cols; ++j) {
+                            block[i][j] = (i == j) ? 6.0 + 1e-3 : 0.1;
+                        }
+                    }
+                } else {
+                    block[0][0] = -1.0;
+                    for (int i = 1; i < Block::rows; ++i) {
+                        block[i][i] = -0.1;
+                        block[i][0] = -0.05;
+                    }
+                }
+            }
+        }
+        return A;
+    }
+
+} // namespace benchmark
+} // namespace Opm
+
+#endif // OPM_BENCHMARK_SYNTHETICSYSTEMS_HEADER_INCLUDED
@@ -0,0 +1,109 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include "Benchmark.hpp"
+#include "SyntheticSystems.hpp"
+
+#include <opm/autodiff/BlackoilAmg.hpp>
+#include <opm/autodiff/CPRPreconditioner.hpp>
+
+#include <dune/istl/paamg/amg.hh>
+
+#include <memory>
+
+namespace
+{
+    const int blockSize = 3;
+    const int pressureIndex = 0;
+
+    typedef Dune::BCRSMatrix<Dune::FieldMatrix<double, blockSize, blockSize> > Matrix;
+    typedef Dune::BlockVector<Dune::FieldVector<double, blockSize> > Vector;
+    typedef Dune::Amg::SequentialInformation ParallelInformation;
+    typedef Dune::Amg::CoarsenCriterion<
+        Dune::Amg::SymmetricCriterion<Matrix, Dune::Amg::Diagonal<pressureIndex> > > Criterion;
+    typedef Opm::ISTLUtility::BlackoilAmgSelector<Matrix, Vector, Vector, ParallelInformation,
+                                                  Criterion, pressureIndex> Selector;
+    typedef Selector::Operator Operator;
+    typedef Selector::AMG AMG;
+
+    // Create the CPR preconditioner the way ISTLSolver does.
+    std::unique_ptr<AMG> createAmg(Operator& op, const ParallelInformation& info)
+    {
+        std::unique_ptr<AMG> amg;
+        Opm::ISTLUtility::createAMGPreconditionerPointer<Criterion>(op, 1.0, info, amg,
+                                                                    Opm::CPRParameter());
+        return amg;
+    }
+
+    // The full setup including the coarsening of the pressure system.
+    void BM_blackoilAmgSetup(Opm::benchmark::State& state)
+    {
+        const Matrix A = Opm::benchmark::blackoilJacobian<Matrix>(
+            Opm::benchmark::cubeSide(state.range(0)));
+        Operator op(A);
+        ParallelInformation info;
+
+        while (state.KeepRunning()) {
+            std::unique_ptr<AMG> amg = createAmg(op, info);
+            Opm::benchmark::DoNotOptimize(amg);
+        }
+        state.SetItemsProcessed(state.iterations() * A.N());
+    }
+    OPM_BENCHMARK(BM_blackoilAmgSetup)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // The update of the values keeping the aggregates, as with cpr_reuse_setup.
+    void BM_blackoilAmgUpdate(Opm::benchmark::State& state)
+    {
+        const Matrix A = Opm::benchmark::blackoilJacobian<Matrix>(
+            Opm::benchmark::cubeSide(state.range(0)));
+        Operator op(A);
+        ParallelInformation info;
+        std::unique_ptr<AMG> amg = createAmg(op, info);
+
+        while (state.KeepRunning()) {
+            amg->updatePreconditioner(A);
+        }
+        state.SetItemsProcessed(state.iterations() * A.N());
+    }
+    OPM_BENCHMARK(BM_blackoilAmgUpdate)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // One application of the two-stage preconditioner, as in each linear iteration.
+    void BM_blackoilAmgApply(Opm::benchmark::State& state)
+    {
+        const Matrix A = Opm::benchmark::blackoilJacobian<Matrix>(
+            Opm::benchmark::cubeSide(state.range(0)));
+        Operator op(A);
+        ParallelInformation info;
+        std::unique_ptr<AMG> amg = createAmg(op, info);
+        Vector x(A.N()), b(A.N());
+        x = 0.0;
+        b = 1.0;
+        amg->pre(x, b);
+
+        while (state.KeepRunning()) {
+            amg->apply(x, b);
+            Opm::benchmark::DoNotOptimize(x);
+        }
+        amg->post(x);
+        state.SetItemsProcessed(state.iterations() * A.N());
+    }
+    OPM_BENCHMARK(BM_blackoilAmgApply)->Arg(100000)->Arg(1000000)->Arg(10000000);
+} // anonymous namespace
+
+OPM_BENCHMARK_MAIN()
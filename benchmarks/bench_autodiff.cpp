@@ -0,0 +1,189 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include "Benchmark.hpp"
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/AutoDiffProduct.hpp>
+#include <opm/autodiff/fastSparseOperations.hpp>
+
+#include <vector>
+
+namespace
+{
+    typedef Opm::AutoDiffBlock<double> ADB;
+    typedef Eigen::SparseMatrix<double> Sparse;
+
+    // The gradient operator (faces x cells) of a Cartesian grid with nx^3
+    // cells, like the one of HelperOps for the internal faces.
+    Sparse gradient(const int nx)
+    {
+        const int numCells = nx*nx*nx;
+        const int stride[3] = { 1, nx, nx*nx };
+        std::vector<Eigen::Triplet<double> > entries;
+        entries.reserve(6*numCells);
+        int face = 0;
+        for (int c = 0; c < numCells; ++c) {
+            const int ijk[3] = { c % nx, (c / nx) % nx, c / (nx*nx) };
+            for (int dim = 0; dim < 3; ++dim) {
+                if (ijk[dim] + 1 < nx) {
+                    entries.emplace_back(face, c, -1.0);
+                    entries.emplace_back(face, c + stride[dim], 1.0);
+                    ++face;
+                }
+            }
+        }
+        Sparse grad(face, numCells);
+        grad.setFromTriplets(entries.begin(), entries.end());
+        return grad;
+    }
+
+    ADB pressureVariable(const int numCells)
+    {
+        const std::vector<int> blocksizes(1, numCells);
+        ADB::V p = ADB::V::LinSpaced(numCells, 100.0e5, 200.0e5);
+        return ADB::variable(0, std::move(p), blocksizes);
+    }
+
+    // Element-wise arithmetic of variables, as in the evaluation of the
+    // properties of the fully implicit solvers.
+    void BM_adbArithmetic(Opm::benchmark::State& state)
+    {
+        const int numCells = state.range(0);
+        const ADB p = pressureVariable(numCells);
+        const ADB::V ref = ADB::V::Constant(numCells, 150.0e5);
+        const ADB::V c = ADB::V::Constant(numCells, 1.0e-9);
+        const ADB::V one = ADB::V::Ones(numCells);
+
+        while (state.KeepRunning()) {
+            const ADB x = c * (p - ref);
+            const ADB b = one + x + 0.5 * (x * x);
+            const ADB result = p * b / (b + one);
+            Opm::benchmark::DoNotOptimize(result);
+        }
+        state.SetItemsProcessed(state.iterations() * numCells);
+    }
+    OPM_BENCHMARK(BM_adbArithmetic)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // Product of the sparse gradient operator with a variable, as in the
+    // computation of the face potentials.
+    void BM_adbSparseProduct(Opm::benchmark::State& state)
+    {
+        const int nx = Opm::benchmark::cubeSide(state.range(0));
+        const int numCells = nx*nx*nx;
+        const ADB::M grad(gradient(nx));
+        const ADB p = pressureVariable(numCells);
+
+        while (state.KeepRunning()) {
+            const ADB dp = grad * p;
+            Opm::benchmark::DoNotOptimize(dp);
+        }
+        state.SetItemsProcessed(state.iterations() * numCells);
+    }
+    OPM_BENCHMARK(BM_adbSparseProduct)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // The selection of the first cell of each face, an upwind operator
+    // for flow in the positive directions.
+    Sparse upwind(const Sparse& grad)
+    {
+        std::vector<Eigen::Triplet<double> > entries;
+        entries.reserve(grad.rows());
+        for (int c = 0; c < grad.outerSize(); ++c) {
+            for (Sparse::InnerIterator it(grad, c); it; ++it) {
+                if (it.value() < 0.0) {
+                    entries.emplace_back(it.row(), c, 1.0);
+                }
+            }
+        }
+        Sparse select(grad.rows(), grad.cols());
+        select.setFromTriplets(entries.begin(), entries.end());
+        return select;
+    }
+
+    // The inputs of the mass flux trans * mob * dh of the legacy models:
+    // an upwinded mobility depending on pressure and saturation, and a
+    // potential difference depending on pressure, both per face.
+    struct FluxInput
+    {
+        explicit FluxInput(const int nx)
+        {
+            const int numCells = nx*nx*nx;
+            const Sparse grad = gradient(nx);
+            const std::vector<int> blocksizes(2, numCells);
+            const ADB p = ADB::variable(0, ADB::V::LinSpaced(numCells, 100.0e5, 200.0e5), blocksizes);
+            const ADB s = ADB::variable(1, ADB::V::LinSpaced(numCells, 0.1, 0.9), blocksizes);
+            const ADB mu = ADB::V::Constant(numCells, 1.0e-3) + 1.0e-12 * p;
+            mob = upwind(grad) * (s * s / mu);
+            dh = grad * p;
+            trans = ADB::V::Constant(grad.rows(), 1.0e-13);
+        }
+
+        ADB mob = ADB::null();
+        ADB dh = ADB::null();
+        ADB::V trans;
+    };
+
+    // The mass flux with the eager operators of AutoDiffBlock, one
+    // temporary per operator.
+    void BM_adbFluxEager(Opm::benchmark::State& state)
+    {
+        const int nx = Opm::benchmark::cubeSide(state.range(0));
+        const FluxInput in(nx);
+
+        while (state.KeepRunning()) {
+            const ADB flux = in.mob * (in.trans * in.dh);
+            Opm::benchmark::DoNotOptimize(flux);
+        }
+        state.SetItemsProcessed(state.iterations() * nx*nx*nx);
+    }
+    OPM_BENCHMARK(BM_adbFluxEager)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // The same mass flux evaluated as one fused product.
+    void BM_adbFluxFused(Opm::benchmark::State& state)
+    {
+        const int nx = Opm::benchmark::cubeSide(state.range(0));
+        const FluxInput in(nx);
+
+        while (state.KeepRunning()) {
+            const ADB flux = Opm::fusedProduct(in.mob) * in.trans * in.dh;
+            Opm::benchmark::DoNotOptimize(flux);
+        }
+        state.SetItemsProcessed(state.iterations() * nx*nx*nx);
+    }
+    OPM_BENCHMARK(BM_adbFluxFused)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // The sparse matrix-matrix product of the divergence and gradient
+    // operators, the kernel behind the Jacobians of the flux terms.
+    void BM_fastSparseProduct(Opm::benchmark::State& state)
+    {
+        const int nx = Opm::benchmark::cubeSide(state.range(0));
+        const Sparse grad = gradient(nx);
+        const Sparse div = grad.transpose();
+
+        while (state.KeepRunning()) {
+            Sparse laplace;
+            Opm::fastSparseProduct(div, grad, laplace);
+            Opm::benchmark::DoNotOptimize(laplace);
+        }
+        state.SetItemsProcessed(state.iterations() * nx*nx*nx);
+    }
+    OPM_BENCHMARK(BM_fastSparseProduct)->Arg(100000)->Arg(1000000)->Arg(10000000);
+} // anonymous namespace
+
+OPM_BENCHMARK_MAIN()
@@ -0,0 +1,67 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include "Benchmark.hpp"
+#include "SyntheticSystems.hpp"
+
+#include <opm/autodiff/ParallelOverlappingILU0.hpp>
+
+namespace
+{
+    const int blockSize = 3;
+
+    typedef Dune::BCRSMatrix<Dune::FieldMatrix<double, blockSize, blockSize> > Matrix;
+    typedef Dune::BlockVector<Dune::FieldVector<double, blockSize> > Vector;
+    typedef Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> ILU0;
+
+    // The factorization, done each time the Jacobian changes.
+    void BM_ilu0Setup(Opm::benchmark::State& state)
+    {
+        const Matrix A = Opm::benchmark::blackoilJacobian<Matrix>(
+            Opm::benchmark::cubeSide(state.range(0)));
+        ILU0 ilu(A, 0, 1.0);
+
+        while (state.KeepRunning()) {
+            ilu.update(A);
+        }
+        state.SetItemsProcessed(state.iterations() * A.N());
+    }
+    OPM_BENCHMARK(BM_ilu0Setup)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // The forward and backward substitution, done in each linear iteration.
+    void BM_ilu0Apply(Opm::benchmark::State& state)
+    {
+        const Matrix A = Opm::benchmark::blackoilJacobian<Matrix>(
+            Opm::benchmark::cubeSide(state.range(0)));
+        ILU0 ilu(A, 0, 1.0);
+        Vector x(A.N()), b(A.N());
+        b = 1.0;
+
+        while (state.KeepRunning()) {
+            ilu.apply(x, b);
+            Opm::benchmark::DoNotOptimize(x);
+        }
+        state.SetItemsProcessed(state.iterations() * A.N());
+        state.SetBytesProcessed(state.iterations() * A.nonzeroes()
+                                * sizeof(Matrix::block_type));
+    }
+    OPM_BENCHMARK(BM_ilu0Apply)->Arg(100000)->Arg(1000000)->Arg(10000000);
+} // anonymous namespace
+
+OPM_BENCHMARK_MAIN()
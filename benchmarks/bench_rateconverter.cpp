@@ -0,0 +1,143 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include "Benchmark.hpp"
+
+#include <opm/autodiff/RateConverter.hpp>
+#include <opm/autodiff/BlackoilPropsAdFromDeck.hpp>
+
+#include <opm/grid/GridManager.hpp>
+#include <opm/core/simulator/BlackoilState.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Parser/ParseContext.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    typedef std::vector<int> Region;
+    typedef Opm::BlackoilPropsAdFromDeck Props;
+    typedef Opm::RateConverter::SurfaceToReservoirVoidage<Props::FluidSystem, Region> RateConverter;
+
+    const int numRegions = 10;
+
+    // The fluid of tests/fluid.data; the grid is only used to initialise
+    // the fluid system, the state is set up with the benchmarked size.
+    const char* const deckString =
+        "RUNSPEC\n"
+        "OIL\nWATER\nGAS\nMETRIC\n"
+        "DIMENS\n 1 1 1 /\n"
+        "TABDIMS\n/\n"
+        "GRID\n"
+        "DXV\n 1 /\nDYV\n 1 /\nDZV\n 0.1 /\nDEPTHZ\n 4*0 /\n"
+        "PROPS\n"
+        "PVTW\n 1 1 0 1000 0 /\n"
+        "PVCDO\n 1 1 0 1000 0 /\n"
+        "PVDG\n 1 1 1\n 800 0.99999999 1 /\n"
+        "SWOF\n 0.12 0 1 0\n 1 1 0 0 /\n"
+        "SGOF\n 0 0 1.0 0\n 0.88 1.0 0 0 /\n"
+        "DENSITY\n 800 1000 1 /\n"
+        "SOLUTION\n"
+        "SCHEDULE\n";
+
+    // The fluid properties, which initialise the fluid system used by the
+    // rate converter. Created once, since parsing is not benchmarked.
+    const Props& props()
+    {
+        static const Opm::Deck deck = Opm::Parser().parseString(deckString, Opm::ParseContext());
+        static const Opm::EclipseState eclState(deck, Opm::ParseContext());
+        static const Opm::GridManager grid(eclState.getInputGrid());
+        static const Props props(deck, eclState, *grid.c_grid(), false);
+        return props;
+    }
+
+    struct Setup
+    {
+        explicit Setup(const int numCells)
+            : region(numCells),
+              state(numCells, 0, 3)
+        {
+            for (int c = 0; c < numCells; ++c) {
+                region[c] = (c * numRegions) / numCells;
+                state.pressure()[c] = 100.0e5 + 100.0 * c;
+            }
+            converter.reset(new RateConverter(props().phaseUsage(), region));
+            converter->defineState(state);
+        }
+
+        Region region;
+        Opm::BlackoilState state;
+        std::unique_ptr<RateConverter> converter;
+    };
+
+    // The averaging of the reservoir state over the regions, done once per
+    // time step.
+    void BM_rateConverterDefineState(Opm::benchmark::State& state)
+    {
+        Setup setup(state.range(0));
+
+        while (state.KeepRunning()) {
+            setup.converter->defineState(setup.state);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    OPM_BENCHMARK(BM_rateConverterDefineState)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+    // The conversion coefficients of the wells, computed for each well in
+    // each Newton iteration.
+    void BM_rateConverterCalcCoeff(Opm::benchmark::State& state)
+    {
+        const int numWells = state.range(0);
+        Setup setup(100000);
+        std::vector<double> coeff(3, 0.0);
+
+        while (state.KeepRunning()) {
+            for (int w = 0; w < numWells; ++w) {
+                setup.converter->calcCoeff(w % numRegions, 0, coeff);
+            }
+            Opm::benchmark::DoNotOptimize(coeff);
+        }
+        state.SetItemsProcessed(state.iterations() * numWells);
+    }
+    OPM_BENCHMARK(BM_rateConverterCalcCoeff)->Arg(1000)->Arg(100000);
+
+    // The conversion of the surface rates of the wells to reservoir voidage rates.
+    void BM_rateConverterVoidageRates(Opm::benchmark::State& state)
+    {
+        const int numWells = state.range(0);
+        Setup setup(100000);
+        const std::vector<double> surfaceRates = { 1.0e-3, 2.0e-3, 5.0e-1 };
+        std::vector<double> voidageRates(3, 0.0);
+
+        while (state.KeepRunning()) {
+            for (int w = 0; w < numWells; ++w) {
+                setup.converter->calcReservoirVoidageRates(w % numRegions, 0,
+                                                           surfaceRates, voidageRates);
+            }
+            Opm::benchmark::DoNotOptimize(voidageRates);
+        }
+        state.SetItemsProcessed(state.iterations() * numWells);
+    }
+    OPM_BENCHMARK(BM_rateConverterVoidageRates)->Arg(1000)->Arg(100000);
+} // anonymous namespace
+
+OPM_BENCHMARK_MAIN()
@@ -0,0 +1,67 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include "Benchmark.hpp"
+
+#include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/grid/UnstructuredGrid.h>
+#include <opm/grid/cart_grid.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // A flux field flowing mostly along the diagonal of the grid, with some
+    // faces reversed so that the upwind graph has loops of several cells.
+    std::vector<double> createFlux(const UnstructuredGrid& grid, const int reversedEvery)
+    {
+        std::vector<double> flux(grid.number_of_faces, 1.0);
+        if (reversedEvery > 0) {
+            for (int f = 0; f < grid.number_of_faces; f += reversedEvery) {
+                flux[f] = -1.0;
+            }
+        }
+        return flux;
+    }
+
+    // The causal sequence and strongly connected components of the upwind
+    // graph, computed by the reordering transport solvers for each time step.
+    void BM_computeSequence(Opm::benchmark::State& state)
+    {
+        const int nx = Opm::benchmark::cubeSide(state.range(0));
+        std::shared_ptr<UnstructuredGrid> grid(create_grid_cart3d(nx, nx, nx), destroy_grid);
+        const std::vector<double> flux = createFlux(*grid, state.range(1));
+        std::vector<int> sequence(grid->number_of_cells);
+        std::vector<int> components(grid->number_of_cells + 1);
+        int ncomponents = 0;
+
+        while (state.KeepRunning()) {
+            compute_sequence(grid.get(), flux.data(), sequence.data(),
+                             components.data(), &ncomponents);
+            Opm::benchmark::DoNotOptimize(ncomponents);
+        }
+        state.SetItemsProcessed(state.iterations() * grid->number_of_cells);
+    }
+    OPM_BENCHMARK(BM_computeSequence)
+        ->Args({100000, 0})->Args({1000000, 0})->Args({10000000, 0})
+        ->Args({1000000, 7});
+} // anonymous namespace
+
+OPM_BENCHMARK_MAIN()
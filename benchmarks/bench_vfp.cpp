@@ -0,0 +1,120 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include "Benchmark.hpp"
+
+#include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
+#include <opm/autodiff/VFPProdProperties.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // A table with n values on each axis between 0 and 1, filled with a
+    // plane as in the tests.
+    std::unique_ptr<Opm::VFPProdTable> createTable(const int n)
+    {
+        std::vector<double> axis(n);
+        for (int i = 0; i < n; ++i) {
+            axis[i] = i / static_cast<double>(n - 1);
+        }
+        const Opm::VFPProdTable::extents size{{ n, n, n, n, n }};
+        Opm::VFPProdTable::array_type data(size);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                for (int k = 0; k < n; ++k) {
+                    for (int l = 0; l < n; ++l) {
+                        for (int m = 0; m < n; ++m) {
+                            data[i][j][k][l][m] = axis[i] + 2*axis[j] + 3*axis[k]
+                                + 4*axis[l] + 5*axis[m];
+                        }
+                    }
+                }
+            }
+        }
+        return std::unique_ptr<Opm::VFPProdTable>(
+            new Opm::VFPProdTable(1, 1000.0,
+                                  Opm::VFPProdTable::FLO_OIL,
+                                  Opm::VFPProdTable::WFR_WOR,
+                                  Opm::VFPProdTable::GFR_GOR,
+                                  Opm::VFPProdTable::ALQ_UNDEF,
+                                  axis, axis, axis, axis, axis, data));
+    }
+
+    // The rates and pressures of numWells wells spread over the table.
+    struct WellInputs
+    {
+        explicit WellInputs(const int numWells)
+            : table_ids(numWells, 1),
+              aqua(numWells), liquid(numWells), vapour(numWells),
+              thp(numWells), alq(numWells, 0.0)
+        {
+            for (int w = 0; w < numWells; ++w) {
+                const double s = (w + 0.5) / numWells;
+                liquid[w] = -s;
+                aqua[w] = -0.5 * s * s;
+                vapour[w] = -0.75 * s;
+                thp[w] = 1.0 - s;
+            }
+        }
+
+        std::vector<int> table_ids;
+        std::vector<double> aqua, liquid, vapour, thp, alq;
+    };
+
+    // One evaluation per well, as done by the well models for each well.
+    void BM_vfpBhp(Opm::benchmark::State& state)
+    {
+        const int numWells = state.range(0);
+        const auto table = createTable(state.range(1));
+        const Opm::VFPProdProperties properties(table.get());
+        const WellInputs in(numWells);
+
+        while (state.KeepRunning()) {
+            double sum = 0.0;
+            for (int w = 0; w < numWells; ++w) {
+                sum += properties.bhp(1, in.aqua[w], in.liquid[w], in.vapour[w],
+                                      in.thp[w], in.alq[w]);
+            }
+            Opm::benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * numWells);
+    }
+    OPM_BENCHMARK(BM_vfpBhp)->Args({1000, 10})->Args({1000, 20})->Args({100000, 10});
+
+    // The batched evaluation of all wells sharing a table.
+    void BM_vfpBhpBatched(Opm::benchmark::State& state)
+    {
+        const int numWells = state.range(0);
+        const auto table = createTable(state.range(1));
+        const Opm::VFPProdProperties properties(table.get());
+        const WellInputs in(numWells);
+
+        while (state.KeepRunning()) {
+            const auto bhp = properties.bhp(in.table_ids, in.aqua, in.liquid, in.vapour,
+                                            in.thp, in.alq);
+            Opm::benchmark::DoNotOptimize(bhp);
+        }
+        state.SetItemsProcessed(state.iterations() * numWells);
+    }
+    OPM_BENCHMARK(BM_vfpBhpBatched)->Args({1000, 10})->Args({1000, 20})->Args({100000, 10});
+} // anonymous namespace
+
+OPM_BENCHMARK_MAIN()
@@ -0,0 +1,287 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Replays a snapshot of a linear system written by flow with the
+// parameter linear_system_snapshot_dir through ISTLSolver, e.g.
+//
+//   replay_linear_system snapshot=system-0003-step2.1-iter1.linsys \
+//       solver_approach=cpr cpr_use_amg=true repeat=5 threads=4
+//
+// All parameters of the linear solver are accepted.
+
+#include "config.h"
+
+#include <opm/autodiff/ISTLSolver.hpp>
+#include <opm/autodiff/LinearSystemSnapshot.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/utility/parameters/ParameterGroup.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/version.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
+namespace
+{
+    void warnIfUnusedParams(const Opm::ParameterGroup& param)
+    {
+        if (param.anyUnused()) {
+            std::cout << "--------------------   Warning: unused parameters:   --------------------\n";
+            param.displayUsage();
+            std::cout << "-------------------------------------------------------------------------" << std::endl;
+        }
+    }
+
+    /// The wells of a snapshot, eliminated from the system as in
+    /// BlackoilWellModel: Ax = Ax - C^T D^-1 B x for each well. The blocks
+    /// B and C are used in place from the mapped snapshot.
+    class SnapshotWells
+    {
+    public:
+        typedef Opm::LinearSystemSnapshot::Record Record;
+
+        explicit SnapshotWells(const Opm::LinearSystemSnapshot& snapshot)
+        {
+            const std::string prefix = "well/";
+            for (const Record& r : snapshot.records()) {
+                if (r.name.compare(0, prefix.size(), prefix) != 0
+                    || r.name.size() < 2 || r.name.compare(r.name.size() - 2, 2, "/B") != 0) {
+                    continue;
+                }
+                const std::string well = r.name.substr(0, r.name.size() - 1);
+                Well w;
+                w.B = &r;
+                w.C = &snapshot.record(well + "C");
+                if (snapshot.has(well + "invD")) {
+                    w.invD = dense(snapshot.record(well + "invD"));
+                } else {
+                    // multisegment wells keep D itself
+                    w.invD = dense(snapshot.record(well + "D"));
+                    w.invD.invert();
+                }
+                wells_.push_back(w);
+            }
+        }
+
+        std::size_t size() const
+        {
+            return wells_.size();
+        }
+
+        template <class Vector>
+        void apply(const Vector& x, Vector& Ax) const
+        {
+            for (const Well& w : wells_) {
+                const Record& B = *w.B;
+                const Record& C = *w.C;
+
+                // Bx = B x
+                Dune::DynamicVector<double> Bx(B.rows * B.block_rows, 0.0);
+                const std::size_t B_size = B.block_rows * B.block_cols;
+                for (std::size_t row = 0; row < B.rows; ++row) {
+                    for (std::uint64_t k = B.row_start[row]; k < B.row_start[row + 1]; ++k) {
+                        const double* block = B.values + k * B_size;
+                        for (int i = 0; i < B.block_rows; ++i) {
+                            for (int j = 0; j < B.block_cols; ++j) {
+                                Bx[row * B.block_rows + i] += block[i * B.block_cols + j] * x[B.col[k]][j];
+                            }
+                        }
+                    }
+                }
+
+                // invDBx = D^-1 B x
+                Dune::DynamicVector<double> invDBx(Bx.size());
+                w.invD.mv(Bx, invDBx);
+
+                // Ax = Ax - C^T invDBx
+                const std::size_t C_size = C.block_rows * C.block_cols;
+                for (std::size_t row = 0; row < C.rows; ++row) {
+                    for (std::uint64_t k = C.row_start[row]; k < C.row_start[row + 1]; ++k) {
+                        const double* block = C.values + k * C_size;
+                        for (int i = 0; i < C.block_rows; ++i) {
+                            for (int j = 0; j < C.block_cols; ++j) {
+                                Ax[C.col[k]][j] -= block[i * C.block_cols + j] * invDBx[row * C.block_rows + i];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Well
+        {
+            const Record* B;
+            const Record* C;
+            Dune::DynamicMatrix<double> invD;
+        };
+
+        static Dune::DynamicMatrix<double> dense(const Record& r)
+        {
+            Dune::DynamicMatrix<double> D(r.rows * r.block_rows, r.cols * r.block_cols, 0.0);
+            const std::size_t block_size = r.block_rows * r.block_cols;
+            for (std::size_t row = 0; row < r.rows; ++row) {
+                for (std::uint64_t k = r.row_start[row]; k < r.row_start[row + 1]; ++k) {
+                    for (int i = 0; i < r.block_rows; ++i) {
+                        for (int j = 0; j < r.block_cols; ++j) {
+                            D[row * r.block_rows + i][r.col[k] * r.block_cols + j] = r.values[k * block_size + i * r.block_cols + j];
+                        }
+                    }
+                }
+            }
+            return D;
+        }
+
+        std::vector<Well> wells_;
+    };
+
+
+
+    /// The operator of the reservoir matrix with the wells eliminated, as
+    /// the WellModelMatrixAdapter of BlackoilModelEbos.
+    template <class M, class X>
+    class SnapshotOperator : public Dune::AssembledLinearOperator<M, X, X>
+    {
+    public:
+        typedef M matrix_type;
+        typedef X domain_type;
+        typedef X range_type;
+        typedef typename X::field_type field_type;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+        Dune::SolverCategory::Category category() const override
+        {
+            return Dune::SolverCategory::sequential;
+        }
+#else
+        enum { category = Dune::SolverCategory::sequential };
+#endif
+
+        SnapshotOperator(const M& A, const M& A_for_precond, const SnapshotWells& wells)
+            : A_(A), A_for_precond_(A_for_precond), wells_(wells)
+        {
+        }
+
+        virtual void apply(const X& x, X& y) const
+        {
+            A_.mv(x, y);
+            wells_.apply(x, y);
+        }
+
+        virtual void applyscaleadd(field_type alpha, const X& x, X& y) const
+        {
+            X Ax(y.size());
+            apply(x, Ax);
+            y.axpy(alpha, Ax);
+        }
+
+        virtual const matrix_type& getmat() const { return A_for_precond_; }
+
+    private:
+        const M& A_;
+        const M& A_for_precond_;
+        const SnapshotWells& wells_;
+    };
+
+
+
+    template <int n>
+    void replay(const Opm::LinearSystemSnapshot& snapshot, const Opm::ParameterGroup& param)
+    {
+        typedef Dune::FieldMatrix<double, n, n> MatrixBlock;
+        typedef Dune::FieldVector<double, n> VectorBlock;
+        typedef Dune::BCRSMatrix<MatrixBlock> Matrix;
+        typedef Dune::BlockVector<VectorBlock> Vector;
+
+        const Matrix A = snapshot.matrix<Matrix>("matrix");
+        const Matrix A_for_precond = snapshot.has("preconditioner_matrix")
+            ? snapshot.matrix<Matrix>("preconditioner_matrix") : Matrix();
+        const Vector residual = snapshot.vector<Vector>("residual");
+        const SnapshotWells wells(snapshot);
+        std::cout << "System: " << A.N() << " rows of " << n << "x" << n << " blocks, "
+                  << A.nonzeroes() << " nonzero blocks, " << wells.size() << " wells" << std::endl;
+
+        typedef SnapshotOperator<Matrix, Vector> Operator;
+        Operator opA(A, snapshot.has("preconditioner_matrix") ? A_for_precond : A, wells);
+        const Opm::ISTLSolver<MatrixBlock, VectorBlock> solver(param);
+
+        const int repeat = param.getDefault("repeat", 1);
+        warnIfUnusedParams(param);
+        for (int i = 0; i < repeat; ++i) {
+            Vector x(A.N());
+            x = 0.0;
+            Vector b(residual);
+            Dune::Timer timer;
+            solver.solve(opA, x, b);
+            const double time = timer.elapsed();
+
+            // The true residual of the solution.
+            Vector r(residual);
+            opA.applyscaleadd(-1.0, x, r);
+            std::cout << "Solve " << i << ": " << solver.iterations() << " iterations, "
+                      << time << " seconds, residual reduction "
+                      << r.two_norm() / residual.two_norm() << std::endl;
+        }
+    }
+} // anonymous namespace
+
+
+
+// ----------------- Main program -----------------
+int
+main(int argc, char** argv)
+try
+{
+    Opm::ParameterGroup param(argc, argv);
+
+#if HAVE_OPENMP
+    const int threads = param.getDefault("threads", omp_get_max_threads());
+    omp_set_num_threads(threads);
+    std::cout << "Using " << threads << " threads" << std::endl;
+#endif // HAVE_OPENMP
+
+    const Opm::LinearSystemSnapshot snapshot(param.get<std::string>("snapshot"));
+    const int block_size = snapshot.record("matrix").block_rows;
+    switch (block_size) {
+    case 1: replay<1>(snapshot, param); break;
+    case 2: replay<2>(snapshot, param); break;
+    case 3: replay<3>(snapshot, param); break;
+    case 4: replay<4>(snapshot, param); break;
+    case 5: replay<5>(snapshot, param); break;
+    default:
+        OPM_THROW(std::runtime_error, "Unsupported block size " << block_size);
+    }
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e) {
+    std::cerr << "Program threw an exception: " << e.what() << "\n";
+    throw;
+}
@@ -12,6 +12,8 @@ set (opm-simulators_CONFIG_VAR
   DUNE_ISTL_VERSION_MINOR
   DUNE_ISTL_VERSION_REVISION
   HAVE_SUITESPARSE_UMFPACK
+  OPM_ENABLE_TRACING
+  HAVE_ZLIB
   )
 
 # dependencies
@@ -44,10 +46,16 @@ set (opm-simulators_DEPS
   "ewoms REQUIRED"
   # Eigen
   "Eigen3 3.2.0"
+  # compression of the vtk output
+  "ZLIB"
   )
 
 find_package_deps(opm-simulators)
 
+if(ZLIB_FOUND)
+  set(HAVE_ZLIB 1)
+endif()
+
 if(NOT HAVE_ECL_INPUT OR NOT HAVE_ECL_OUTPUT)
   message(FATAL_ERROR "Eclipse input/output support required in opm-common")
 endif()
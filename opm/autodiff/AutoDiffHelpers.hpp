@@ -22,6 +22,7 @@
 #define OPM_AUTODIFFHELPERS_HEADER_INCLUDED
 
 #include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/ConnectionOperator.hpp>
 #include <opm/autodiff/GridHelpers.hpp>
 #include <opm/autodiff/GeoProps.hpp>
 #include <opm/grid/UnstructuredGrid.h>
@@ -31,7 +32,9 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/NNC.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <array>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 namespace Opm
@@ -39,7 +42,7 @@ namespace Opm
 
 // -------------------- class HelperOps --------------------
 
-/// Contains vectors and sparse matrices that represent subsets or
+/// Contains vectors and operators that represent subsets or
 /// operations on (AD or regular) vectors of data.
 struct HelperOps
 {
@@ -50,19 +53,28 @@ struct HelperOps
     typedef Eigen::Array<int, Eigen::Dynamic, 1> IFaces;
     IFaces internal_faces;
 
+    /// The cells of each internal face and non-neighboring connection.
+    std::shared_ptr<const ConnectionGraph> connections;
+    /// The cells of each face, -1 outside of the boundary faces, and of
+    /// each non-neighboring connection.
+    std::shared_ptr<const ConnectionGraph> full_connections;
+
+    // The operators loop over the connections instead of being stored as
+    // sparse matrices; use sparse() to get the matrix of an operator.
+
     /// Extract for each internal face the difference of its adjacent cells' values (first - second).
-    M ngrad;
+    ConnectionOperator ngrad;
     /// Extract for each face the difference of its adjacent cells' values (second - first).
-    M grad;
+    ConnectionOperator grad;
     /// Extract for each face the average of its adjacent cells' values.
-    M caver;
+    ConnectionOperator caver;
     /// Extract for each cell the sum of its adjacent interior faces' (signed) values.
-    M div;
+    ConnectionOperator div;
     /// Extract for each face the difference of its adjacent cells' values (first - second).
     /// For boundary faces, one of the entries per row (corresponding to the outside) is zero.
-    M fullngrad;
+    ConnectionOperator fullngrad;
     /// Extract for each cell the sum of all its adjacent faces' (signed) values.
-    M fulldiv;
+    ConnectionOperator fulldiv;
 
     /// Non-neighboring connections
     typedef Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor> TwoColInt;
@@ -113,55 +125,39 @@ struct HelperOps
         }
 
 
-        // std::cout << "nbi = \n" << nbi << std::endl;
-        // Create matrices.
-        ngrad.resize(num_connections, nc);
-        caver.resize(num_connections, nc);
-        typedef Eigen::Triplet<double> Tri;
-        std::vector<Tri> ngrad_tri;
-        std::vector<Tri> caver_tri;
-        ngrad_tri.reserve(2*num_connections);
-        caver_tri.reserve(2*num_connections);
+        // Create the operators.
+        std::vector<std::array<int, 2>> conn_cells;
+        conn_cells.reserve(num_connections);
         for (int i = 0; i < num_internal; ++i) {
-            ngrad_tri.emplace_back(i, nbi(i,0), 1.0);
-            ngrad_tri.emplace_back(i, nbi(i,1), -1.0);
-            caver_tri.emplace_back(i, nbi(i,0), 0.5);
-            caver_tri.emplace_back(i, nbi(i,1), 0.5);
+            conn_cells.push_back({{ nbi(i,0), nbi(i,1) }});
         }
         // add contribution from NNC
         if (has_nnc) {
             for (int i = 0; i < numNNC; ++i) {
-                ngrad_tri.emplace_back(i+num_internal, nnc_cells(i,0), 1.0);
-                ngrad_tri.emplace_back(i+num_internal, nnc_cells(i,1), -1.0);
-                caver_tri.emplace_back(i+num_internal, nnc_cells(i,0), 0.5);
-                caver_tri.emplace_back(i+num_internal, nnc_cells(i,1), 0.5);
+                conn_cells.push_back({{ nnc_cells(i,0), nnc_cells(i,1) }});
             }
         }
-        ngrad.setFromTriplets(ngrad_tri.begin(), ngrad_tri.end());
-        caver.setFromTriplets(caver_tri.begin(), caver_tri.end());
-        grad = -ngrad;
+        connections = std::make_shared<const ConnectionGraph>(nc, std::move(conn_cells));
+        ngrad = ConnectionOperator(connections, 1.0, -1.0);
+        grad = ConnectionOperator(connections, -1.0, 1.0);
+        caver = ConnectionOperator(connections, 0.5, 0.5);
         div = ngrad.transpose();
 
-        std::vector<Tri> fullngrad_tri;
-        fullngrad_tri.reserve(2*(nf+numNNC));
+        std::vector<std::array<int, 2>> full_conn_cells;
+        full_conn_cells.reserve(nf + numNNC);
         typename ADFaceCellTraits<Grid>::Type nb = faceCellsToEigen(grid);
         for (int i = 0; i < nf; ++i) {
-            if (nb(i,0) >= 0) {
-                fullngrad_tri.emplace_back(i, nb(i,0), 1.0);
-            }
-            if (nb(i,1) >= 0) {
-                fullngrad_tri.emplace_back(i, nb(i,1), -1.0);
-            }
+            full_conn_cells.push_back({{ nb(i,0) >= 0 ? int(nb(i,0)) : -1,
+                                         nb(i,1) >= 0 ? int(nb(i,1)) : -1 }});
         }
         // add contribution from NNC
         if (has_nnc) {
             for (int i = 0; i < numNNC; ++i) {
-                fullngrad_tri.emplace_back(i+nf, nnc_cells(i,0), 1.0);
-                fullngrad_tri.emplace_back(i+nf, nnc_cells(i,1), -1.0);
+                full_conn_cells.push_back({{ nnc_cells(i,0), nnc_cells(i,1) }});
             }
         }
-        fullngrad.resize(nf+numNNC, nc);
-        fullngrad.setFromTriplets(fullngrad_tri.begin(), fullngrad_tri.end());
+        full_connections = std::make_shared<const ConnectionGraph>(nc, std::move(full_conn_cells));
+        fullngrad = ConnectionOperator(full_connections, 1.0, -1.0);
         fulldiv = fullngrad.transpose();
 
         if (has_nnc) {
@@ -183,46 +179,11 @@ struct HelperOps
         typedef AutoDiffBlock<Scalar> ADB;
 
         template<class Grid>
-        UpwindSelector(const Grid& g,
+        UpwindSelector(const Grid& /* g */,
                        const HelperOps&        h,
                        const typename ADB::V&  ifaceflux)
+            : select_(h.connections, ifaceflux)
         {
-            using namespace AutoDiffGrid;
-            typedef HelperOps::IFaces::Index IFIndex;
-            const IFIndex nif = h.internal_faces.size();
-            typename ADFaceCellTraits<Grid>::Type
-                face_cells = faceCellsToEigen(g);
-
-            // num connections may possibly include NNCs
-            int num_nnc = h.nnc_trans.size();
-            int num_connections = nif + num_nnc;
-            assert(num_connections == ifaceflux.size());
-
-            // Define selector structure.
-            typedef typename Eigen::Triplet<Scalar> Triplet;
-            std::vector<Triplet> s;  s.reserve(num_connections);
-            for (IFIndex iface = 0; iface < nif; ++iface) {
-                const int f  = h.internal_faces[iface];
-                const int c1 = face_cells(f,0);
-                const int c2 = face_cells(f,1);
-
-                assert ((c1 >= 0) && (c2 >= 0));
-
-                // Select upwind cell.
-                const int c = (ifaceflux[iface] >= 0) ? c1 : c2;
-
-                s.push_back(Triplet(iface, c, Scalar(1)));
-            }
-            if (num_nnc > 0) {
-                for (int i = 0; i < num_nnc; ++i) {
-                    const int c = (ifaceflux[i+nif] >= 0) ? h.nnc_cells(i,0) : h.nnc_cells(i,1);
-                    s.push_back(Triplet(i+nif,c,Scalar(1)));
-                }
-            }
-
-            // Assemble explicit selector operator.
-            select_.resize(num_connections, numCells(g));
-            select_.setFromTriplets(s.begin(), s.end());
         }
 
         /// Apply selector to multiple per-cell quantities.
@@ -251,11 +212,12 @@ struct HelperOps
         /// Apply selector to single per-cell constant quantity.
         typename ADB::V select(const typename ADB::V& xc) const
         {
-            return (select_*xc.matrix()).array();
+            return select_*xc;
         }
 
     private:
-        Eigen::SparseMatrix<double> select_;
+        // Selects the upwind cell of each connection.
+        ConnectionSelector select_;
     };
 
 
@@ -29,6 +29,8 @@
 
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/autodiff/fastSparseOperations.hpp>
+#include <algorithm>
+#include <utility>
 #include <vector>
 
 
@@ -114,6 +116,21 @@ namespace Opm
 
 
 
+        /**
+         * Creates a sparse matrix from an Eigen sparse matrix, leaving s empty
+         */
+        explicit AutoDiffMatrix(Eigen::SparseMatrix<double>&& s)
+            : type_(Sparse),
+              rows_(s.rows()),
+              cols_(s.cols()),
+              diag_(),
+              sparse_()
+        {
+            sparse_.swap(s);
+        }
+
+
+
         AutoDiffMatrix(const AutoDiffMatrix& other) = default;
         AutoDiffMatrix& operator=(const AutoDiffMatrix& other) = default;
 
@@ -405,6 +422,105 @@ namespace Opm
 
 
 
+        /**
+         * Returns the sum of the matrices with their rows scaled,
+         *     sum_i diag(scale[i]) * term[i],
+         * where scale[i] has one entry per row. The sum is formed in one
+         * pass with a single allocation for the result, which is diagonal
+         * if all the terms are identity or diagonal matrices.
+         */
+        static AutoDiffMatrix rowScaledSum(const std::vector<const double*>& scale,
+                                           const std::vector<const AutoDiffMatrix*>& term)
+        {
+            assert(!term.empty());
+            assert(scale.size() == term.size());
+            const int num_terms = term.size();
+            const int rows = term[0]->rows_;
+            const int cols = term[0]->cols_;
+            int num_sparse = 0;
+            int max_nnz = 0;
+            bool has_diagonal = false;
+            for (int t = 0; t < num_terms; ++t) {
+                assert(term[t]->rows_ == rows);
+                assert(term[t]->cols_ == cols);
+                if (term[t]->type_ == Sparse) {
+                    ++num_sparse;
+                    max_nnz += term[t]->sparse_.nonZeros();
+                } else if (term[t]->type_ != Zero) {
+                    has_diagonal = true;
+                }
+            }
+            if (num_sparse == 0 && !has_diagonal) {
+                return AutoDiffMatrix(rows, cols);
+            }
+
+            DiagRep diag;
+            if (has_diagonal) {
+                diag.assign(rows, 0.0);
+                for (int t = 0; t < num_terms; ++t) {
+                    const double* s = scale[t];
+                    if (term[t]->type_ == Identity) {
+                        for (int r = 0; r < rows; ++r) {
+                            diag[r] += s[r];
+                        }
+                    } else if (term[t]->type_ == Diagonal) {
+                        const DiagRep& d = term[t]->diag_;
+                        for (int r = 0; r < rows; ++r) {
+                            diag[r] += s[r] * d[r];
+                        }
+                    }
+                }
+                if (num_sparse == 0) {
+                    return AutoDiffMatrix(Diagonal, rows, cols, std::move(diag));
+                }
+                max_nnz += rows;
+            }
+
+            // Merge the columns of the sparse terms and the diagonal,
+            // writing directly into the storage of the result.
+            SparseRep result(rows, cols);
+            result.resizeNonZeros(max_nnz);
+            int* outer = result.outerIndexPtr();
+            int* inner = result.innerIndexPtr();
+            double* value = result.valuePtr();
+            std::vector<std::pair<int, double>> column;
+            int nnz = 0;
+            outer[0] = 0;
+            for (int k = 0; k < cols; ++k) {
+                column.clear();
+                for (int t = 0; t < num_terms; ++t) {
+                    if (term[t]->type_ == Sparse) {
+                        const double* s = scale[t];
+                        for (SparseRep::InnerIterator it(term[t]->sparse_, k); it; ++it) {
+                            column.emplace_back(it.index(), s[it.index()] * it.value());
+                        }
+                    }
+                }
+                if (has_diagonal) {
+                    column.emplace_back(k, diag[k]);
+                }
+                std::sort(column.begin(), column.end(),
+                          [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                              return a.first < b.first;
+                          });
+                const int start = nnz;
+                for (const auto& entry : column) {
+                    if (nnz > start && inner[nnz - 1] == entry.first) {
+                        value[nnz - 1] += entry.second;
+                    } else {
+                        inner[nnz] = entry.first;
+                        value[nnz] = entry.second;
+                        ++nnz;
+                    }
+                }
+                outer[k + 1] = nnz;
+            }
+            result.resizeNonZeros(nnz);
+            return AutoDiffMatrix(std::move(result));
+        }
+
+
+
 
 
         // Add identity to identity
@@ -667,8 +783,8 @@ namespace Opm
             : type_(type),
               rows_(rows_arg),
               cols_(cols_arg),
-              diag_(diag),
-              sparse_(sparse)
+              diag_(std::move(diag)),
+              sparse_(std::move(sparse))
         {
         }
 
@@ -0,0 +1,203 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_AUTODIFFPRODUCT_HEADER_INCLUDED
+#define OPM_AUTODIFFPRODUCT_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// An elementwise product and quotient of AutoDiffBlocks and value
+    /// arrays, such as trans * mob * dh, that is evaluated lazily.
+    ///
+    /// The operators of AutoDiffBlock evaluate eagerly, so a chain of n
+    /// factors creates n - 1 temporaries, each with its own value array
+    /// and jacobians. Here operator* and operator/ only record the
+    /// factors. When the expression is converted to an AutoDiffBlock, the
+    /// value and the coefficients of the derivatives are computed in one
+    /// pass over the elements, and each jacobian block is formed as one
+    /// row-scaled sum of the jacobians of the factors.
+    ///
+    /// The factors are referenced, not copied, so the expression must be
+    /// converted within the statement that builds it:
+    ///
+    ///     const ADB flux = fusedProduct(mob_up) * trans * dh;
+    template <typename Scalar>
+    class AutoDiffProduct
+    {
+    public:
+        typedef AutoDiffBlock<Scalar> ADB;
+        typedef typename ADB::V V;
+        typedef typename ADB::M M;
+
+        explicit AutoDiffProduct(const ADB& x)
+        {
+            append(x.value(), &x, false);
+        }
+
+        explicit AutoDiffProduct(const V& x)
+        {
+            append(x, nullptr, false);
+        }
+
+        AutoDiffProduct operator*(const ADB& x) &&
+        {
+            append(x.value(), &x, false);
+            return std::move(*this);
+        }
+
+        AutoDiffProduct operator*(const V& x) &&
+        {
+            append(x, nullptr, false);
+            return std::move(*this);
+        }
+
+        AutoDiffProduct operator/(const ADB& x) &&
+        {
+            append(x.value(), &x, true);
+            return std::move(*this);
+        }
+
+        AutoDiffProduct operator/(const V& x) &&
+        {
+            append(x, nullptr, true);
+            return std::move(*this);
+        }
+
+        /// Evaluate the expression.
+        ADB evaluate() const
+        {
+            const int num_factors = factors_.size();
+            const int n = size_;
+
+            // The factors with derivatives.
+            std::vector<int> active;
+            for (int f = 0; f < num_factors; ++f) {
+                if (factors_[f].adb != nullptr && factors_[f].adb->numBlocks() > 0) {
+                    active.push_back(f);
+                }
+            }
+            const int num_active = active.size();
+
+            // The value of a factor x is x or 1/x, and the derivative of the
+            // product with respect to the factor is the product of the
+            // others times 1 or -1/x^2.
+            V val(n);
+            std::vector<V> coef(num_active, V(n));
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (int i = 0; i < n; ++i) {
+                Scalar product = 1.0;
+                for (int f = 0; f < num_factors; ++f) {
+                    product *= factorValue(f, i);
+                }
+                val[i] = product;
+                for (int a = 0; a < num_active; ++a) {
+                    const int fa = active[a];
+                    const Scalar xa = factorValue(fa, i);
+                    Scalar c = factors_[fa].inverse ? -xa * xa : Scalar(1.0);
+                    for (int f = 0; f < num_factors; ++f) {
+                        if (f != fa) {
+                            c *= factorValue(f, i);
+                        }
+                    }
+                    coef[a][i] = c;
+                }
+            }
+
+            if (num_active == 0) {
+                return ADB::constant(std::move(val));
+            }
+
+            const int num_blocks = factors_[active[0]].adb->numBlocks();
+            std::vector<M> jac(num_blocks);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif // HAVE_OPENMP
+            for (int block = 0; block < num_blocks; ++block) {
+                std::vector<const double*> scale(num_active);
+                std::vector<const M*> term(num_active);
+                for (int a = 0; a < num_active; ++a) {
+                    assert(factors_[active[a]].adb->numBlocks() == num_blocks);
+                    scale[a] = coef[a].data();
+                    term[a] = &factors_[active[a]].adb->derivative()[block];
+                }
+                jac[block] = M::rowScaledSum(scale, term);
+            }
+            return ADB::function(std::move(val), std::move(jac));
+        }
+
+        operator ADB() const
+        {
+            return evaluate();
+        }
+
+    private:
+        struct Factor
+        {
+            const Scalar* value;
+            const ADB* adb;
+            bool inverse;
+        };
+
+        void append(const V& value, const ADB* adb, const bool inverse)
+        {
+            if (factors_.empty()) {
+                size_ = value.size();
+            }
+            assert(value.size() == size_);
+            factors_.push_back(Factor{ value.data(), adb, inverse });
+        }
+
+        Scalar factorValue(const int f, const int i) const
+        {
+            const Scalar x = factors_[f].value[i];
+            return factors_[f].inverse ? Scalar(1.0) / x : x;
+        }
+
+        std::vector<Factor> factors_;
+        int size_ = 0;
+    };
+
+
+
+    /// Start a lazily evaluated product with the factor x.
+    template <typename Scalar>
+    AutoDiffProduct<Scalar> fusedProduct(const AutoDiffBlock<Scalar>& x)
+    {
+        return AutoDiffProduct<Scalar>(x);
+    }
+
+
+
+    /// Start a lazily evaluated product with the factor x.
+    template <typename Scalar>
+    AutoDiffProduct<Scalar> fusedProduct(const Eigen::Array<Scalar, Eigen::Dynamic, 1>& x)
+    {
+        return AutoDiffProduct<Scalar>(x);
+    }
+
+} // namespace Opm
+
+#endif // OPM_AUTODIFFPRODUCT_HEADER_INCLUDED
@@ -88,16 +88,12 @@ Dune::OverlappingSchwarzOperator<M,X,Y,T> createOperator(const Dune::Overlapping
 //! \param comm The communication objecte describing the data distribution.
 //! \param pressureIndex The index of the pressure in the matrix block
 //! \retun A pair of the scaled matrix and the associated operator-
-template<class Operator, class Communication>
-std::tuple<std::unique_ptr<typename Operator::matrix_type>, Operator>
-scaleMatrixQuasiImpes(const Operator& op, const Communication& comm,
-                      std::size_t pressureIndex)
+template<class Matrix>
+void scaleMatrixBlocksQuasiImpes(Matrix& matrix, std::size_t pressureIndex)
 {
-    using Matrix = typename Operator::matrix_type;
     using Block = typename Matrix::block_type;
-    std::unique_ptr<Matrix> matrix(new Matrix(op.getmat()));
 
-    for ( auto& row : *matrix )
+    for ( auto& row : matrix )
     {
         for ( auto& block : row )
         {
@@ -113,9 +109,43 @@ scaleMatrixQuasiImpes(const Operator& op, const Communication& comm,
             }
         }
     }
+}
+
+template<class Operator, class Communication>
+std::tuple<std::unique_ptr<typename Operator::matrix_type>, Operator>
+scaleMatrixQuasiImpes(const Operator& op, const Communication& comm,
+                      std::size_t pressureIndex)
+{
+    using Matrix = typename Operator::matrix_type;
+    std::unique_ptr<Matrix> matrix(new Matrix(op.getmat()));
+    scaleMatrixBlocksQuasiImpes(*matrix, pressureIndex);
     return std::make_tuple(std::move(matrix), createOperator(op, *matrix, comm));
 }
 
+//! \brief Recomputes the scaled matrix of scaleMatrixQuasiImpes for new matrix values.
+//!
+//! \param fineMatrix The matrix that stems from the discretization. It needs to
+//!                   have the same sparsity pattern as scaledMatrix.
+//! \param scaledMatrix The scaled matrix to overwrite.
+//! \param pressureIndex The index of the pressure in the matrix block
+template<class Matrix>
+void updateScaledMatrixQuasiImpes(const Matrix& fineMatrix, Matrix& scaledMatrix,
+                                  std::size_t pressureIndex)
+{
+    auto scaledRow = scaledMatrix.begin();
+    for ( auto row = fineMatrix.begin(), rowEnd = fineMatrix.end(); row != rowEnd;
+          ++row, ++scaledRow )
+    {
+        auto scaledCol = scaledRow->begin();
+        for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col, ++scaledCol )
+        {
+            assert( col.index() == scaledCol.index() );
+            *scaledCol = *col;
+        }
+    }
+    scaleMatrixBlocksQuasiImpes(scaledMatrix, pressureIndex);
+}
+
 //! \brief Applies diagonal scaling to the discretization Matrix (Scheichl, 2003)
 //!
 //! See section 3.2.3 of Scheichl, Masson: Decoupling and Block Preconditioning for
@@ -330,12 +360,12 @@ public:
      * @param c The crition used for the aggregation within AMG.
      */
     OneStepAMGCoarseSolverPolicy(const CPRParameter* param, const SmootherArgs& args, const Criterion& c)
-        : param_(param), smootherArgs_(args), criterion_(c)
+        : param_(param), smootherArgs_(args), criterion_(c), coarseSolver_()
     {}
     /** @brief Copy constructor. */
     OneStepAMGCoarseSolverPolicy(const OneStepAMGCoarseSolverPolicy& other)
         : param_(other.param_), coarseOperator_(other.coarseOperator_), smootherArgs_(other.smootherArgs_),
-          criterion_(other.criterion_)
+          criterion_(other.criterion_), coarseSolver_()
     {}
 private:
     /**
@@ -457,6 +487,25 @@ private:
             return apply(x,b,1e-8,res);
         }
 
+        /**
+         * @brief Recomputes the solver for new values of the coarse level matrix.
+         *
+         * The aggregates of the AMG are kept and only the Galerkin products
+         * are recalculated. The smoothers of the AMG levels keep the
+         * decomposition of the last full setup.
+         */
+        void update()
+        {
+            if ( amg_ )
+            {
+                amg_->recalculateHierarchy();
+            }
+            else
+            {
+                smoother_->update(op_.getmat());
+            }
+        }
+
         ~AMGInverseOperator()
         {}
         AMGInverseOperator(const AMGInverseOperator& other)
@@ -493,11 +542,22 @@ public:
                                                          criterion_,
                                                          smootherArgs_,
                                                          transfer.getCoarseLevelCommunication());
+        coarseSolver_ = inv;
 
         return inv; //std::shared_ptr<InverseOperator<X,X> >(inv);
 
     }
 
+    /**
+     * @brief Updates the last constructed coarse level solver for new
+     *        values of the coarse level matrix.
+     */
+    void updateCoarseLevelSolver()
+    {
+        assert( coarseSolver_ );
+        coarseSolver_->update();
+    }
+
 private:
     /** @brief The coarse level operator. */
     std::shared_ptr<Operator> coarseOperator_;
@@ -507,6 +567,8 @@ private:
     SmootherArgs smootherArgs_;
     /** @brief The coarsening criterion. */
     Criterion criterion_;
+    /** @brief The last coarse level solver constructed (owned by the two level method). */
+    AMGInverseOperator* coarseSolver_;
 };
 
 template<class Smoother, class Operator, class Communication>
@@ -657,6 +719,15 @@ public:
 
     void createCoarseLevelSystem(const Operator& fineOperator)
     {
+        if ( coarseLevelMatrix_ && this->operator_ )
+        {
+            // The coarse level system was already set up (possibly by the policy
+            // this one was cloned from, the structures are shared). Keep the
+            // aggregates and the sparsity pattern and only recompute the values.
+            calculateCoarseEntries(fineOperator.getmat());
+            return;
+        }
+
         prolongDamp_ = 1;
 
         if ( cpr_pressure_aggregation_ )
@@ -741,18 +812,7 @@ public:
                 ++createIter;
             }
 
-            auto coarseRow = coarseLevelMatrix_->begin();
-            for ( const auto& row: fineLevelMatrix )
-            {
-                auto coarseCol = coarseRow->begin();
-
-                for ( auto col = row.begin(), cend = row.end(); col != cend; ++col, ++coarseCol )
-                {
-                    assert( col.index() == coarseCol.index() );
-                    *coarseCol = (*col)[COMPONENT_INDEX][COMPONENT_INDEX];
-                }
-                ++coarseRow;
-            }
+            calculateCoarseEntries(fineLevelMatrix);
             coarseLevelCommunication_.reset(communication_, [](Communication*){});
         }
 
@@ -766,24 +826,42 @@ public:
     template<class M>
     void calculateCoarseEntries(const M& fineMatrix)
     {
-      *coarseLevelMatrix_ = 0;
-        for(auto row = fineMatrix.begin(), rowEnd = fineMatrix.end();
-            row != rowEnd; ++row)
+        if ( cpr_pressure_aggregation_ )
         {
-            const auto& i = (*aggregatesMap_)[row.index()];
-            if(i != AggregatesMap::ISOLATED)
+            *coarseLevelMatrix_ = 0;
+            for(auto row = fineMatrix.begin(), rowEnd = fineMatrix.end();
+                row != rowEnd; ++row)
             {
-                for(auto entry = row->begin(), entryEnd = row->end();
-                    entry != entryEnd; ++entry)
+                const auto& i = (*aggregatesMap_)[row.index()];
+                if(i != AggregatesMap::ISOLATED)
                 {
-                    const auto& j = (*aggregatesMap_)[entry.index()];
-                    if ( j != AggregatesMap::ISOLATED )
+                    for(auto entry = row->begin(), entryEnd = row->end();
+                        entry != entryEnd; ++entry)
                     {
-                        (*coarseLevelMatrix_)[i][j] += (*entry)[COMPONENT_INDEX][COMPONENT_INDEX];
+                        const auto& j = (*aggregatesMap_)[entry.index()];
+                        if ( j != AggregatesMap::ISOLATED )
+                        {
+                            (*coarseLevelMatrix_)[i][j] += (*entry)[COMPONENT_INDEX][COMPONENT_INDEX];
+                        }
                     }
                 }
             }
         }
+        else
+        {
+            auto coarseRow = coarseLevelMatrix_->begin();
+            for ( const auto& row: fineMatrix )
+            {
+                auto coarseCol = coarseRow->begin();
+
+                for ( auto col = row.begin(), cend = row.end(); col != cend; ++col, ++coarseCol )
+                {
+                    assert( col.index() == coarseCol.index() );
+                    *coarseCol = (*col)[COMPONENT_INDEX][COMPONENT_INDEX];
+                }
+                ++coarseRow;
+            }
+        }
     }
 
     void moveToCoarseLevel(const typename FatherType::FineRangeType& fine)
@@ -946,20 +1024,47 @@ public:
                                                         smargs, comm)),
           levelTransferPolicy_(criterion, comm, param.cpr_pressure_aggregation_),
           coarseSolverPolicy_(&param, smargs, criterion),
-          twoLevelMethod_(std::get<1>(scaledMatrixOperator_), smoother_,
-                          levelTransferPolicy_,
-                          coarseSolverPolicy_, 0, 1)
-    {}
+          twoLevelMethod_()
+    {
+        // The two level method works on a clone of the level transfer policy.
+        // Setting up the coarse level system here makes the clone share the
+        // aggregates and the coarse matrix with levelTransferPolicy_, which
+        // is needed to update them in updatePreconditioner().
+        levelTransferPolicy_.createCoarseLevelSystem(std::get<1>(scaledMatrixOperator_));
+        twoLevelMethod_.reset(new TwoLevelMethod(std::get<1>(scaledMatrixOperator_), smoother_,
+                                                 levelTransferPolicy_,
+                                                 coarseSolverPolicy_, 0, 1));
+    }
+
+    /**
+     * \brief Recomputes the preconditioner for new values of the fine level matrix.
+     *
+     * The aggregates and the sparsity pattern of all levels are kept. Only the
+     * scaled matrix, the decomposition of the fine level smoother, the coarse
+     * level matrix and the Galerkin products of the coarse level AMG are
+     * recomputed. This requires a smoother that provides update(matrix),
+     * e.g. ParallelOverlappingILU0.
+     * \param fineMatrix The new matrix of the fine level. It needs to have the
+     *                   sparsity pattern of the one used for the setup.
+     */
+    void updatePreconditioner(const Matrix& fineMatrix)
+    {
+        Matrix& scaledMatrix = *std::get<0>(scaledMatrixOperator_);
+        Detail::updateScaledMatrixQuasiImpes(fineMatrix, scaledMatrix, COMPONENT_INDEX);
+        smoother_->update(scaledMatrix);
+        levelTransferPolicy_.calculateCoarseEntries(scaledMatrix);
+        coarseSolverPolicy_.updateCoarseLevelSolver();
+    }
 
     void pre(typename TwoLevelMethod::FineDomainType& x,
              typename TwoLevelMethod::FineRangeType& b)
     {
-        twoLevelMethod_.pre(x,b);
+        twoLevelMethod_->pre(x,b);
     }
 
     void post(typename TwoLevelMethod::FineDomainType& x)
     {
-        twoLevelMethod_.post(x);
+        twoLevelMethod_->post(x);
     }
 
     void apply(typename TwoLevelMethod::FineDomainType& v,
@@ -967,7 +1072,7 @@ public:
     {
         auto scaledD = d;
         Detail::scaleVectorQuasiImpes(scaledD, COMPONENT_INDEX);
-        twoLevelMethod_.apply(v, scaledD);
+        twoLevelMethod_->apply(v, scaledD);
     }
 private:
     const CPRParameter& param_;
@@ -975,7 +1080,7 @@ private:
     std::shared_ptr<Smoother> smoother_;
     LevelTransferPolicy levelTransferPolicy_;
     CoarseSolverPolicy coarseSolverPolicy_;
-    TwoLevelMethod twoLevelMethod_;
+    std::unique_ptr<TwoLevelMethod> twoLevelMethod_;
 };
 
 namespace ISTLUtility
@@ -196,6 +196,44 @@ namespace detail {
             return grid.comm().sum(count);
         }
 
+        /// \brief Copy the values of a sparse matrix into another one.
+        ///
+        /// The target keeps its storage, no memory is allocated.
+        /// \tparam Matrix The type of the DUNE BCRSMatrix.
+        /// \param source The matrix to copy the values from.
+        /// \param target The matrix to copy the values to.
+        /// \return false if the sparsity patterns of the matrices differ,
+        ///         the values of target are undefined in that case.
+        template<class Matrix>
+        bool copyMatrixValues(const Matrix& source, Matrix& target)
+        {
+            if ( source.N() != target.N() || source.M() != target.M() ||
+                 source.nonzeroes() != target.nonzeroes() )
+            {
+                return false;
+            }
+
+            auto targetRow = target.begin();
+            for ( auto row = source.begin(), rowEnd = source.end(); row != rowEnd; ++row, ++targetRow )
+            {
+                auto targetCol = targetRow->begin();
+                const auto targetColEnd = targetRow->end();
+                for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col, ++targetCol )
+                {
+                    if ( targetCol == targetColEnd || targetCol.index() != col.index() )
+                    {
+                        return false;
+                    }
+                    *targetCol = *col;
+                }
+                if ( targetCol != targetColEnd )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
 
     } // namespace detail
 } // namespace Opm
@@ -30,6 +30,7 @@
 
 #include <opm/autodiff/AutoDiffBlock.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
+#include <opm/autodiff/AutoDiffProduct.hpp>
 #include <opm/autodiff/GridHelpers.hpp>
 #include <opm/autodiff/WellHelpers.hpp>
 #include <opm/autodiff/BlackoilPropsAdFromDeck.hpp>
@@ -1494,7 +1495,7 @@ typedef Eigen::Array<double,
     {
         // Compute and store mobilities.
         const ADB tr_mult = transMult(state.pressure);
-        sd_.rq[ actph ].mob = tr_mult * kr / mu;
+        sd_.rq[ actph ].mob = fusedProduct(tr_mult) * kr / mu;
 
         // Compute head differentials. Gravity potential is done using the face average as in eclipse and MRST.
         const ADB rhoavg = ops_.caver * rho;
@@ -1508,7 +1509,7 @@ typedef Eigen::Array<double,
         const ADB& mob = sd_.rq[ actph ].mob;
         const ADB& dh  = sd_.rq[ actph ].dh;
         UpwindSelector<double> upwind(grid_, ops_, dh.value());
-        sd_.rq[ actph ].mflux = upwind.select(b * mob) * (transi * dh);
+        sd_.rq[ actph ].mflux = fusedProduct(upwind.select(b * mob)) * transi * dh;
     }
 
 
@@ -2603,7 +2604,7 @@ typedef Eigen::Array<double,
                     const std::vector<int>& well_cells = asImpl().wellModel().wellOps().well_cells;
                     const ADB mu = asImpl().fluidViscosity(canph_[phase], state.canonical_phase_pressures[canph_[phase]],
                                                        temp, rs, rv, cond);
-                    mob[phase] = tr_mult * kr[canph_[phase]] / mu;
+                    mob[phase] = fusedProduct(tr_mult) * kr[canph_[phase]] / mu;
                     mob_perfcells[phase] = subset(mob[phase], well_cells);
 
                     b[phase] = asImpl().fluidReciprocFVF(phase, state.canonical_phase_pressures[phase], temp, rs, rv, cond);
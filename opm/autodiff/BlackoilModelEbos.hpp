@@ -43,11 +43,15 @@
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 #include <opm/simulators/timestepping/SimulatorTimer.hpp>
+#include <opm/simulators/BatchedAllReduce.hpp>
+#include <opm/simulators/Tracer.hpp>
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
 #include <opm/autodiff/ISTLSolver.hpp>
+#include <opm/autodiff/LinearSystemSnapshot.hpp>
+#include <opm/simulators/ensureDirectoryExists.hpp>
 #include <opm/common/data/SimulationDataContainer.hpp>
 
 #include <dune/istl/owneroverlapcopy.hh>
@@ -60,10 +64,16 @@
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sstream>
+#include <string>
 #include <vector>
 #include <algorithm>
 //#include <fstream>
 
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
 
 
 namespace Ewoms {
@@ -160,9 +170,22 @@ namespace Opm {
         , terminal_output_ (terminal_output)
         , current_relaxation_(1.0)
         , dx_old_(UgGridHelpers::numCells(grid_))
+        , snapshot_count_(0)
         {
             // compute global sum of number of cells
             global_nc_ = detail::countGlobalCells(grid_);
+
+            ElementContext elemCtx(ebosSimulator_);
+            const auto& gridView = ebosSimulator_.gridView();
+            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                 elemIt != elemEndIt;
+                 ++elemIt)
+            {
+                elemCtx.updatePrimaryStencil(*elemIt);
+                interiorCells_.push_back(elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0));
+            }
+
             if (!istlSolver_)
             {
                 OPM_THROW(std::logic_error,"solver down cast to ISTLSolver failed");
@@ -206,6 +229,9 @@ namespace Opm {
 
             wellModel().beginTimeStep();
 
+            // a reused setup of the linear solver's preconditioner is refreshed per time step
+            istlSolver().prepareTimeStep();
+
             if (param_.update_equations_scaling_) {
                 std::cout << "equation scaling not suported yet" << std::endl;
                 //updateEquationsScaling();
@@ -281,7 +307,7 @@ namespace Opm {
                 BVector x(nc);
 
                 try {
-                    solveJacobianSystem(x);
+                    solveJacobianSystem(x, snapshotFileName(timer, iteration));
                     report.linear_solve_time += perfTimer.stop();
                     report.total_linear_iterations += linearIterationsLastSolve();
                 }
@@ -360,11 +386,15 @@ namespace Opm {
         SimulatorReport assemble(const SimulatorTimerInterface& timer,
                                  const int iterationIdx)
         {
+            OPM_TRACE_SCOPE("BlackoilModelEbos::assemble");
             // -------- Mass balance equations --------
-            ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
-            ebosSimulator_.problem().beginIteration();
-            ebosSimulator_.model().linearizer().linearize();
-            ebosSimulator_.problem().endIteration();
+            {
+                OPM_TRACE_SCOPE("BlackoilModelEbos::assembleReservoir");
+                ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
+                ebosSimulator_.problem().beginIteration();
+                ebosSimulator_.model().linearizer().linearize();
+                ebosSimulator_.problem().endIteration();
+            }
 
             // -------- Well equations ----------
             double dt = timer.currentStepLength();
@@ -386,7 +416,14 @@ namespace Opm {
             }
             if ( param_.preconditioner_add_well_contributions_ &&
                  ! param_.matrix_add_well_contributions_ ) {
-                matrix_for_preconditioner_ .reset(new Mat(ebosJac));
+                // the matrix is only allocated if the sparsity pattern of the
+                // Jacobian changed, otherwise only the values are copied.
+                if ( ! matrix_for_preconditioner_ ||
+                     ! detail::copyMatrixValues(ebosJac, *matrix_for_preconditioner_) ) {
+                    // release the old matrix first to not hold two copies
+                    matrix_for_preconditioner_.reset();
+                    matrix_for_preconditioner_.reset(new Mat(ebosJac));
+                }
                 wellModel().addWellContributions(*matrix_for_preconditioner_);
             }
 
@@ -463,8 +500,12 @@ namespace Opm {
                 }
             }
 
-            resultDelta = gridView.comm().sum(resultDelta);
-            resultDenom = gridView.comm().sum(resultDenom);
+            BatchedAllReduce reduction(gridView.comm());
+            const auto deltaHandle = reduction.sum(resultDelta);
+            const auto denomHandle = reduction.sum(resultDenom);
+            reduction.execute();
+            resultDelta = reduction[deltaHandle];
+            resultDenom = reduction[denomHandle];
 
 	    if (resultDenom > 0.0)
 	      return resultDelta/resultDenom;
@@ -479,9 +520,11 @@ namespace Opm {
         }
 
         /// Solve the Jacobian system Jx = r where J is the Jacobian and
-        /// r is the residual.
-        void solveJacobianSystem(BVector& x) const
+        /// r is the residual. If snapshotFile is not empty, the system is
+        /// also written to it.
+        void solveJacobianSystem(BVector& x, const std::string& snapshotFile = std::string()) const
         {
+            OPM_TRACE_SCOPE("BlackoilModelEbos::solveJacobianSystem");
             const auto& ebosJac = ebosSimulator_.model().linearizer().matrix();
             auto& ebosResid = ebosSimulator_.model().linearizer().residual();
 
@@ -501,6 +544,9 @@ namespace Opm {
             x = 0.0;
 
             const Mat& actual_mat_for_prec = matrix_for_preconditioner_ ? *matrix_for_preconditioner_.get() : ebosJac;
+            if (!snapshotFile.empty()) {
+                writeSystemSnapshot(snapshotFile, ebosJac, actual_mat_for_prec, ebosResid);
+            }
             // Solve system.
             if( isParallel() )
             {
@@ -518,6 +564,52 @@ namespace Opm {
             }
         }
 
+        /// The file to write the snapshot of the linear system of this
+        /// Newton iteration to, or an empty string if none is requested.
+        std::string snapshotFileName(const SimulatorTimerInterface& timer, const int iteration)
+        {
+            const auto selected = [](const std::vector<int>& list, const int value) {
+                return list.empty() || std::find(list.begin(), list.end(), value) != list.end();
+            };
+            if (param_.linear_system_snapshot_dir_.empty()
+                || !selected(param_.linear_system_snapshot_steps_, timer.reportStepNum())
+                || !selected(param_.linear_system_snapshot_iterations_, iteration)) {
+                return std::string();
+            }
+
+            ensureDirectoryExists(param_.linear_system_snapshot_dir_);
+            // the count keeps the snapshots of repeated (chopped) time steps
+            std::ostringstream filename;
+            filename << param_.linear_system_snapshot_dir_ << "/system-"
+                     << std::setw(4) << std::setfill('0') << snapshot_count_++
+                     << "-step" << timer.reportStepNum() << "." << timer.currentStepNum()
+                     << "-iter" << iteration;
+            if (isParallel()) {
+                filename << "-p" << grid_.comm().rank();
+            }
+            filename << ".linsys";
+            return filename.str();
+        }
+
+        /// Write the reservoir matrix, the matrix used for the preconditioner
+        /// if it differs, the residual with the well equations eliminated and
+        /// the blocks of the well equations to a snapshot file, which can be
+        /// replayed with the replay_linear_system program.
+        void writeSystemSnapshot(const std::string& filename,
+                                 const Mat& jacobian,
+                                 const Mat& preconditionerMatrix,
+                                 const BVector& residual) const
+        {
+            OPM_TRACE_SCOPE("BlackoilModelEbos::writeSystemSnapshot");
+            LinearSystemSnapshotWriter writer(filename);
+            writer.writeMatrix("matrix", jacobian);
+            if (&preconditionerMatrix != &jacobian) {
+                writer.writeMatrix("preconditioner_matrix", preconditionerMatrix);
+            }
+            writer.writeVector("residual", residual);
+            wellModel().writeSystemSnapshot(writer);
+        }
+
         //=====================================================================
         // Implementation for ISTL-matrix based operator
         //=====================================================================
@@ -578,6 +670,7 @@ namespace Opm {
 
           virtual void apply( const X& x, Y& y ) const
           {
+            OPM_TRACE_SCOPE("WellModelMatrixAdapter::apply");
             A_.mv( x, y );
 
             // add well model modification to y
@@ -592,6 +685,7 @@ namespace Opm {
           // y += \alpha * A * x
           virtual void applyscaleadd (field_type alpha, const X& x, Y& y) const
           {
+            OPM_TRACE_SCOPE("WellModelMatrixAdapter::applyscaleadd");
             A_.usmv(alpha,x,y);
 
             // add scaled well model modification to y
@@ -623,24 +717,20 @@ namespace Opm {
         /// \param[in, out] well_state        well state variables
         void updateState(const BVector& dx)
         {
+            OPM_TRACE_SCOPE("BlackoilModelEbos::updateState");
             const auto& ebosProblem = ebosSimulator_.problem();
 
             unsigned numSwitched = 0;
-            ElementContext elemCtx( ebosSimulator_ );
-            const auto& gridView = ebosSimulator_.gridView();
-            const auto& elemEndIt = gridView.template end</*codim=*/0>();
             SolutionVector& solution = ebosSimulator_.model().solution( 0 /* timeIdx */ );
-
-            for (auto elemIt = gridView.template begin</*codim=*/0>();
-                 elemIt != elemEndIt;
-                 ++elemIt)
+            // the update only depends on the primary variables of each cell,
+            // hence the intensive quantities do not need to be evaluated.
+            const int numCells = solution.size();
+
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) reduction(+:numSwitched)
+#endif // HAVE_OPENMP
+            for (int cell_idx = 0; cell_idx < numCells; ++cell_idx)
             {
-                const auto& elem = *elemIt;
-
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-
                 PrimaryVariables& priVars = solution[ cell_idx ];
 
                 const double& dp = dx[cell_idx][Indices::pressureSwitchIdx];
@@ -783,48 +873,78 @@ namespace Opm {
 
             if( comm.size() > 1 )
             {
-                // global reduction
-                std::vector< Scalar > sumBuffer;
-                std::vector< Scalar > maxBuffer;
-                const int numComp = B_avg.size();
-                sumBuffer.reserve( 2*numComp + 1 ); // +1 for pvSum
-                maxBuffer.reserve( numComp );
-                for( int compIdx = 0; compIdx < numComp; ++compIdx )
-                {
-                    sumBuffer.push_back( B_avg[ compIdx ] );
-                    sumBuffer.push_back( R_sum[ compIdx ] );
-                    maxBuffer.push_back( maxCoeff[ compIdx ] );
-                }
+                // global reduction of the sums and maxima in a single collective
+                BatchedAllReduce reduction(comm);
+                const auto bHandle = reduction.sum(B_avg);
+                const auto rHandle = reduction.sum(R_sum);
+                const auto pvHandle = reduction.sum(pvSum);
+                const auto maxHandle = reduction.max(maxCoeff);
+                reduction.execute();
 
-                // Compute total pore volume
-                sumBuffer.push_back( pvSum );
+                // restore values to local variables
+                reduction.get(bHandle, B_avg);
+                reduction.get(rHandle, R_sum);
+                reduction.get(maxHandle, maxCoeff);
 
-                // compute global sum
-                comm.sum( sumBuffer.data(), sumBuffer.size() );
+                // restore global pore volume
+                pvSum = reduction[pvHandle];
+            }
 
-                // compute global max
-                comm.max( maxBuffer.data(), maxBuffer.size() );
+            // return global pore volume
+            return pvSum;
+        }
 
-                // restore values to local variables
-                for( int compIdx = 0, buffIdx = 0; compIdx < numComp; ++compIdx, ++buffIdx )
-                {
-                    B_avg[ compIdx ]    = sumBuffer[ buffIdx ];
-                    ++buffIdx;
+        /// Add the contribution of a single cell to the sums and maxima
+        /// used by the convergence check.
+        template <class IntensiveQuantities>
+        void addCellConvergence_(const unsigned cell_idx,
+                                 const IntensiveQuantities& intQuants,
+                                 std::vector< Scalar >& R_sum,
+                                 std::vector< Scalar >& B_avg,
+                                 std::vector< Scalar >& maxCoeff,
+                                 double& pvSum) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& ebosProblem = ebosSimulator_.problem();
+            const auto& ebosResid = ebosModel.linearizer().residual();
+            const auto& fs = intQuants.fluidState();
 
-                    R_sum[ compIdx ]       = sumBuffer[ buffIdx ];
-                }
+            const double pvValue = ebosProblem.porosity(cell_idx) * ebosModel.dofTotalVolume( cell_idx );
+            pvSum += pvValue;
 
-                for( int compIdx = 0; compIdx < numComp; ++compIdx )
-                {
-                    maxCoeff[ compIdx ] = maxBuffer[ compIdx ];
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+            {
+                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                    continue;
                 }
 
-                // restore global pore volume
-                pvSum = sumBuffer.back();
+                const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+
+                B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][compIdx];
+
+                R_sum[ compIdx ] += R2;
+                maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
             }
 
-            // return global pore volume
-            return pvSum;
+            if ( has_solvent_ ) {
+                B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
+                const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
+                R_sum[ contiSolventEqIdx ] += R2;
+                maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if (has_polymer_ ) {
+                B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
+                const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
+                R_sum[ contiPolymerEqIdx ] += R2;
+                maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            if (has_energy_ ) {
+                B_avg[ contiEnergyEqIdx ] += 1.0;
+                const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
+                R_sum[ contiEnergyEqIdx ] += R2;
+                maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
+            }
         }
 
         /// Compute convergence based on total mass balance (tol_mb) and maximum
@@ -834,6 +954,7 @@ namespace Opm {
         /// \param[in]   iteration   current iteration number
         bool getConvergence(const SimulatorTimerInterface& timer, const int iteration, std::vector<double>& residual_norms)
         {
+            OPM_TRACE_SCOPE("BlackoilModelEbos::getConvergence");
             typedef std::vector< Scalar > Vector;
 
             const double dt = timer.currentStepLength();
@@ -848,63 +969,67 @@ namespace Opm {
             Vector maxCoeff(numComp, std::numeric_limits< Scalar >::lowest() );
 
             const auto& ebosModel = ebosSimulator_.model();
-            const auto& ebosProblem = ebosSimulator_.problem();
-
-            const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
 
-            ElementContext elemCtx(ebosSimulator_);
-            const auto& gridView = ebosSimulator().gridView();
-            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            // the intensive quantities of the linearization are read directly
+            // from the cache if it is valid. The cache is invalidated for all
+            // cells at once.
+            const bool cached = ebosModel.numGridDof() > 0 &&
+                ebosModel.cachedIntensiveQuantities(0, /*timeIdx=*/0) != nullptr;
 
             double pvSumLocal = 0.0;
-            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
-                 elemIt != elemEndIt;
-                 ++elemIt)
-            {
-                const auto& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = intQuants.fluidState();
-
-                const double pvValue = ebosProblem.porosity(cell_idx) * ebosModel.dofTotalVolume( cell_idx );
-                pvSumLocal += pvValue;
-
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
-                {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                        continue;
-                    }
-
-                    const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
-
-                    B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][compIdx];
-
-                    R_sum[ compIdx ] += R2;
-                    maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
+            if (cached) {
+                const int numInterior = interiorCells_.size();
+                int numThreads = 1;
+#if HAVE_OPENMP
+                numThreads = omp_get_max_threads();
+#endif // HAVE_OPENMP
+
+                // per thread partial results, combined in a fixed order
+                std::vector<Vector> R_sumThread(numThreads, Vector(numComp, 0.0));
+                std::vector<Vector> B_avgThread(numThreads, Vector(numComp, 0.0));
+                std::vector<Vector> maxCoeffThread(numThreads, maxCoeff);
+                std::vector<double> pvSumThread(numThreads, 0.0);
+
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif // HAVE_OPENMP
+                for (int i = 0; i < numInterior; ++i) {
+                    int threadIdx = 0;
+#if HAVE_OPENMP
+                    threadIdx = omp_get_thread_num();
+#endif // HAVE_OPENMP
+                    const unsigned cell_idx = interiorCells_[i];
+                    const auto& intQuants = *ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0);
+                    addCellConvergence_(cell_idx, intQuants,
+                                        R_sumThread[threadIdx], B_avgThread[threadIdx],
+                                        maxCoeffThread[threadIdx], pvSumThread[threadIdx]);
                 }
 
-                if ( has_solvent_ ) {
-                    B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
-                    const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
-                    R_sum[ contiSolventEqIdx ] += R2;
-                    maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if (has_polymer_ ) {
-                    B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
-                    R_sum[ contiPolymerEqIdx ] += R2;
-                    maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
+                for (int t = 0; t < numThreads; ++t) {
+                    pvSumLocal += pvSumThread[t];
+                    for (int compIdx = 0; compIdx < numComp; ++compIdx) {
+                        R_sum[compIdx] += R_sumThread[t][compIdx];
+                        B_avg[compIdx] += B_avgThread[t][compIdx];
+                        maxCoeff[compIdx] = std::max(maxCoeff[compIdx], maxCoeffThread[t][compIdx]);
+                    }
                 }
-                if (has_energy_ ) {
-                    B_avg[ contiEnergyEqIdx ] += 1.0;
-                    const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
-                    R_sum[ contiEnergyEqIdx ] += R2;
-                    maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
+            }
+            else {
+                ElementContext elemCtx(ebosSimulator_);
+                const auto& gridView = ebosSimulator().gridView();
+                const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+
+                for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                     elemIt != elemEndIt;
+                     ++elemIt)
+                {
+                    const auto& elem = *elemIt;
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    addCellConvergence_(cell_idx, intQuants, R_sum, B_avg, maxCoeff, pvSumLocal);
                 }
-
             }
 
             // compute local average in terms of global number of elements
@@ -1092,6 +1217,9 @@ namespace Opm {
 
         std::unique_ptr<Mat> matrix_for_preconditioner_;
 
+        // number of linear system snapshots written, part of their file names
+        int snapshot_count_;
+
     public:
         /// return the StandardWells object
         BlackoilWellModel<TypeTag>&
@@ -1119,7 +1247,11 @@ namespace Opm {
         double maxResidualAllowed() const { return param_.max_residual_allowed_; }
 
     public:
-        std::vector<bool> wasSwitched_;
+        // not std::vector<bool> since it is written concurrently by updateState()
+        std::vector<char> wasSwitched_;
+
+        // the indices of the interior cells of this process
+        std::vector<unsigned> interiorCells_;
     };
 } // namespace Opm
 
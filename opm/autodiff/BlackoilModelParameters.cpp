@@ -21,9 +21,28 @@
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
+#include <sstream>
+
 namespace Opm
 {
 
+    namespace
+    {
+        // parse a comma separated list of integers
+        std::vector<int> parseIntList(const std::string& list)
+        {
+            std::vector<int> values;
+            std::istringstream is(list);
+            std::string item;
+            while (std::getline(is, item, ',')) {
+                if (!item.empty()) {
+                    values.push_back(std::stoi(item));
+                }
+            }
+            return values;
+        }
+    } // anonymous namespace
+
 
     BlackoilModelParameters::BlackoilModelParameters()
     {
@@ -68,6 +87,9 @@ namespace Opm
         deck_file_name_ = param.template get<std::string>("deck_filename");
         matrix_add_well_contributions_ = param.getDefault("matrix_add_well_contributions", matrix_add_well_contributions_);
         preconditioner_add_well_contributions_ = param.getDefault("preconditioner_add_well_contributions", preconditioner_add_well_contributions_);
+        linear_system_snapshot_dir_ = param.getDefault("linear_system_snapshot_dir", linear_system_snapshot_dir_);
+        linear_system_snapshot_steps_ = parseIntList(param.getDefault("linear_system_snapshot_steps", std::string()));
+        linear_system_snapshot_iterations_ = parseIntList(param.getDefault("linear_system_snapshot_iterations", std::string()));
     }
 
 
@@ -99,6 +121,9 @@ namespace Opm
         use_multisegment_well_ = false;
         matrix_add_well_contributions_ = false;
         preconditioner_add_well_contributions_ = false;
+        linear_system_snapshot_dir_.clear();
+        linear_system_snapshot_steps_.clear();
+        linear_system_snapshot_iterations_.clear();
     }
 
 
@@ -21,6 +21,7 @@
 #define OPM_BLACKOILMODELPARAMETERS_HEADER_INCLUDED
 
 #include <string>
+#include <vector>
 
 namespace Opm
 {
@@ -99,6 +100,16 @@ namespace Opm
         // Whether to add influences of wells between cells to the preconditioner matrix only
         bool preconditioner_add_well_contributions_;
 
+        /// Directory to write snapshots of the linear systems to, for
+        /// replaying them offline. No snapshots are written if empty.
+        std::string linear_system_snapshot_dir_;
+
+        /// Report steps to write snapshots of the linear systems for, all if empty.
+        std::vector<int> linear_system_snapshot_steps_;
+
+        /// Newton iterations to write snapshots of the linear systems for, all if empty.
+        std::vector<int> linear_system_snapshot_iterations_;
+
         /// Construct from user parameters or defaults.
         explicit BlackoilModelParameters( const ParameterGroup& param );
 
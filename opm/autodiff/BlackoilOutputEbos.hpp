@@ -25,6 +25,7 @@
 
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/simulators/timestepping/SimulatorTimerInterface.hpp>
+#include <opm/simulators/Tracer.hpp>
 #include <opm/core/utility/DataMap.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
@@ -105,6 +106,7 @@ namespace Opm
                            const double nextstep = -1.0,
                            const SimulatorReport& simulatorReport = SimulatorReport())
         {
+            OPM_TRACE_SCOPE("BlackoilOutputEbos::writeTimeStep");
             if( output_ )
             {
                 // Add TCPU if simulatorReport is not defaulted.
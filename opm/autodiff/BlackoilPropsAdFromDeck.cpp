@@ -24,6 +24,7 @@
 #include <opm/autodiff/BlackoilPropsAdFromDeck.hpp>
 #include <opm/autodiff/BlackoilModelEnums.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
+#include <opm/autodiff/PvtCellGroups.hpp>
 
 #include <opm/core/props/BlackoilPropertiesInterface.hpp>
 #include <opm/core/props/BlackoilPhases.hpp>
@@ -38,6 +39,8 @@
 
 #include <opm/common/ErrorMacros.hpp>
 
+#include <algorithm>
+
 namespace Opm
 {
     // Making these typedef to make the code more readable.
@@ -45,6 +48,67 @@ namespace Opm
     typedef BlackoilPropsAdFromDeck::V V;
     typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Block;
 
+    namespace
+    {
+        /// The presence flag of properties that do not depend on it.
+        bool noPresence(int)
+        {
+            return false;
+        }
+
+        /// The presence flags used to group the cells.
+        enum PresenceKind { NoPresence, FreeGas, FreeOil, NumPresenceKinds };
+
+        /// The cell groups of the calling thread for one kind of presence
+        /// flag, updated for the evaluated cells. Each kind has its own
+        /// groups, so that alternating between the properties of the
+        /// phases does not rebuild them.
+        template <class Presence>
+        const PvtCellGroups& cellGroups(const PresenceKind kind,
+                                        const std::vector<int>& cellPvtRegionIdx,
+                                        const std::vector<int>& cells,
+                                        const Presence& presence)
+        {
+            static thread_local PvtCellGroups groups[NumPresenceKinds];
+            groups[kind].update(cellPvtRegionIdx, cells, presence);
+            return groups[kind];
+        }
+
+        /// The jacobians of a property f(x), diag(df/dx) * dx.
+        std::vector<ADB::M> chainRule(const V& dfdx, const ADB& x)
+        {
+            const int num_blocks = x.numBlocks();
+            std::vector<ADB::M> jacs(num_blocks);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (int block = 0; block < num_blocks; ++block) {
+                jacs[block] = ADB::M::rowScaledSum({ dfdx.data() }, { &x.derivative()[block] });
+            }
+            return jacs;
+        }
+
+        /// The jacobians of a property f(x, y), diag(df/dx) * dx +
+        /// diag(df/dy) * dy, formed in one pass per block. The y term is
+        /// left out if y is null.
+        std::vector<ADB::M> chainRule(const V& dfdx, const ADB& x, const V& dfdy, const ADB* y)
+        {
+            if (y == nullptr) {
+                return chainRule(dfdx, x);
+            }
+            const int num_blocks = x.numBlocks();
+            std::vector<ADB::M> jacs(num_blocks);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (int block = 0; block < num_blocks; ++block) {
+                jacs[block] = ADB::M::rowScaledSum({ dfdx.data(), dfdy.data() },
+                                                   { &x.derivative()[block], &y->derivative()[block] });
+            }
+            return jacs;
+        }
+    } // anonymous namespace
+
     /// Constructor wrapping an opm-core black oil interface.
     BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const Opm::Deck& deck,
                                                      const Opm::EclipseState& eclState,
@@ -276,32 +340,22 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/1> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 0.0;
-
-        pEval.setDerivative(0, 1.0);
-
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(pw.value()[i]);
-            TEval.setValue(T.value()[i]);
+        const PvtCellGroups& groups = cellGroups(NoPresence, cellPvtRegionIdx_, cells, noPresence);
+        groups.forEach([&](const unsigned pvtRegionIdx, bool, const int i) {
+            Eval pEval = pw.value()[i];
+            const Eval TEval = T.value()[i];
+            pEval.setDerivative(0, 1.0);
 
             const Eval& muEval = FluidSystem::waterPvt().viscosity(pvtRegionIdx, TEval, pEval);
 
             mu[i] = muEval.value();
             dmudp[i] = muEval.derivative(0);
-        }
+        });
 
         if (pw.derivative().empty()) {
             return ADB::constant(std::move(mu));
         } else {
-            ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
-            const int num_blocks = pw.numBlocks();
-            std::vector<ADB::M> jacs(num_blocks);
-            for (int block = 0; block < num_blocks; ++block) {
-                fastSparseProduct(dmudp_diag, pw.derivative()[block], jacs[block]);
-            }
-            return ADB::function(std::move(mu), std::move(jacs));
+            return ADB::function(std::move(mu), chainRule(dmudp, pw));
         }
     }
 
@@ -329,47 +383,30 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/2> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 0.0;
-        Eval RsEval = 0.0;
-
-        pEval.setDerivative(0, 1.0);
-        RsEval.setDerivative(1, 1.0);
-
-        Eval muEval;
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(po.value()[i]);
-            TEval.setValue(T.value()[i]);
+        const bool hasGas = phase_usage_.phase_used[Gas];
+        const PvtCellGroups& groups = cellGroups(FreeGas, cellPvtRegionIdx_, cells,
+                                                 [&cond](const int i) { return cond[i].hasFreeGas(); });
+        groups.forEach([&](const unsigned pvtRegionIdx, const bool hasFreeGas, const int i) {
+            Eval pEval = po.value()[i];
+            const Eval TEval = T.value()[i];
+            pEval.setDerivative(0, 1.0);
 
-            if (cond[i].hasFreeGas()) {
+            Eval muEval;
+            if (hasFreeGas) {
                 muEval = FluidSystem::oilPvt().saturatedViscosity(pvtRegionIdx, TEval, pEval);
             }
             else {
-                if (phase_usage_.phase_used[Gas]) {
-                    RsEval.setValue(rs.value()[i]);
-                }
+                Eval RsEval = hasGas ? rs.value()[i] : 0.0;
+                RsEval.setDerivative(1, 1.0);
                 muEval = FluidSystem::oilPvt().viscosity(pvtRegionIdx, TEval, pEval, RsEval);
             }
 
             mu[i] = muEval.value();
             dmudp[i] = muEval.derivative(0);
             dmudr[i] = muEval.derivative(1);
-        }
+        });
 
-        ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
-        ADB::M dmudr_diag(dmudr.matrix().asDiagonal());
-        const int num_blocks = po.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dmudp_diag, po.derivative()[block], jacs[block]);
-            if (phase_usage_.phase_used[Gas]) {
-                ADB::M temp;
-                fastSparseProduct(dmudr_diag, rs.derivative()[block], temp);
-                jacs[block] += temp;
-            }
-        }
-        return ADB::function(std::move(mu), std::move(jacs));
+        return ADB::function(std::move(mu), chainRule(dmudp, po, dmudr, hasGas ? &rs : nullptr));
     }
 
     /// Gas viscosity.
@@ -396,43 +433,29 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/2> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 0.0;
-        Eval RvEval = 0.0;
-        Eval muEval;
-
-        pEval.setDerivative(0, 1.0);
-        RvEval.setDerivative(1, 1.0);
-
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(pg.value()[i]);
-            TEval.setValue(T.value()[i]);
+        const PvtCellGroups& groups = cellGroups(FreeOil, cellPvtRegionIdx_, cells,
+                                                 [&cond](const int i) { return cond[i].hasFreeOil(); });
+        groups.forEach([&](const unsigned pvtRegionIdx, const bool hasFreeOil, const int i) {
+            Eval pEval = pg.value()[i];
+            const Eval TEval = T.value()[i];
+            pEval.setDerivative(0, 1.0);
 
-            if (cond[i].hasFreeOil()) {
+            Eval muEval;
+            if (hasFreeOil) {
                 muEval = FluidSystem::gasPvt().saturatedViscosity(pvtRegionIdx, TEval, pEval);
             }
             else {
-                RvEval.setValue(rv.value()[i]);
+                Eval RvEval = rv.value()[i];
+                RvEval.setDerivative(1, 1.0);
                 muEval = FluidSystem::gasPvt().viscosity(pvtRegionIdx, TEval, pEval, RvEval);
             }
 
             mu[i] = muEval.value();
             dmudp[i] = muEval.derivative(0);
             dmudr[i] = muEval.derivative(1);
-        }
+        });
 
-        ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
-        ADB::M dmudr_diag(dmudr.matrix().asDiagonal());
-        const int num_blocks = pg.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dmudp_diag, pg.derivative()[block], jacs[block]);
-            ADB::M temp;
-            fastSparseProduct(dmudr_diag, rv.derivative()[block], temp);
-            jacs[block] += temp;
-        }
-        return ADB::function(std::move(mu), std::move(jacs));
+        return ADB::function(std::move(mu), chainRule(dmudp, pg, dmudr, &rv));
     }
 
 
@@ -456,32 +479,22 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         V b(n);
         V dbdp(n);
-        V dbdr(n);
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/1> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 0.0;
-
-        pEval.setDerivative(0, 1.0);
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(pw.value()[i]);
-            TEval.setValue(T.value()[i]);
+        const PvtCellGroups& groups = cellGroups(NoPresence, cellPvtRegionIdx_, cells, noPresence);
+        groups.forEach([&](const unsigned pvtRegionIdx, bool, const int i) {
+            Eval pEval = pw.value()[i];
+            const Eval TEval = T.value()[i];
+            pEval.setDerivative(0, 1.0);
 
             const Eval& bEval = FluidSystem::waterPvt().inverseFormationVolumeFactor(pvtRegionIdx, TEval, pEval);
 
             b[i] = bEval.value();
             dbdp[i] = bEval.derivative(0);
-        }
+        });
 
-        ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
-        const int num_blocks = pw.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dbdp_diag, pw.derivative()[block], jacs[block]);
-        }
-        return ADB::function(std::move(b), std::move(jacs));
+        return ADB::function(std::move(b), chainRule(dbdp, pw));
     }
 
     /// Oil formation volume factor.
@@ -509,52 +522,32 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/2> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 0.0;
-        Eval RsEval = 0.0;
-        Eval bEval;
-
-        pEval.setDerivative(0, 1.0);
-        RsEval.setDerivative(1, 1.0);
-
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(po.value()[i]);
-            TEval.setValue(T.value()[i]);
+        const bool hasRs = rs.size() != 0;
+        const PvtCellGroups& groups = cellGroups(FreeGas, cellPvtRegionIdx_, cells,
+                                                 [&cond](const int i) { return cond[i].hasFreeGas(); });
+        groups.forEach([&](const unsigned pvtRegionIdx, const bool hasFreeGas, const int i) {
+            Eval pEval = po.value()[i];
+            const Eval TEval = T.value()[i];
+            pEval.setDerivative(0, 1.0);
 
             //RS/RV only makes sense when gas phase is active
-            if (cond[i].hasFreeGas()) {
+            Eval bEval;
+            if (hasFreeGas) {
                 bEval = FluidSystem::oilPvt().saturatedInverseFormationVolumeFactor(pvtRegionIdx, TEval, pEval);
             }
             else {
-                if (rs.size() == 0) {
-                    RsEval.setValue(0.0);
-                }
-                else {
-                    RsEval.setValue(rs.value()[i]);
-                }
+                Eval RsEval = hasRs ? rs.value()[i] : 0.0;
+                RsEval.setDerivative(1, 1.0);
                 bEval = FluidSystem::oilPvt().inverseFormationVolumeFactor(pvtRegionIdx, TEval, pEval, RsEval);
             }
 
             b[i] = bEval.value();
             dbdp[i] = bEval.derivative(0);
             dbdr[i] = bEval.derivative(1);
-        }
+        });
 
-        ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
-        ADB::M dbdr_diag(dbdr.matrix().asDiagonal());
-        const int num_blocks = po.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dbdp_diag, po.derivative()[block], jacs[block]);
-            if (phase_usage_.phase_used[Gas]) {
-                ADB::M temp;
-                fastSparseProduct(dbdr_diag, rs.derivative()[block], temp);
-                jacs[block] += temp;
-            }
-        }
-        return ADB::function(std::move(b), std::move(jacs));
+        return ADB::function(std::move(b),
+                             chainRule(dbdp, po, dbdr, phase_usage_.phase_used[Gas] ? &rs : nullptr));
     }
 
     /// Gas formation volume factor.
@@ -582,43 +575,29 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/2> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 0.0;
-        Eval RvEval = 0.0;
-        Eval bEval;
+        const PvtCellGroups& groups = cellGroups(FreeOil, cellPvtRegionIdx_, cells,
+                                                 [&cond](const int i) { return cond[i].hasFreeOil(); });
+        groups.forEach([&](const unsigned pvtRegionIdx, const bool hasFreeOil, const int i) {
+            Eval pEval = pg.value()[i];
+            const Eval TEval = T.value()[i];
+            pEval.setDerivative(0, 1.0);
 
-        pEval.setDerivative(0, 1.0);
-        RvEval.setDerivative(1, 1.0);
-
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(pg.value()[i]);
-            TEval.setValue(T.value()[i]);
-
-            if (cond[i].hasFreeOil()) {
+            Eval bEval;
+            if (hasFreeOil) {
                 bEval = FluidSystem::gasPvt().saturatedInverseFormationVolumeFactor(pvtRegionIdx, TEval, pEval);
             }
             else {
-                RvEval.setValue(rv.value()[i]);
+                Eval RvEval = rv.value()[i];
+                RvEval.setDerivative(1, 1.0);
                 bEval = FluidSystem::gasPvt().inverseFormationVolumeFactor(pvtRegionIdx, TEval, pEval, RvEval);
             }
 
             b[i] = bEval.value();
             dbdp[i] = bEval.derivative(0);
             dbdr[i] = bEval.derivative(1);
-        }
+        });
 
-        ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
-        ADB::M dbdr_diag(dbdr.matrix().asDiagonal());
-        const int num_blocks = pg.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(dbdp_diag, pg.derivative()[block], jacs[block]);
-            ADB::M temp;
-            fastSparseProduct(dbdr_diag, rv.derivative()[block], temp);
-            jacs[block] += temp;
-        }
-        return ADB::function(std::move(b), std::move(jacs));
+        return ADB::function(std::move(b), chainRule(dbdp, pg, dbdr, &rv));
     }
 
 
@@ -642,28 +621,19 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/1> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 293.15; // temperature is not supported by this API!
-
-        pEval.setDerivative(0, 1.0);
-
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(po.value()[i]);
+        const PvtCellGroups& groups = cellGroups(NoPresence, cellPvtRegionIdx_, cells, noPresence);
+        groups.forEach([&](const unsigned pvtRegionIdx, bool, const int i) {
+            Eval pEval = po.value()[i];
+            const Eval TEval = 293.15; // temperature is not supported by this API!
+            pEval.setDerivative(0, 1.0);
 
             const Eval& RsEval = FluidSystem::oilPvt().saturatedGasDissolutionFactor(pvtRegionIdx, TEval, pEval);
 
             rbub[i] = RsEval.value();
             drbubdp[i] = RsEval.derivative(0);
-        }
+        });
 
-        ADB::M drbubdp_diag(drbubdp.matrix().asDiagonal());
-        const int num_blocks = po.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(drbubdp_diag, po.derivative()[block], jacs[block]);
-        }
-        return ADB::function(std::move(rbub), std::move(jacs));
+        return ADB::function(std::move(rbub), chainRule(drbubdp, po));
     }
 
     /// Bubble point curve for Rs as function of oil pressure.
@@ -699,28 +669,19 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         typedef Opm::DenseAd::Evaluation<double, /*size=*/1> Eval;
 
-        Eval pEval = 0.0;
-        Eval TEval = 293.15; // temperature is not supported by this API!
-
-        pEval.setDerivative(0, 1.0);
-
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pEval.setValue(pg.value()[i]);
+        const PvtCellGroups& groups = cellGroups(NoPresence, cellPvtRegionIdx_, cells, noPresence);
+        groups.forEach([&](const unsigned pvtRegionIdx, bool, const int i) {
+            Eval pEval = pg.value()[i];
+            const Eval TEval = 293.15; // temperature is not supported by this API!
+            pEval.setDerivative(0, 1.0);
 
             const Eval& RvEval = FluidSystem::gasPvt().saturatedOilVaporizationFactor(pvtRegionIdx, TEval, pEval);
 
             rv[i] = RvEval.value();
             drvdp[i] = RvEval.derivative(0);
-        }
+        });
 
-        ADB::M drvdp_diag(drvdp.matrix().asDiagonal());
-        const int num_blocks = pg.numBlocks();
-        std::vector<ADB::M> jacs(num_blocks);
-        for (int block = 0; block < num_blocks; ++block) {
-            fastSparseProduct(drvdp_diag, pg.derivative()[block], jacs[block]);
-        }
-        return ADB::function(std::move(rv), std::move(jacs));
+        return ADB::function(std::move(rv), chainRule(drvdp, pg));
     }
 
     /// Condensation curve for Rv as function of oil pressure.
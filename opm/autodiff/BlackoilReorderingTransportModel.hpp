@@ -27,6 +27,7 @@
 #include <opm/autodiff/multiPhaseUpwind.hpp>
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/core/transport/reorder/ComponentLevels.hpp>
 #include <opm/core/simulator/BlackoilState.hpp>
 
 #include <opm/autodiff/BlackoilTransportModel.hpp>
@@ -100,43 +101,20 @@ namespace Opm {
         {
         public:
             explicit ConnectivityGraph(const HelperOps& ops)
-                : grad_(ops.grad)
-                , div_(ops.div)
+                : graph_(ops.connections)
             {
-                grad_ia_ = grad_.outerIndexPtr();
-                grad_ja_ = grad_.innerIndexPtr();
-                grad_sign_ = grad_.valuePtr();
-                div_ia_ = div_.outerIndexPtr();
-                div_ja_ = div_.innerIndexPtr();
-                div_sign_ = div_.valuePtr();
             }
 
             Connections cellConnections(const int cell) const;
 
             std::array<int, 2> connectionCells(const int connection) const
             {
-                const int pos = div_ia_[connection];
-                assert(div_ia_[connection + 1] == pos + 2);
-                const double sign1 = div_sign_[pos];
-                assert(div_sign_[pos + 1] == -sign1);
-                if (sign1 > 0.0) {
-                    return {{ div_ja_[pos], div_ja_[pos + 1] }};
-                } else {
-                    return {{ div_ja_[pos + 1], div_ja_[pos] }};
-                 }
+                return graph_->cells(connection);
             }
 
         private:
             friend class Connections;
-            typedef HelperOps::M M;
-            const M& grad_;
-            const M& div_;
-            const int* grad_ia_;
-            const int* grad_ja_;
-            const double* grad_sign_;
-            const int* div_ia_;
-            const int* div_ja_;
-            const double* div_sign_;
+            std::shared_ptr<const ConnectionGraph> graph_;
         };
 
 
@@ -146,7 +124,7 @@ namespace Opm {
             Connections(const ConnectivityGraph& cg, const int cell) : cg_(cg), cell_(cell) {}
             int size() const
             {
-                return cg_.grad_ia_[cell_ + 1] - cg_.grad_ia_[cell_];
+                return cg_.graph_->cellEnd(cell_) - cg_.graph_->cellBegin(cell_);
             }
             class Iterator
             {
@@ -165,8 +143,10 @@ namespace Opm {
                 Connection operator*()
                 {
                     assert(index_ >= 0 && index_ < c_.size());
-                    const int pos = c_.cg_.grad_ia_[c_.cell_] + index_;
-                    return Connection(c_.cg_.grad_ja_[pos], -c_.cg_.grad_sign_[pos]); // Note the minus sign!
+                    const ConnectionGraph& graph = *c_.cg_.graph_;
+                    const int pos = graph.cellBegin(c_.cell_) + index_;
+                    // positive for the first cell of the connection
+                    return Connection(graph.connection(pos), graph.side(pos) == 0 ? 1.0 : -1.0);
                 }
             private:
                 const Connections& c_;
@@ -444,12 +424,15 @@ namespace Opm {
         V gas_wellflux_cell_;
         std::vector<int> sequence_;
         std::vector<int> components_;
+        ComponentLevels levels_;
         V trans_all_;
         V gdz_;
         DataBlock rhos_;
 
         std::array<double, 2> max_abs_dx_;
         std::array<int, 2> max_abs_dx_cell_;
+        // max abs dx of each cell, since the cells may be solved concurrently
+        std::vector<std::array<double, 2>> cell_max_abs_dx_;
 
         // TODO: remove this, for debug only.
         BlackoilTransportModel<Grid, WellModel> tr_model_;
@@ -598,6 +581,7 @@ namespace Opm {
             compute_sequence(&grid_, flux_on_all_faces.data(), sequence_.data(), components_.data(), &num_components);
             OpmLog::debug(std::string("Number of components: ") + std::to_string(num_components));
             components_.resize(num_components + 1); // resize to fit actually used part
+            levels_.compute(grid_, sequence_.data(), components_.data(), num_components);
         }
 
 
@@ -606,19 +590,32 @@ namespace Opm {
         void solveComponents()
         {
             // Zero the max changed.
+            cell_max_abs_dx_.assign(sequence_.size(), {{ 0.0, 0.0 }});
+
+            // Solve the equations. The components of a level of the upwind
+            // graph are independent and may be solved concurrently, which
+            // gives the same result as solving them in sequence.
+            levels_.forEachComponent([this](const int comp) {
+                    const int comp_size = components_[comp + 1] - components_[comp];
+                    if (comp_size == 1) {
+                        solveSingleCell(sequence_[components_[comp]]);
+                    } else {
+                        solveMultiCell(comp_size, &sequence_[components_[comp]]);
+                    }
+                });
+
+            // Find the max change, reporting the first cell of the sequence
+            // with it, as when the cells are solved in sequence.
             max_abs_dx_[0] = 0.0;
             max_abs_dx_[1] = 0.0;
             max_abs_dx_cell_[0] = -1;
             max_abs_dx_cell_[1] = -1;
-
-            // Solve the equations.
-            const int num_components = components_.size() - 1;
-            for (int comp = 0; comp < num_components; ++comp) {
-                const int comp_size = components_[comp + 1] - components_[comp];
-                if (comp_size == 1) {
-                    solveSingleCell(sequence_[components_[comp]]);
-                } else {
-                    solveMultiCell(comp_size, &sequence_[components_[comp]]);
+            for (const int cell : sequence_) {
+                for (int ii = 0; ii < 2; ++ii) {
+                    if (cell_max_abs_dx_[cell][ii] > max_abs_dx_[ii]) {
+                        max_abs_dx_[ii] = cell_max_abs_dx_[cell][ii];
+                        max_abs_dx_cell_[ii] = cell;
+                    }
                 }
             }
 
@@ -681,6 +678,9 @@ namespace Opm {
                 os << "Failed to converge in cell " << cell << ", residual = " << res
                    << ", cell values { s = ( " << cstate_[cell].s[Water] << ", " << cstate_[cell].s[Oil] << ", " << cstate_[cell].s[Gas]
                    << " ), rs = " << cstate_[cell].rs << ", rv = " << cstate_[cell].rv << " }";
+#if HAVE_OPENMP
+#pragma omp critical(BlackoilReorderingTransportModel_log)
+#endif // HAVE_OPENMP
                 OpmLog::debug(os.str());
             }
         }
@@ -860,14 +860,9 @@ namespace Opm {
         void updateState(const int cell,
                          const Vec2& dx)
         {
-            if (std::fabs(dx[0]) > max_abs_dx_[0]) {
-                max_abs_dx_cell_[0] = cell;
-            }
-            if (std::fabs(dx[1]) > max_abs_dx_[1]) {
-                max_abs_dx_cell_[1] = cell;
-            }
-            max_abs_dx_[0] = std::max(max_abs_dx_[0], std::fabs(dx[0]));
-            max_abs_dx_[1] = std::max(max_abs_dx_[1], std::fabs(dx[1]));
+            auto& max_abs_dx = cell_max_abs_dx_[cell];
+            max_abs_dx[0] = std::max(max_abs_dx[0], std::fabs(dx[0]));
+            max_abs_dx[1] = std::max(max_abs_dx[1], std::fabs(dx[1]));
 
             // Get saturation updates.
             const double dsw = dx[0];
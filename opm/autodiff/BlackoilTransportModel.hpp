@@ -22,6 +22,7 @@
 #define OPM_BLACKOILTRANSPORTMODEL_HEADER_INCLUDED
 
 #include <opm/autodiff/BlackoilModelBase.hpp>
+#include <opm/autodiff/AutoDiffProduct.hpp>
 #include <opm/core/simulator/BlackoilState.hpp>
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/autodiff/BlackoilModelParameters.hpp>
@@ -343,7 +344,8 @@ namespace Opm {
                         gflux += mob[other_phase] * (dh_sat[phase_idx] - dh_sat[other_phase]);
                     }
                 }
-                sd_.rq[phase_idx].mflux = b[phase_idx] * (mob[phase_idx] / tot_mob) * (total_flux_ + trans_all * gflux);
+                sd_.rq[phase_idx].mflux = fusedProduct(b[phase_idx]) * mob[phase_idx] / tot_mob
+                    * (total_flux_ + trans_all * gflux);
             }
 
 #pragma omp parallel for schedule(static)
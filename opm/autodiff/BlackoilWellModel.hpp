@@ -29,10 +29,15 @@
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <exception>
 #include <tuple>
+#include <unordered_map>
 
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Events.hpp>
 
 #include <opm/core/wells.h>
 #include <opm/core/wells/DynamicListEconLimited.hpp>
@@ -57,6 +62,8 @@
 #include <opm/material/densead/Math.hpp>
 
 #include <opm/simulators/WellSwitchingLogger.hpp>
+#include <opm/simulators/BatchedAllReduce.hpp>
+#include <opm/simulators/Tracer.hpp>
 
 
 namespace Opm {
@@ -117,6 +124,9 @@ namespace Opm {
             // apply well model with scaling of alpha
             void applyScaleAdd(const Scalar alpha, const BVector& x, BVector& Ax) const;
 
+            // write the well equation blocks of all local wells to a snapshot
+            void writeSystemSnapshot(LinearSystemSnapshotWriter& writer) const;
+
             // using the solution x to recover the solution xw for wells and applying
             // xw to update Well State
             void recoverWellSolutionAndUpdateWellState(const BVector& x);
@@ -144,9 +154,13 @@ namespace Opm {
             // called at the end of a time step
             void timeStepSucceeded();
 
-            // called at the beginning of a report step
+            // called at the beginning of a report step. The wells are only
+            // rebuilt if the schedule or the economic limits changed them.
             void beginReportStep(const int time_step);
 
+            // whether the last call to beginReportStep() reused the wells
+            bool wellsReused() const { return wells_reused_; }
+
             // called at the end of a report step
             void endReportStep();
 
@@ -177,8 +191,28 @@ namespace Opm {
             // create the well container
             std::vector<WellInterfacePtr > createWellContainer(const int time_step) const;
 
+            // indices into well_container_ grouped by color, wells of the same
+            // color do not share any perforated cell
+            std::vector<std::vector<int> > well_colors_;
+
+            // greedy coloring of the wells in well_container_ based on their perforated cells
+            void computeWellColoring();
+
+            // whether the wells of the previous report step can be kept for time_step
+            bool canReuseWells(const int time_step) const;
+
+            // move the kept wells to time_step
+            void reuseWells(const int time_step);
+
+            // call f for every well. With OpenMP the wells of one color are
+            // handled concurrently, the colors one after the other.
+            template <class Function>
+            void forEachWellColored(const Function& f) const;
+
             WellState well_state_;
             WellState previous_well_state_;
+            // true while well_state_ is identical to previous_well_state_
+            bool well_state_is_previous_;
 
             const ModelParameters param_;
             bool terminal_output_;
@@ -194,6 +228,9 @@ namespace Opm {
             bool initial_step_;
 
             DynamicListEconLimited dynamic_list_econ_limited_;
+            // true if wells or connections were closed at the last report step
+            bool econ_limited_changed_;
+            bool wells_reused_;
             std::unique_ptr<RateConverterType> rateConverter_;
             std::unique_ptr<VFPProperties> vfp_properties_;
 
@@ -10,6 +10,7 @@ namespace Opm {
                       const ModelParameters& param,
                       const bool terminal_output)
         : ebosSimulator_(ebosSimulator)
+        , well_state_is_previous_(false)
         , param_(param)
         , terminal_output_(terminal_output)
         , has_solvent_(GET_PROP_VALUE(TypeTag, EnableSolvent))
@@ -30,6 +31,8 @@ namespace Opm {
         extractLegacyCellPvtRegionIndex_();
         extractLegacyDepth_();
         initial_step_ = true;
+        econ_limited_changed_ = false;
+        wells_reused_ = false;
     }
 
 
@@ -39,11 +42,18 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     beginReportStep(const int timeStepIdx)
     {
+        OPM_TRACE_SCOPE("BlackoilWellModel::beginReportStep");
         const Grid& grid = ebosSimulator_.vanguard().grid();
         const auto& defunct_well_names = ebosSimulator_.vanguard().defunctWellNames();
         const auto& eclState = ebosSimulator_.vanguard().eclState();
         wells_ecl_ = schedule().getWells(timeStepIdx);
 
+        wells_reused_ = canReuseWells(timeStepIdx);
+        if (wells_reused_) {
+            reuseWells(timeStepIdx);
+            return;
+        }
+
         // Create wells and well state.
         wells_manager_.reset( new WellsManager (eclState,
                                                 schedule(),
@@ -110,6 +120,7 @@ namespace Opm {
 
         // create the well container
         well_container_ = createWellContainer(timeStepIdx);
+        computeWellColoring();
 
         // do the initialization for all the wells
         // TODO: to see whether we can postpone of the intialization of the well containers to
@@ -139,6 +150,7 @@ namespace Opm {
 
         // update the previous well state. This is used to restart failed steps.
         previous_well_state_ = well_state_;
+        well_state_is_previous_ = true;
 
 
     }
@@ -149,7 +161,12 @@ namespace Opm {
     void
     BlackoilWellModel<TypeTag>::
     beginTimeStep() {
-        well_state_ = previous_well_state_;
+        OPM_TRACE_SCOPE("BlackoilWellModel::beginTimeStep");
+        // the well state only needs to be reset after a failed time step
+        if (!well_state_is_previous_) {
+            well_state_ = previous_well_state_;
+            well_state_is_previous_ = true;
+        }
 
         if (wellCollection().havingVREPGroups() ) {
             rateConverter_->template defineState<ElementContext>(ebosSimulator_);
@@ -161,7 +178,11 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    setRestartWellState(const WellState& well_state) { previous_well_state_ = well_state; }
+    setRestartWellState(const WellState& well_state)
+    {
+        previous_well_state_ = well_state;
+        well_state_is_previous_ = false;
+    }
 
     // called at the end of a report step
     template<typename TypeTag>
@@ -171,7 +192,66 @@ namespace Opm {
         // update the list contanining information of closed wells
         // and connections due to economical limits
         // Used by the wellManager
+        const std::size_t num_econ_limited = dynamic_list_econ_limited_.size();
         updateListEconLimited(dynamic_list_econ_limited_);
+
+        // the wells have to be rebuilt on all processes if any of them closed a well
+        int changed = dynamic_list_econ_limited_.size() != num_econ_limited ? 1 : 0;
+        changed = ebosSimulator_.vanguard().grid().comm().max(changed);
+        econ_limited_changed_ = changed > 0;
+    }
+
+
+
+    template<typename TypeTag>
+    bool
+    BlackoilWellModel<TypeTag>::
+    canReuseWells(const int timeStepIdx) const
+    {
+        if (!wells_manager_ || econ_limited_changed_) {
+            return false;
+        }
+
+        // any schedule event may add wells or modify the wells, their
+        // completions, controls or groups
+        const uint64_t all_events = ~uint64_t(0);
+        if (schedule().getEvents().hasEvent(all_events, timeStepIdx)) {
+            return false;
+        }
+
+        // the group controls keep a state which is reset by rebuilding the wells
+        return !wellCollection().groupControlActive() && !wellCollection().havingVREPGroups();
+    }
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    reuseWells(const int timeStepIdx)
+    {
+        // the well state of the last time step is kept, only the schedule
+        // dependent quantities are updated
+        computeRESV(timeStepIdx);
+
+        for (auto& well : well_container_) {
+            well->setReportStep(timeStepIdx);
+        }
+
+        calculateEfficiencyFactors();
+
+        vfp_properties_.reset (new VFPProperties (
+                                   schedule().getVFPInjTables(timeStepIdx),
+                                   schedule().getVFPProdTables(timeStepIdx)) );
+
+        for (auto& well : well_container_) {
+            well->setVFPProperties(vfp_properties_.get());
+        }
+
+        if (!well_state_is_previous_) {
+            previous_well_state_ = well_state_;
+            well_state_is_previous_ = true;
+        }
     }
 
     // called at the end of a report step
@@ -192,6 +272,7 @@ namespace Opm {
         }
 
         previous_well_state_ = well_state_;
+        well_state_is_previous_ = true;
     }
 
     template<typename TypeTag>
@@ -253,10 +334,13 @@ namespace Opm {
     assemble(const int iterationIdx,
              const double dt)
     {
-
+        OPM_TRACE_SCOPE("BlackoilWellModel::assemble");
 
         last_report_ = SimulatorReport();
 
+        // the well state is modified by the assembly
+        well_state_is_previous_ = false;
+
         if ( ! wellsActive() ) {
             return;
         }
@@ -299,14 +383,96 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    assembleWellEq(const double dt,
-                   bool only_wells)
+    computeWellColoring()
     {
+        well_colors_.clear();
+
+        // the colors already used by wells perforating a cell
+        std::unordered_map<int, std::vector<int> > cell_colors;
+        std::vector<bool> forbidden;
+
         for (int w = 0; w < numWells(); ++w) {
-            well_container_[w]->assembleWellEq(ebosSimulator_, dt, well_state_, only_wells);
+            const auto& cells = well_container_[w]->cells();
+
+            forbidden.assign(well_colors_.size(), false);
+            for (const int cell : cells) {
+                const auto it = cell_colors.find(cell);
+                if (it != cell_colors.end()) {
+                    for (const int color : it->second) {
+                        forbidden[color] = true;
+                    }
+                }
+            }
+
+            const int color = std::find(forbidden.begin(), forbidden.end(), false) - forbidden.begin();
+            if (color == int(well_colors_.size())) {
+                well_colors_.emplace_back();
+            }
+            well_colors_[color].push_back(w);
+
+            for (const int cell : cells) {
+                auto& colors = cell_colors[cell];
+                if (std::find(colors.begin(), colors.end(), color) == colors.end()) {
+                    colors.push_back(color);
+                }
+            }
         }
     }
 
+
+
+
+
+    template<typename TypeTag>
+    template<class Function>
+    void
+    BlackoilWellModel<TypeTag>::
+    forEachWellColored(const Function& f) const
+    {
+#if HAVE_OPENMP
+        for (const auto& wells_of_color : well_colors_) {
+            const int nw = wells_of_color.size();
+            // exceptions must not leave the parallel region
+            std::exception_ptr exc;
+#pragma omp parallel for schedule(dynamic) if(nw > 1)
+            for (int i = 0; i < nw; ++i) {
+                try {
+                    f(*well_container_[wells_of_color[i]]);
+                }
+                catch (...) {
+#pragma omp critical(BlackoilWellModel_forEachWellColored)
+                    if (!exc) {
+                        exc = std::current_exception();
+                    }
+                }
+            }
+            if (exc) {
+                std::rethrow_exception(exc);
+            }
+        }
+#else
+        for (const auto& well : well_container_) {
+            f(*well);
+        }
+#endif // HAVE_OPENMP
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    assembleWellEq(const double dt,
+                   bool only_wells)
+    {
+        OPM_TRACE_SCOPE("BlackoilWellModel::assembleWellEq");
+        forEachWellColored([&](WellInterface<TypeTag>& well) {
+            well.assembleWellEq(ebosSimulator_, dt, well_state_, only_wells);
+        });
+    }
+
     // applying the well residual to reservoir residuals
     // r = r - duneC_^T * invDuneD_ * resWell_
     template<typename TypeTag>
@@ -318,9 +484,9 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(r);
-        }
+        forEachWellColored([&](const WellInterface<TypeTag>& well) {
+            well.apply(r);
+        });
     }
 
 
@@ -333,14 +499,15 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     apply(const BVector& x, BVector& Ax) const
     {
+        OPM_TRACE_SCOPE("BlackoilWellModel::apply");
         // TODO: do we still need localWellsActive()?
         if ( ! localWellsActive() ) {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(x, Ax);
-        }
+        forEachWellColored([&](const WellInterface<TypeTag>& well) {
+            well.apply(x, Ax);
+        });
     }
 
 
@@ -372,17 +539,36 @@ namespace Opm {
 
 
 
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    writeSystemSnapshot(LinearSystemSnapshotWriter& writer) const
+    {
+        if ( ! localWellsActive() ) {
+            return;
+        }
+
+        for (const auto& well : well_container_) {
+            well->writeSystemSnapshot(writer);
+        }
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
     recoverWellSolutionAndUpdateWellState(const BVector& x)
     {
+        OPM_TRACE_SCOPE("BlackoilWellModel::recoverWellSolution");
         if (!localWellsActive())
             return;
 
-        for (auto& well : well_container_) {
-            well->recoverWellSolutionAndUpdateWellState(x, well_state_);
-        }
+        forEachWellColored([&](const WellInterface<TypeTag>& well) {
+            well.recoverWellSolutionAndUpdateWellState(x, well_state_);
+        });
     }
 
 
@@ -462,6 +648,7 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     solveWellEq(const double dt)
     {
+        OPM_TRACE_SCOPE("BlackoilWellModel::solveWellEq");
         const int nw = numWells();
         WellState well_state0 = well_state_;
 
@@ -537,19 +724,24 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     getWellConvergence(const std::vector<Scalar>& B_avg) const
     {
+        OPM_TRACE_SCOPE("BlackoilWellModel::getWellConvergence");
         ConvergenceReport report;
 
         for (const auto& well : well_container_) {
             report += well->getWellConvergence(B_avg);
         }
 
+        // the three flags are communicated in a single collective
+        const auto& grid = ebosSimulator_.vanguard().grid();
+        BatchedAllReduce reduction(grid.comm());
+        const auto nanHandle = reduction.max(report.nan_residual_found ? 1.0 : 0.0);
+        const auto tooLargeHandle = reduction.max(report.too_large_residual_found ? 1.0 : 0.0);
+        const auto convergedHandle = reduction.min(report.converged ? 1.0 : 0.0);
+        reduction.execute();
+
         // checking NaN residuals
         {
-            bool nan_residual_found = report.nan_residual_found;
-            const auto& grid = ebosSimulator_.vanguard().grid();
-            int value = nan_residual_found ? 1 : 0;
-
-            nan_residual_found = grid.comm().max(value);
+            const bool nan_residual_found = reduction[nanHandle] > 0.0;
 
             if (nan_residual_found) {
                 for (const auto& well : report.nan_residual_wells) {
@@ -561,11 +753,8 @@ namespace Opm {
 
         // checking too large residuals
         {
-            bool too_large_residual_found = report.too_large_residual_found;
-            const auto& grid = ebosSimulator_.vanguard().grid();
-            int value = too_large_residual_found ? 1 : 0;
+            const bool too_large_residual_found = reduction[tooLargeHandle] > 0.0;
 
-            too_large_residual_found = grid.comm().max(value);
             if (too_large_residual_found) {
                 for (const auto& well : report.too_large_residual_wells) {
                     OpmLog::debug("Too large residual found with phase " + well.phase_name + " fow well " + well.well_name);
@@ -575,13 +764,7 @@ namespace Opm {
         }
 
         // checking convergence
-        bool converged_well = report.converged;
-        {
-            const auto& grid = ebosSimulator_.vanguard().grid();
-            int value = converged_well ? 1 : 0;
-
-            converged_well = grid.comm().min(value);
-        }
+        const bool converged_well = reduction[convergedHandle] > 0.0;
 
         return converged_well;
     }
@@ -609,6 +792,7 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     updateWellControls()
     {
+        OPM_TRACE_SCOPE("BlackoilWellModel::updateWellControls");
         // Even if there no wells active locally, we cannot
         // return as the Destructor of the WellSwitchingLogger
         // uses global communication. For no well active globally
@@ -647,6 +831,7 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     computeWellPotentials(std::vector<double>& well_potentials)
     {
+        OPM_TRACE_SCOPE("BlackoilWellModel::computeWellPotentials");
         // number of wells and phases
         const int nw = numWells();
         const int np = numPhases();
@@ -69,6 +69,17 @@ struct CPRParameter
     bool cpr_use_bicgstab_;
     bool cpr_solver_verbose_;
     bool cpr_pressure_aggregation_;
+    // 0: new setup of the CPR preconditioner for every linear solve,
+    // 1: keep the aggregates and sparsity patterns and only recompute the values,
+    // 2: reuse the whole preconditioner without any recomputation.
+    int cpr_reuse_setup_;
+    // With cpr_reuse_setup_ > 0 a new setup is done for the first linear solve of a
+    // time step (if cpr_setup_each_timestep_), after cpr_max_reuse_ linear solves
+    // (if > 0) and when the last linear solve needed more than
+    // cpr_reuse_iteration_threshold_ iterations (if > 0).
+    bool cpr_setup_each_timestep_;
+    int cpr_max_reuse_;
+    int cpr_reuse_iteration_threshold_;
 
     CPRParameter() { reset(); }
 
@@ -85,6 +96,10 @@ struct CPRParameter
         cpr_use_bicgstab_   = param.getDefault("cpr_use_bicgstab", cpr_use_bicgstab_);
         cpr_solver_verbose_ = param.getDefault("cpr_solver_verbose", cpr_solver_verbose_);
         cpr_pressure_aggregation_ = param.getDefault("cpr_pressure_aggregation", cpr_pressure_aggregation_);
+        cpr_reuse_setup_    = param.getDefault("cpr_reuse_setup", cpr_reuse_setup_);
+        cpr_setup_each_timestep_ = param.getDefault("cpr_setup_each_timestep", cpr_setup_each_timestep_);
+        cpr_max_reuse_      = param.getDefault("cpr_max_reuse", cpr_max_reuse_);
+        cpr_reuse_iteration_threshold_ = param.getDefault("cpr_reuse_iteration_threshold", cpr_reuse_iteration_threshold_);
     }
 
     void reset()
@@ -97,6 +112,10 @@ struct CPRParameter
         cpr_use_bicgstab_   = true;
         cpr_solver_verbose_ = false;
         cpr_pressure_aggregation_ = false;
+        cpr_reuse_setup_    = 0;
+        cpr_setup_each_timestep_ = true;
+        cpr_max_reuse_      = 0;
+        cpr_reuse_iteration_threshold_ = 0;
     }
 };
 
@@ -0,0 +1,364 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/autodiff/ConnectionOperator.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
+namespace Opm
+{
+
+    namespace
+    {
+        typedef AutoDiffMatrix::SparseRep SparseRep;
+        typedef std::vector<std::pair<int, double>> Column;
+
+        // The number of contiguous ranges of columns the products are
+        // formed in, one per thread unless there are few columns.
+        int numChunks(const int cols)
+        {
+#if HAVE_OPENMP
+            return std::max(1, std::min(omp_get_max_threads(), cols / 1024));
+#else
+            static_cast<void>(cols);
+            return 1;
+#endif // HAVE_OPENMP
+        }
+
+        /// The product of an operator with the sparse matrix J, formed
+        /// column by column: the nonzero v at (i, k) of J adds w * v at
+        /// (o, k) of the product for each (o, w) that adjacent(i, v, column)
+        /// appends to the column. Entries of the same row are summed.
+        template <class Adjacent>
+        SparseRep applyColumns(const int rows, const SparseRep& J, const Adjacent& adjacent)
+        {
+            const int cols = J.cols();
+            const int num_chunks = numChunks(cols);
+            std::vector<int> outer(cols + 1, 0);
+            std::vector<std::vector<int>> chunk_inner(num_chunks);
+            std::vector<std::vector<double>> chunk_values(num_chunks);
+
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (int chunk = 0; chunk < num_chunks; ++chunk) {
+                const int begin = static_cast<long>(cols) * chunk / num_chunks;
+                const int end = static_cast<long>(cols) * (chunk + 1) / num_chunks;
+                std::vector<int>& inner = chunk_inner[chunk];
+                std::vector<double>& values = chunk_values[chunk];
+                Column column;
+                for (int k = begin; k < end; ++k) {
+                    column.clear();
+                    for (SparseRep::InnerIterator it(J, k); it; ++it) {
+                        adjacent(it.index(), it.value(), column);
+                    }
+                    std::sort(column.begin(), column.end(),
+                              [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                                  return a.first < b.first;
+                              });
+                    const int start = inner.size();
+                    for (const auto& entry : column) {
+                        if (int(inner.size()) > start && inner.back() == entry.first) {
+                            values.back() += entry.second;
+                        } else {
+                            inner.push_back(entry.first);
+                            values.push_back(entry.second);
+                        }
+                    }
+                    outer[k + 1] = inner.size() - start;
+                }
+            }
+
+            for (int k = 0; k < cols; ++k) {
+                outer[k + 1] += outer[k];
+            }
+            SparseRep product(rows, cols);
+            product.resizeNonZeros(outer[cols]);
+            std::copy(outer.begin(), outer.end(), product.outerIndexPtr());
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (int chunk = 0; chunk < num_chunks; ++chunk) {
+                const int begin = static_cast<long>(cols) * chunk / num_chunks;
+                std::copy(chunk_inner[chunk].begin(), chunk_inner[chunk].end(),
+                          product.innerIndexPtr() + outer[begin]);
+                std::copy(chunk_values[chunk].begin(), chunk_values[chunk].end(),
+                          product.valuePtr() + outer[begin]);
+            }
+            return product;
+        }
+    } // anonymous namespace
+
+
+
+    // ---------------- ConnectionGraph ----------------
+
+    ConnectionGraph::ConnectionGraph(const int num_cells, std::vector<std::array<int, 2>>&& connection_cells)
+        : num_cells_(num_cells),
+          connection_cells_(std::move(connection_cells)),
+          cell_start_(num_cells + 1, 0)
+    {
+        // Counting sort of the connections by cell, which keeps the
+        // connections of each cell in increasing order.
+        const int num_connections = connection_cells_.size();
+        for (const auto& cells : connection_cells_) {
+            for (const int cell : cells) {
+                if (cell >= 0) {
+                    ++cell_start_[cell + 1];
+                }
+            }
+        }
+        for (int cell = 0; cell < num_cells_; ++cell) {
+            cell_start_[cell + 1] += cell_start_[cell];
+        }
+        cell_connections_.resize(cell_start_[num_cells_]);
+        std::vector<int> pos(cell_start_.begin(), cell_start_.end() - 1);
+        for (int conn = 0; conn < num_connections; ++conn) {
+            for (int side = 0; side < 2; ++side) {
+                const int cell = connection_cells_[conn][side];
+                if (cell >= 0) {
+                    cell_connections_[pos[cell]++] = 2 * conn + side;
+                }
+            }
+        }
+    }
+
+
+
+    // ---------------- ConnectionOperator ----------------
+
+    ConnectionOperator::ConnectionOperator()
+        : graph_(),
+          weight_{{ 0.0, 0.0 }},
+          transposed_(false)
+    {
+    }
+
+
+
+    ConnectionOperator::ConnectionOperator(std::shared_ptr<const ConnectionGraph> graph,
+                                           const double w0, const double w1)
+        : graph_(std::move(graph)),
+          weight_{{ w0, w1 }},
+          transposed_(false)
+    {
+    }
+
+
+
+    ConnectionOperator ConnectionOperator::transpose() const
+    {
+        ConnectionOperator transposed(*this);
+        transposed.transposed_ = !transposed_;
+        return transposed;
+    }
+
+
+
+    int ConnectionOperator::rows() const
+    {
+        if (!graph_) {
+            return 0;
+        }
+        return transposed_ ? graph_->numCells() : graph_->numConnections();
+    }
+
+
+
+    int ConnectionOperator::cols() const
+    {
+        if (!graph_) {
+            return 0;
+        }
+        return transposed_ ? graph_->numConnections() : graph_->numCells();
+    }
+
+
+
+    Eigen::VectorXd ConnectionOperator::operator*(const Eigen::VectorXd& x) const
+    {
+        assert(x.size() == cols());
+        Eigen::VectorXd y(rows());
+        apply(x.data(), y.data());
+        return y;
+    }
+
+
+
+    ConnectionOperator::ADB ConnectionOperator::operator*(const ADB& x) const
+    {
+        assert(x.value().size() == cols());
+        ADB::V y(rows());
+        apply(x.value().data(), y.data());
+        const int num_blocks = x.numBlocks();
+        std::vector<ADB::M> jac(num_blocks);
+        for (int block = 0; block < num_blocks; ++block) {
+            jac[block] = apply(x.derivative()[block]);
+        }
+        return ADB::function(std::move(y), std::move(jac));
+    }
+
+
+
+    Eigen::SparseMatrix<double> ConnectionOperator::sparse() const
+    {
+        SparseRep identity(cols(), cols());
+        identity.setIdentity();
+        return apply(AutoDiffMatrix(std::move(identity))).getSparse();
+    }
+
+
+
+    void ConnectionOperator::apply(const double* x, double* y) const
+    {
+        const ConnectionGraph& graph = *graph_;
+        const int n = rows();
+        if (transposed_) {
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (int cell = 0; cell < n; ++cell) {
+                double sum = 0.0;
+                for (int pos = graph.cellBegin(cell); pos < graph.cellEnd(cell); ++pos) {
+                    sum += weight_[graph.side(pos)] * x[graph.connection(pos)];
+                }
+                y[cell] = sum;
+            }
+        } else {
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (int conn = 0; conn < n; ++conn) {
+                const std::array<int, 2>& cells = graph.cells(conn);
+                double value = 0.0;
+                for (int side = 0; side < 2; ++side) {
+                    if (cells[side] >= 0) {
+                        value += weight_[side] * x[cells[side]];
+                    }
+                }
+                y[conn] = value;
+            }
+        }
+    }
+
+
+
+    AutoDiffMatrix ConnectionOperator::apply(const AutoDiffMatrix& jac) const
+    {
+        assert(jac.rows() == cols());
+        if (jac.nonZeros() == 0) {
+            return AutoDiffMatrix(rows(), jac.cols());
+        }
+        const ConnectionGraph& graph = *graph_;
+        const std::array<double, 2>& weight = weight_;
+        if (transposed_) {
+            // row conn of jac goes to the cells of the connection
+            return AutoDiffMatrix(applyColumns(rows(), jac.getSparse(),
+                [&graph, &weight](const int conn, const double value, Column& column) {
+                    const std::array<int, 2>& cells = graph.cells(conn);
+                    for (int side = 0; side < 2; ++side) {
+                        if (cells[side] >= 0) {
+                            column.emplace_back(cells[side], weight[side] * value);
+                        }
+                    }
+                }));
+        } else {
+            // row cell of jac goes to the connections of the cell
+            return AutoDiffMatrix(applyColumns(rows(), jac.getSparse(),
+                [&graph, &weight](const int cell, const double value, Column& column) {
+                    for (int pos = graph.cellBegin(cell); pos < graph.cellEnd(cell); ++pos) {
+                        column.emplace_back(graph.connection(pos), weight[graph.side(pos)] * value);
+                    }
+                }));
+        }
+    }
+
+
+
+    // ---------------- ConnectionSelector ----------------
+
+    ConnectionSelector::ConnectionSelector(std::shared_ptr<const ConnectionGraph> graph, const ADB::V& flux)
+        : graph_(std::move(graph)),
+          selected_(graph_->numConnections())
+    {
+        assert(flux.size() == graph_->numConnections());
+        const int num_connections = selected_.size();
+        for (int conn = 0; conn < num_connections; ++conn) {
+            selected_[conn] = graph_->cells(conn)[flux[conn] >= 0.0 ? 0 : 1];
+            assert(selected_[conn] >= 0);
+        }
+    }
+
+
+
+    ConnectionSelector::ADB::V ConnectionSelector::operator*(const ADB::V& x) const
+    {
+        assert(x.size() == graph_->numCells());
+        const int num_connections = selected_.size();
+        ADB::V y(num_connections);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for (int conn = 0; conn < num_connections; ++conn) {
+            y[conn] = x[selected_[conn]];
+        }
+        return y;
+    }
+
+
+
+    ConnectionSelector::ADB ConnectionSelector::operator*(const ADB& x) const
+    {
+        ADB::V y = (*this) * x.value();
+        const int num_blocks = x.numBlocks();
+        std::vector<ADB::M> jac(num_blocks);
+        for (int block = 0; block < num_blocks; ++block) {
+            jac[block] = apply(x.derivative()[block]);
+        }
+        return ADB::function(std::move(y), std::move(jac));
+    }
+
+
+
+    AutoDiffMatrix ConnectionSelector::apply(const AutoDiffMatrix& jac) const
+    {
+        assert(jac.rows() == graph_->numCells());
+        const int num_connections = selected_.size();
+        if (jac.nonZeros() == 0) {
+            return AutoDiffMatrix(num_connections, jac.cols());
+        }
+        // row cell of jac goes to the connections that select the cell
+        const ConnectionGraph& graph = *graph_;
+        const std::vector<int>& selected = selected_;
+        return AutoDiffMatrix(applyColumns(num_connections, jac.getSparse(),
+            [&graph, &selected](const int cell, const double value, Column& column) {
+                for (int pos = graph.cellBegin(cell); pos < graph.cellEnd(cell); ++pos) {
+                    const int conn = graph.connection(pos);
+                    if (selected[conn] == cell) {
+                        column.emplace_back(conn, value);
+                    }
+                }
+            }));
+    }
+
+} // namespace Opm
@@ -0,0 +1,130 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CONNECTIONOPERATOR_HEADER_INCLUDED
+#define OPM_CONNECTIONOPERATOR_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The two cells of each connection (face or non-neighbouring
+    /// connection) of a grid, and the connections of each cell.
+    class ConnectionGraph
+    {
+    public:
+        /// \param[in] num_cells         number of cells
+        /// \param[in] connection_cells  the cells of each connection, -1 for
+        ///                              the outside of a boundary face
+        ConnectionGraph(const int num_cells, std::vector<std::array<int, 2>>&& connection_cells);
+
+        int numCells() const { return num_cells_; }
+        int numConnections() const { return connection_cells_.size(); }
+
+        /// The cells of a connection.
+        const std::array<int, 2>& cells(const int connection) const
+        {
+            return connection_cells_[connection];
+        }
+
+        /// The connections of a cell are at the positions [cellBegin(cell),
+        /// cellEnd(cell)), in increasing order.
+        int cellBegin(const int cell) const { return cell_start_[cell]; }
+        int cellEnd(const int cell) const { return cell_start_[cell + 1]; }
+
+        /// The connection at a position.
+        int connection(const int pos) const { return cell_connections_[pos] / 2; }
+
+        /// The side of the connection the cell at a position is on, 0 if it
+        /// is the first cell of the connection, 1 if it is the second.
+        int side(const int pos) const { return cell_connections_[pos] % 2; }
+
+    private:
+        int num_cells_;
+        std::vector<std::array<int, 2>> connection_cells_;
+        std::vector<int> cell_start_;
+        // 2 * connection + side
+        std::vector<int> cell_connections_;
+    };
+
+
+
+    /// A two-point operator from cell values to connection values,
+    ///     y[conn] = w0 * x[first cell] + w1 * x[second cell],
+    /// or its transpose, from connection values to cell values. They are
+    /// applied by looping over the connections of the graph, to values as
+    /// well as to the jacobians of AutoDiffBlocks, without forming the
+    /// operator matrix.
+    class ConnectionOperator
+    {
+    public:
+        typedef AutoDiffBlock<double> ADB;
+
+        ConnectionOperator();
+        ConnectionOperator(std::shared_ptr<const ConnectionGraph> graph, const double w0, const double w1);
+
+        /// The transposed operator.
+        ConnectionOperator transpose() const;
+
+        int rows() const;
+        int cols() const;
+
+        Eigen::VectorXd operator*(const Eigen::VectorXd& x) const;
+        ADB operator*(const ADB& x) const;
+
+        /// The operator as a sparse matrix.
+        Eigen::SparseMatrix<double> sparse() const;
+
+    private:
+        AutoDiffMatrix apply(const AutoDiffMatrix& jac) const;
+        void apply(const double* x, double* y) const;
+
+        std::shared_ptr<const ConnectionGraph> graph_;
+        std::array<double, 2> weight_;
+        bool transposed_;
+    };
+
+
+
+    /// Selects for each connection the value of one of its cells, the first
+    /// cell if the flux of the connection is nonnegative, the second cell
+    /// otherwise.
+    class ConnectionSelector
+    {
+    public:
+        typedef AutoDiffBlock<double> ADB;
+
+        ConnectionSelector(std::shared_ptr<const ConnectionGraph> graph, const ADB::V& flux);
+
+        ADB::V operator*(const ADB::V& x) const;
+        ADB operator*(const ADB& x) const;
+
+    private:
+        AutoDiffMatrix apply(const AutoDiffMatrix& jac) const;
+
+        std::shared_ptr<const ConnectionGraph> graph_;
+        std::vector<int> selected_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_CONNECTIONOPERATOR_HEADER_INCLUDED
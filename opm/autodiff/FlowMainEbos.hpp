@@ -27,6 +27,7 @@
 #include <sys/utsname.h>
 
 #include <opm/simulators/ParallelFileMerger.hpp>
+#include <opm/simulators/Tracer.hpp>
 
 #include <opm/autodiff/BlackoilModelEbos.hpp>
 #include <opm/autodiff/NewtonIterationBlackoilSimple.hpp>
@@ -114,6 +115,10 @@ namespace Opm
                 // Run.
                 auto ret =  runSimulator();
 
+#if OPM_ENABLE_TRACING
+                Tracer::instance().writeChromeTrace(traceFile_);
+#endif // OPM_ENABLE_TRACING
+
                 mergeParallelLogFiles();
 
                 return ret;
@@ -154,6 +159,12 @@ namespace Opm
             output_cout_ = ( mpi_rank_ == 0 );
             must_distribute_ = ( mpi_size > 1 );
 
+#if OPM_ENABLE_TRACING
+            // start the trace clocks of all processes at the same time
+            Dune::MPIHelper::getCollectiveCommunication().barrier();
+            Tracer::instance();
+#endif // OPM_ENABLE_TRACING
+
 #ifdef _OPENMP
             // OpenMP setup.
             if (!getenv("OMP_NUM_THREADS")) {
@@ -275,6 +286,7 @@ namespace Opm
 
             const std::string& output_dir = eclState().getIOConfig().getOutputDir();
             logFileStream << output_dir << "/" << baseName;
+            traceFile_ = output_dir + "/" + baseName + ".TRACE.json";
             debugFileStream << output_dir << "/" << "." << baseName;
 
             if ( must_distribute_ && mpi_rank_ != 0 )
@@ -498,6 +510,7 @@ namespace Opm
         // Returns EXIT_SUCCESS if it does not throw.
         int runSimulator()
         {
+            OPM_TRACE_SCOPE("FlowMainEbos::runSimulator");
             const auto& schedule = this->schedule();
             const auto& timeMap = schedule.getTimeMap();
             auto& ioConfig = eclState().getIOConfig();
@@ -624,6 +637,8 @@ namespace Opm
         std::unique_ptr<NewtonIterationBlackoilInterface> fis_solver_;
         std::unique_ptr<Simulator> simulator_;
         std::string logFile_;
+        // the Chrome trace written at the end of the run if tracing is enabled
+        std::string traceFile_;
     };
 } // namespace Opm
 
@@ -22,6 +22,7 @@
 
 #include <opm/autodiff/BlackoilAmg.hpp>
 #include <opm/autodiff/CPRPreconditioner.hpp>
+#include <opm/autodiff/MixedPrecisionPreconditioner.hpp>
 #include <opm/autodiff/NewtonIterationBlackoilInterleaved.hpp>
 #include <opm/autodiff/NewtonIterationUtilities.hpp>
 #include <opm/autodiff/ParallelRestrictedAdditiveSchwarz.hpp>
@@ -30,6 +31,7 @@
 
 #include <opm/common/Exceptions.hpp>
 #include <opm/core/linalg/ParallelIstlInformation.hpp>
+#include <opm/simulators/Tracer.hpp>
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 
 #include <dune/istl/scalarproducts.hh>
@@ -348,6 +350,10 @@ namespace Detail
         typedef Dune::BCRSMatrix <MatrixBlockType>      Matrix;
         typedef Dune::BlockVector<VectorBlockType>      Vector;
 
+        // single precision copies used by the preconditioner if requested
+        typedef Dune::BCRSMatrix< Dune::MatrixBlock< float, MatrixBlockType::rows, MatrixBlockType::cols > > FloatMatrix;
+        typedef Dune::BlockVector< Dune::FieldVector< float, VectorBlockType::dimension > > FloatVector;
+
     public:
         typedef Dune::AssembledLinearOperator< Matrix, Vector, Vector > AssembledLinearOperatorType;
 
@@ -361,7 +367,11 @@ namespace Detail
         : iterations_( 0 ),
           parallelInformation_(parallelInformation_arg),
           isIORank_(isIORank(parallelInformation_arg)),
-          parameters_( param )
+          parameters_( param ),
+          solvesSinceSetup_( 0 ),
+          newTimeStep_( true ),
+          setupMatrixSize_( 0 ),
+          setupMatrixNonzeroes_( 0 )
         {
         }
 
@@ -374,7 +384,11 @@ namespace Detail
         : iterations_( 0 ),
           parallelInformation_(parallelInformation_arg),
           isIORank_(isIORank(parallelInformation_arg)),
-          parameters_( param )
+          parameters_( param ),
+          solvesSinceSetup_( 0 ),
+          newTimeStep_( true ),
+          setupMatrixSize_( 0 ),
+          setupMatrixNonzeroes_( 0 )
         {
         }
 
@@ -397,6 +411,16 @@ namespace Detail
         /// \copydoc NewtonIterationBlackoilInterface::parallelInformation
         const boost::any& parallelInformation() const { return parallelInformation_; }
 
+        /// \brief Signals the start of a (possibly repeated) time step.
+        ///
+        /// If the setup of the CPR preconditioner is reused between the linear
+        /// solves (cpr_reuse_setup > 0) and cpr_setup_each_timestep is set, the
+        /// next linear solve will do a new setup.
+        void prepareTimeStep() const
+        {
+            newTimeStep_ = true;
+        }
+
     public:
         /// \brief construct the CPR preconditioner and the solver.
         /// \tparam P The type of the parallel information.
@@ -424,6 +448,12 @@ namespace Detail
             // Communicate if parallel.
             parallelInformation_arg.copyOwnerToAll(istlb, istlb);
 
+            if ( parameters_.use_float_preconditioner_ && ! std::is_same< Scalar, float >::value )
+            {
+                constructFloatPreconditionerAndSolve( linearOperator, x, istlb, parallelInformation_arg, *sp, result );
+                return;
+            }
+
 #if FLOW_SUPPORT_AMG // activate AMG if either flow_ebos is used or UMFPack is not available
             if( parameters_.linear_solver_use_amg_ || parameters_.use_cpr_)
             {
@@ -448,13 +478,33 @@ namespace Detail
                     using AMG = typename ISTLUtility
                         ::BlackoilAmgSelector< Matrix, Vector, Vector,POrComm, Criterion, pressureIndex >::AMG;
 
-                    std::unique_ptr< AMG > amg;
-                    // Construct preconditioner.
-                    Criterion crit(15, 2000);
-                    constructAMGPrecond<Criterion>( linearOperator, parallelInformation_arg, amg, opA, relax );
+                    AMG* amg = dynamic_cast< AMG* >( reusedPreconditioner_.get() );
+                    if ( amg && ! newSetupRequired( linearOperator.getmat() ) )
+                    {
+                        // Reuse the aggregates and sparsity patterns, possibly with new values.
+                        if ( parameters_.cpr_reuse_setup_ == 1 )
+                        {
+                            OPM_TRACE_SCOPE("ISTLSolver::updatePreconditioner");
+                            amg->updatePreconditioner( linearOperator.getmat() );
+                        }
+                        ++solvesSinceSetup_;
+                    }
+                    else
+                    {
+                        // Construct preconditioner.
+                        std::unique_ptr< AMG > newAmg;
+                        constructAMGPrecond<Criterion>( linearOperator, parallelInformation_arg, newAmg, opA, relax );
+                        amg = newAmg.get();
+                        storeReusedPreconditioner( std::move( newAmg ), linearOperator.getmat() );
+                    }
 
                     // Solve.
                     solve(linearOperator, x, istlb, *sp, *amg, result);
+
+                    if ( parameters_.cpr_reuse_setup_ == 0 )
+                    {
+                        reusedPreconditioner_.reset();
+                    }
                 }
                 else
                 {
@@ -492,6 +542,7 @@ namespace Detail
         template <class Operator>
         std::unique_ptr<SeqPreconditioner> constructPrecond(Operator& opA, const Dune::Amg::SequentialInformation&) const
         {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
             const double relax   = parameters_.ilu_relaxation_;
             const int ilu_fillin = parameters_.ilu_fillin_level_;
             std::unique_ptr<SeqPreconditioner> precond(new SeqPreconditioner(opA.getmat(), ilu_fillin, relax));
@@ -514,16 +565,122 @@ namespace Detail
         std::unique_ptr<ParPreconditioner>
         constructPrecond(Operator& opA, const Comm& comm) const
         {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
             typedef std::unique_ptr<ParPreconditioner> Pointer;
             const double relax  = parameters_.ilu_relaxation_;
             return Pointer(new ParPreconditioner(opA.getmat(), comm, relax));
         }
 #endif
 
+        /// \brief Construct the preconditioner from a single precision copy of the
+        ///        matrix and solve with the Krylov method in double precision.
+        ///
+        /// The preconditioner is set up anew for each linear solve, only the
+        /// storage of the float matrix is kept.
+        template <class LinearOperator, class POrComm, class ScalarProd>
+        void constructFloatPreconditionerAndSolve(LinearOperator& linearOperator,
+                                                  Vector& x, Vector& istlb,
+                                                  const POrComm& parallelInformation_arg,
+                                                  ScalarProd& sp,
+                                                  Dune::InverseOperatorResult& result) const
+        {
+            {
+                OPM_TRACE_SCOPE("ISTLSolver::copyFloatMatrix");
+                copyMatrixValues( linearOperator.getmat(), floatMatrix_ );
+            }
+
+#if FLOW_SUPPORT_AMG // activate AMG if either flow_ebos is used or UMFPack is not available
+            if( parameters_.linear_solver_use_amg_ || parameters_.use_cpr_)
+            {
+                typedef ISTLUtility::CPRSelector< FloatMatrix, FloatVector, FloatVector, POrComm>  FloatSelector;
+                typedef typename FloatSelector::Operator FloatOperator;
+                std::unique_ptr< FloatOperator > floatOp( FloatSelector::makeOperator( *floatMatrix_, parallelInformation_arg ) );
+
+                const double relax = parameters_.ilu_relaxation_;
+                if (  parameters_.use_cpr_ )
+                {
+                    using CouplingMetric = Dune::Amg::Diagonal<pressureIndex>;
+                    using CritBase       = Dune::Amg::SymmetricCriterion<FloatMatrix, CouplingMetric>;
+                    using Criterion      = Dune::Amg::CoarsenCriterion<CritBase>;
+                    using AMG = typename ISTLUtility
+                        ::BlackoilAmgSelector< FloatMatrix, FloatVector, FloatVector, POrComm, Criterion, pressureIndex >::AMG;
+
+                    std::unique_ptr< AMG > amg;
+                    {
+                        OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
+                        ISTLUtility::template createAMGPreconditionerPointer<Criterion>( *floatOp, relax, parallelInformation_arg, amg, parameters_ );
+                    }
+                    MixedPrecisionPreconditioner< Vector, AMG > precond( *amg );
+                    solve(linearOperator, x, istlb, sp, precond, result);
+                }
+                else
+                {
+                    typedef typename FloatSelector::AMG AMG;
+                    std::unique_ptr< AMG > amg;
+                    {
+                        OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
+                        ISTLUtility::template createAMGPreconditionerPointer<pressureIndex>( *floatOp, relax, parallelInformation_arg, amg );
+                    }
+                    MixedPrecisionPreconditioner< Vector, AMG > precond( *amg );
+                    solve(linearOperator, x, istlb, sp, precond, result);
+                }
+                return;
+            }
+#endif
+            auto floatPrecond = constructFloatPrecond( parallelInformation_arg );
+            typedef typename decltype( floatPrecond )::element_type FloatPreconditioner;
+            MixedPrecisionPreconditioner< Vector, FloatPreconditioner > precond( *floatPrecond );
+            solve(linearOperator, x, istlb, sp, precond, result);
+        }
+
+        std::unique_ptr< ParallelOverlappingILU0< FloatMatrix, FloatVector, FloatVector > >
+        constructFloatPrecond(const Dune::Amg::SequentialInformation&) const
+        {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
+            typedef ParallelOverlappingILU0< FloatMatrix, FloatVector, FloatVector > FloatPreconditioner;
+            const double relax   = parameters_.ilu_relaxation_;
+            const int ilu_fillin = parameters_.ilu_fillin_level_;
+            return std::unique_ptr< FloatPreconditioner >( new FloatPreconditioner( *floatMatrix_, ilu_fillin, relax ) );
+        }
+
+#if HAVE_MPI
+        std::unique_ptr< ParallelOverlappingILU0< FloatMatrix, FloatVector, FloatVector, Comm > >
+        constructFloatPrecond(const Comm& comm) const
+        {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
+            typedef ParallelOverlappingILU0< FloatMatrix, FloatVector, FloatVector, Comm > FloatPreconditioner;
+            const double relax  = parameters_.ilu_relaxation_;
+            return std::unique_ptr< FloatPreconditioner >( new FloatPreconditioner( *floatMatrix_, comm, relax ) );
+        }
+#endif
+
+        /// \brief Whether the reused CPR preconditioner needs a new setup for the given matrix.
+        bool newSetupRequired( const Matrix& matrix ) const
+        {
+            const CPRParameter& param = parameters_;
+            return param.cpr_reuse_setup_ == 0
+                || ( param.cpr_setup_each_timestep_ && newTimeStep_ )
+                || ( param.cpr_max_reuse_ > 0 && solvesSinceSetup_ >= param.cpr_max_reuse_ )
+                || ( param.cpr_reuse_iteration_threshold_ > 0 && iterations_ > param.cpr_reuse_iteration_threshold_ )
+                || matrix.N() != setupMatrixSize_ || matrix.nonzeroes() != setupMatrixNonzeroes_;
+        }
+
+        /// \brief Keeps a newly set up CPR preconditioner for the following linear solves.
+        template <class Precond>
+        void storeReusedPreconditioner( std::unique_ptr< Precond >&& precond, const Matrix& matrix ) const
+        {
+            reusedPreconditioner_.reset( precond.release() );
+            setupMatrixSize_ = matrix.N();
+            setupMatrixNonzeroes_ = matrix.nonzeroes();
+            solvesSinceSetup_ = 1;
+            newTimeStep_ = false;
+        }
+
         template <class LinearOperator, class MatrixOperator, class POrComm, class AMG >
         void
         constructAMGPrecond(LinearOperator& /* linearOperator */, const POrComm& comm, std::unique_ptr< AMG >& amg, std::unique_ptr< MatrixOperator >& opA, const double relax ) const
         {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
             ISTLUtility::template createAMGPreconditionerPointer<pressureIndex>( *opA, relax, comm, amg );
         }
 
@@ -532,6 +689,7 @@ namespace Detail
         void
         constructAMGPrecond(MatrixOperator& opA, const POrComm& comm, std::unique_ptr< AMG >& amg, std::unique_ptr< MatrixOperator >&, const double relax ) const
         {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
             ISTLUtility::template createAMGPreconditionerPointer<pressureIndex>( opA, relax, comm, amg );
         }
 
@@ -539,6 +697,7 @@ namespace Detail
         void
         constructAMGPrecond(LinearOperator& /* linearOperator */, const POrComm& comm, std::unique_ptr< AMG >& amg, std::unique_ptr< MatrixOperator >& opA, const double relax ) const
         {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
             ISTLUtility::template createAMGPreconditionerPointer<C>( *opA, relax, comm, amg, parameters_ );
         }
 
@@ -547,12 +706,14 @@ namespace Detail
         void
         constructAMGPrecond(MatrixOperator& opA, const POrComm& comm, std::unique_ptr< AMG >& amg, std::unique_ptr< MatrixOperator >&, const double relax ) const
         {
+            OPM_TRACE_SCOPE("ISTLSolver::setupPreconditioner");
             ISTLUtility::template createAMGPreconditionerPointer<C>( opA, relax, comm, amg, parameters_ );
         }
         /// \brief Solve the system using the given preconditioner and scalar product.
         template <class Operator, class ScalarProd, class Precond>
         void solve(Operator& opA, Vector& x, Vector& istlb, ScalarProd& sp, Precond& precond, Dune::InverseOperatorResult& result) const
         {
+            OPM_TRACE_SCOPE("ISTLSolver::krylovSolve");
             // TODO: Revise when linear solvers interface opm-core is done
             // Construct linear solver.
             // GMRes solver
@@ -627,12 +788,27 @@ namespace Detail
                 const ParallelISTLInformation& info =
                     boost::any_cast<const ParallelISTLInformation&>( parallelInformation_);
 
-                // As we use a dune-istl with block size np the number of components
-                // per parallel is only one.
-                info.copyValuesTo(comm.indexSet(), comm.remoteIndices(),
-                                  size, 1);
-                // Construct operator, scalar product and vectors needed.
-                constructPreconditionerAndSolve<Dune::SolverCategory::overlapping>(opA, x, b, comm, result);
+                if ( parameters_.use_cpr_ && parameters_.cpr_reuse_setup_ > 0 )
+                {
+                    // The reused preconditioner keeps a reference to the communication
+                    // object, which therefore has to outlive the operator.
+                    if ( ! reuseComm_ )
+                    {
+                        reuseComm_.reset( new Comm( info.communicator() ) );
+                        info.copyValuesTo(reuseComm_->indexSet(), reuseComm_->remoteIndices(),
+                                          size, 1);
+                    }
+                    constructPreconditionerAndSolve<Dune::SolverCategory::overlapping>(opA, x, b, *reuseComm_, result);
+                }
+                else
+                {
+                    // As we use a dune-istl with block size np the number of components
+                    // per parallel is only one.
+                    info.copyValuesTo(comm.indexSet(), comm.remoteIndices(),
+                                      size, 1);
+                    // Construct operator, scalar product and vectors needed.
+                    constructPreconditionerAndSolve<Dune::SolverCategory::overlapping>(opA, x, b, comm, result);
+                }
             }
             else
 #endif
@@ -654,8 +830,8 @@ namespace Detail
         {
             Dune::InverseOperatorResult result;
             // Construct operator, scalar product and vectors needed.
-            Dune::Amg::SequentialInformation info;
-            constructPreconditionerAndSolve(opA, x, b, info, result);
+            // A member is used as the reused preconditioner keeps a reference to it.
+            constructPreconditionerAndSolve(opA, x, b, sequentialInformation_, result);
             checkConvergence( result );
         }
 
@@ -664,6 +840,11 @@ namespace Detail
             // store number of iterations
             iterations_ = result.iterations;
 
+            // Do not reuse the preconditioner after a failure of the linear solver.
+            if (!result.converged) {
+                reusedPreconditioner_.reset();
+            }
+
             // Check for failure of linear solver.
             if (!parameters_.ignoreConvergenceFailure_ && !result.converged) {
                 const std::string msg("Convergence failure for linear solver.");
@@ -676,6 +857,20 @@ namespace Detail
         bool isIORank_;
 
         NewtonIterationBlackoilInterleavedParameters parameters_;
+
+        // the CPR preconditioner kept between the linear solves if cpr_reuse_setup > 0
+        mutable std::shared_ptr< Dune::Preconditioner< Vector, Vector > > reusedPreconditioner_;
+        mutable int solvesSinceSetup_;
+        mutable bool newTimeStep_;
+        // the size of the matrix the reused preconditioner was set up with
+        mutable size_t setupMatrixSize_;
+        mutable size_t setupMatrixNonzeroes_;
+        mutable Dune::Amg::SequentialInformation sequentialInformation_;
+        // the single precision copy of the matrix if use_float_preconditioner is set
+        mutable std::unique_ptr< FloatMatrix > floatMatrix_;
+#if HAVE_MPI
+        mutable std::unique_ptr< Dune::OwnerOverlapCopyCommunication<int,int> > reuseComm_;
+#endif
     }; // end ISTLSolver
 
 } // namespace Opm
@@ -0,0 +1,159 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/autodiff/LinearSystemSnapshot.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Opm
+{
+
+    LinearSystemSnapshot::LinearSystemSnapshot(const std::string& filename)
+        : filename_(filename),
+          data_(nullptr),
+          size_(0)
+    {
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            OPM_THROW(std::runtime_error, "Failed to open " << filename);
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(LinearSystemSnapshotFormat::magic))) {
+            close(fd);
+            OPM_THROW(std::runtime_error, filename << " is not a linear system snapshot");
+        }
+        size_ = st.st_size;
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            OPM_THROW(std::runtime_error, "Failed to map " << filename);
+        }
+
+        const char* begin = static_cast<const char*>(data_);
+        const char* end = begin + size_;
+        if (std::memcmp(begin, LinearSystemSnapshotFormat::magic, sizeof(LinearSystemSnapshotFormat::magic)) != 0) {
+            munmap(data_, size_);
+            data_ = nullptr;
+            OPM_THROW(std::runtime_error, filename << " is not a linear system snapshot");
+        }
+
+        // Index the records, checking that each fits in the file.
+        const char* pos = begin + sizeof(LinearSystemSnapshotFormat::magic);
+        while (pos < end) {
+            const auto* header = reinterpret_cast<const LinearSystemSnapshotFormat::RecordHeader*>(pos);
+            if (pos + sizeof(*header) > end) {
+                break;
+            }
+            pos += sizeof(*header);
+
+            Record r;
+            r.name.assign(header->name, strnlen(header->name, sizeof(header->name)));
+            r.kind = LinearSystemSnapshotFormat::Kind(header->kind);
+            r.rows = header->rows;
+            r.cols = header->cols;
+            r.block_rows = header->block_rows;
+            r.block_cols = header->block_cols;
+            r.nnz = header->nnz;
+            r.row_start = nullptr;
+            r.col = nullptr;
+            std::size_t num_values = r.rows * r.block_rows;
+            if (r.kind == LinearSystemSnapshotFormat::Matrix) {
+                r.row_start = reinterpret_cast<const std::uint64_t*>(pos);
+                pos += (r.rows + 1) * sizeof(std::uint64_t);
+                r.col = reinterpret_cast<const std::uint64_t*>(pos);
+                pos += r.nnz * sizeof(std::uint64_t);
+                num_values = r.nnz * r.block_rows * r.block_cols;
+            }
+            r.values = reinterpret_cast<const double*>(pos);
+            pos += num_values * sizeof(double);
+            if (pos > end) {
+                break;
+            }
+            records_.push_back(r);
+        }
+        if (pos != end) {
+            munmap(data_, size_);
+            data_ = nullptr;
+            OPM_THROW(std::runtime_error, filename << " is truncated");
+        }
+    }
+
+
+
+    LinearSystemSnapshot::~LinearSystemSnapshot()
+    {
+        if (data_) {
+            munmap(data_, size_);
+        }
+    }
+
+
+
+    const std::vector<LinearSystemSnapshot::Record>& LinearSystemSnapshot::records() const
+    {
+        return records_;
+    }
+
+
+
+    bool LinearSystemSnapshot::has(const std::string& name) const
+    {
+        return std::any_of(records_.begin(), records_.end(),
+                           [&name](const Record& r) { return r.name == name; });
+    }
+
+
+
+    const LinearSystemSnapshot::Record& LinearSystemSnapshot::record(const std::string& name) const
+    {
+        const auto it = std::find_if(records_.begin(), records_.end(),
+                                     [&name](const Record& r) { return r.name == name; });
+        if (it == records_.end()) {
+            OPM_THROW(std::runtime_error, "No record " << name << " in " << filename_);
+        }
+        return *it;
+    }
+
+
+
+    const LinearSystemSnapshot::Record& LinearSystemSnapshot::record(const std::string& name,
+                                                                     const LinearSystemSnapshotFormat::Kind kind,
+                                                                     const int block_rows,
+                                                                     const int block_cols) const
+    {
+        const Record& r = record(name);
+        if (r.kind != kind) {
+            OPM_THROW(std::runtime_error, "Record " << name << " in " << filename_
+                      << " is not a " << (kind == LinearSystemSnapshotFormat::Matrix ? "matrix" : "vector"));
+        }
+        if (r.block_rows != block_rows || r.block_cols != block_cols) {
+            OPM_THROW(std::runtime_error, "Record " << name << " in " << filename_ << " has "
+                      << r.block_rows << "x" << r.block_cols << " blocks, expected "
+                      << block_rows << "x" << block_cols);
+        }
+        return r;
+    }
+
+} // namespace Opm
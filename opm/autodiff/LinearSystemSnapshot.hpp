@@ -0,0 +1,283 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSYSTEMSNAPSHOT_HEADER_INCLUDED
+#define OPM_LINEARSYSTEMSNAPSHOT_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Snapshots of the linear systems of the simulator, i.e. the Jacobian,
+    /// the residual and the blocks of the well equations, written in a
+    /// compact binary format that can be mapped into memory and replayed
+    /// through the linear solvers offline.
+    ///
+    /// A file starts with the 8 characters "OPMLSYS1", followed by named
+    /// records. All numbers are in the native byte order, and all fields
+    /// are 8 bytes wide, so a mapped file can be used in place. A record
+    /// starts with a header
+    ///     char     name[64]      zero padded
+    ///     uint64   kind          Matrix or Vector
+    ///     uint64   rows, cols    number of block rows and columns, 1 column for a vector
+    ///     uint64   block_rows, block_cols
+    ///     uint64   nnz           number of blocks of a matrix
+    /// followed for a matrix by
+    ///     uint64   row_start[rows + 1]
+    ///     uint64   col[nnz]
+    ///     double   values[nnz * block_rows * block_cols]   blocks stored row by row
+    /// and for a vector by
+    ///     double   values[rows * block_rows]
+    namespace LinearSystemSnapshotFormat
+    {
+        const char magic[8] = { 'O', 'P', 'M', 'L', 'S', 'Y', 'S', '1' };
+
+        enum Kind { Matrix = 0, Vector = 1 };
+
+        struct RecordHeader
+        {
+            char name[64];
+            std::uint64_t kind;
+            std::uint64_t rows;
+            std::uint64_t cols;
+            std::uint64_t block_rows;
+            std::uint64_t block_cols;
+            std::uint64_t nnz;
+        };
+    } // namespace LinearSystemSnapshotFormat
+
+
+
+    /// Writes the records of a snapshot file.
+    class LinearSystemSnapshotWriter
+    {
+    public:
+        explicit LinearSystemSnapshotWriter(const std::string& filename)
+            : filename_(filename),
+              os_(filename.c_str(), std::ios::binary)
+        {
+            if (!os_) {
+                OPM_THROW(std::runtime_error, "Failed to open " << filename);
+            }
+            os_.write(LinearSystemSnapshotFormat::magic, sizeof(LinearSystemSnapshotFormat::magic));
+        }
+
+        /// Write a Dune::BCRSMatrix with Dune::FieldMatrix blocks.
+        template <class Matrix>
+        void writeMatrix(const std::string& name, const Matrix& A)
+        {
+            typedef typename Matrix::block_type Block;
+            writeHeader(name, LinearSystemSnapshotFormat::Matrix, A.N(), A.M(),
+                        Block::rows, Block::cols, A.nonzeroes());
+
+            std::vector<std::uint64_t> index;
+            index.reserve(A.N() + 1);
+            index.push_back(0);
+            for (auto row = A.begin(); row != A.end(); ++row) {
+                index.push_back(index.back() + row->size());
+            }
+            write(index);
+
+            index.clear();
+            std::vector<double> values;
+            values.reserve(A.nonzeroes() * Block::rows * Block::cols);
+            for (auto row = A.begin(); row != A.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    index.push_back(col.index());
+                    for (int i = 0; i < Block::rows; ++i) {
+                        for (int j = 0; j < Block::cols; ++j) {
+                            values.push_back((*col)[i][j]);
+                        }
+                    }
+                }
+            }
+            write(index);
+            write(values);
+            check();
+        }
+
+        /// Write a Dune::BlockVector with Dune::FieldVector blocks.
+        template <class Vector>
+        void writeVector(const std::string& name, const Vector& v)
+        {
+            typedef typename Vector::block_type Block;
+            writeHeader(name, LinearSystemSnapshotFormat::Vector, v.size(), 1,
+                        Block::dimension, 1, v.size());
+
+            std::vector<double> values;
+            values.reserve(v.size() * Block::dimension);
+            for (const auto& block : v) {
+                for (int i = 0; i < Block::dimension; ++i) {
+                    values.push_back(block[i]);
+                }
+            }
+            write(values);
+            check();
+        }
+
+    private:
+        void writeHeader(const std::string& name,
+                         const LinearSystemSnapshotFormat::Kind kind,
+                         const std::size_t rows, const std::size_t cols,
+                         const int block_rows, const int block_cols,
+                         const std::size_t nnz)
+        {
+            LinearSystemSnapshotFormat::RecordHeader header = {};
+            if (name.size() >= sizeof(header.name)) {
+                OPM_THROW(std::logic_error, "Record name " << name << " too long for a snapshot file");
+            }
+            name.copy(header.name, name.size());
+            header.kind = kind;
+            header.rows = rows;
+            header.cols = cols;
+            header.block_rows = block_rows;
+            header.block_cols = block_cols;
+            header.nnz = nnz;
+            os_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        template <class T>
+        void write(const std::vector<T>& data)
+        {
+            os_.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+        }
+
+        void check() const
+        {
+            if (!os_) {
+                OPM_THROW(std::runtime_error, "Failed to write " << filename_);
+            }
+        }
+
+        std::string filename_;
+        std::ofstream os_;
+    };
+
+
+
+    /// A snapshot file mapped into memory. The arrays of the records point
+    /// into the mapped file.
+    class LinearSystemSnapshot
+    {
+    public:
+        struct Record
+        {
+            std::string name;
+            LinearSystemSnapshotFormat::Kind kind;
+            std::size_t rows;
+            std::size_t cols;
+            int block_rows;
+            int block_cols;
+            std::size_t nnz;
+            // row_start and col are null for a vector
+            const std::uint64_t* row_start;
+            const std::uint64_t* col;
+            const double* values;
+        };
+
+        explicit LinearSystemSnapshot(const std::string& filename);
+        ~LinearSystemSnapshot();
+
+        LinearSystemSnapshot(const LinearSystemSnapshot&) = delete;
+        LinearSystemSnapshot& operator=(const LinearSystemSnapshot&) = delete;
+
+        /// All records, in the order they were written.
+        const std::vector<Record>& records() const;
+
+        /// Whether there is a record with the given name.
+        bool has(const std::string& name) const;
+
+        /// The record with the given name, throws if there is none.
+        const Record& record(const std::string& name) const;
+
+        /// Copy a matrix record to a Dune::BCRSMatrix with Dune::FieldMatrix
+        /// blocks of the size of the record.
+        template <class Matrix>
+        Matrix matrix(const std::string& name) const;
+
+        /// Copy a vector record to a Dune::BlockVector with Dune::FieldVector
+        /// blocks of the size of the record.
+        template <class Vector>
+        Vector vector(const std::string& name) const;
+
+    private:
+        const Record& record(const std::string& name,
+                             const LinearSystemSnapshotFormat::Kind kind,
+                             const int block_rows, const int block_cols) const;
+
+        std::string filename_;
+        void* data_;
+        std::size_t size_;
+        std::vector<Record> records_;
+    };
+
+
+
+    template <class Matrix>
+    Matrix LinearSystemSnapshot::matrix(const std::string& name) const
+    {
+        typedef typename Matrix::block_type Block;
+        const Record& r = record(name, LinearSystemSnapshotFormat::Matrix, Block::rows, Block::cols);
+
+        Matrix A(r.rows, r.cols, r.nnz, Matrix::row_wise);
+        for (auto row = A.createbegin(); row != A.createend(); ++row) {
+            for (std::uint64_t k = r.row_start[row.index()]; k < r.row_start[row.index() + 1]; ++k) {
+                row.insert(r.col[k]);
+            }
+        }
+        const double* value = r.values;
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                for (int i = 0; i < Block::rows; ++i) {
+                    for (int j = 0; j < Block::cols; ++j) {
+                        (*col)[i][j] = *value++;
+                    }
+                }
+            }
+        }
+        return A;
+    }
+
+
+
+    template <class Vector>
+    Vector LinearSystemSnapshot::vector(const std::string& name) const
+    {
+        typedef typename Vector::block_type Block;
+        const Record& r = record(name, LinearSystemSnapshotFormat::Vector, Block::dimension, 1);
+
+        Vector v(r.rows);
+        const double* value = r.values;
+        for (auto& block : v) {
+            for (int i = 0; i < Block::dimension; ++i) {
+                block[i] = *value++;
+            }
+        }
+        return v;
+    }
+
+} // namespace Opm
+
+#endif // OPM_LINEARSYSTEMSNAPSHOT_HEADER_INCLUDED
@@ -27,6 +27,7 @@
 #if HAVE_UMFPACK
 #include <dune/istl/umfpack.hh>
 #endif // HAVE_UMFPACK
+#include <cassert>
 #include <cmath>
 
 namespace Opm {
@@ -71,6 +72,163 @@ namespace mswellhelpers
 
 
 
+    // direct solver for the D matrix of a multisegment well, which keeps the
+    // factorization of D between the solves.
+    // The symbolic analysis only depends on the sparsity pattern of D, which
+    // only changes with the segment topology, so it is kept across the Newton
+    // iterations. The numeric factorization is redone with factorize() once per
+    // assembly, and solve() is then only a pair of triangular solves.
+    template <typename MatrixType>
+    class DirectSolverD
+    {
+    public:
+        DirectSolverD()
+#if HAVE_UMFPACK
+            : symbolic_(nullptr)
+            , numeric_(nullptr)
+            , num_rows_(0)
+            , num_nonzeroes_(0)
+#endif // HAVE_UMFPACK
+        {
+#if HAVE_UMFPACK
+            Caller::defaults(control_);
+#endif // HAVE_UMFPACK
+        }
+
+        // the factorization can not be shared between the copies
+        DirectSolverD(const DirectSolverD&) = delete;
+        DirectSolverD& operator=(const DirectSolverD&) = delete;
+
+        ~DirectSolverD()
+        {
+            clear();
+        }
+
+        // compute the numeric factorization of D, the symbolic analysis is only
+        // redone when the sparsity pattern of D has changed since the last call
+        void factorize(const MatrixType& D)
+        {
+#if HAVE_UMFPACK
+            freeNumeric();
+
+            if (D.N() != num_rows_ || D.nonzeroes() != num_nonzeroes_) {
+                freeSymbolic();
+            }
+
+            col_comp_matrix_ = D;
+
+            double info[UMFPACK_INFO];
+            if (symbolic_ == nullptr) {
+                Caller::symbolic(static_cast<int>(col_comp_matrix_.N()),
+                                 static_cast<int>(col_comp_matrix_.N()),
+                                 col_comp_matrix_.getColStart(),
+                                 col_comp_matrix_.getRowIndex(),
+                                 reinterpret_cast<double*>(col_comp_matrix_.getValues()),
+                                 &symbolic_, control_, info);
+                num_rows_ = D.N();
+                num_nonzeroes_ = D.nonzeroes();
+            }
+
+            Caller::numeric(col_comp_matrix_.getColStart(),
+                            col_comp_matrix_.getRowIndex(),
+                            reinterpret_cast<double*>(col_comp_matrix_.getValues()),
+                            symbolic_, &numeric_, control_, info);
+#else
+            static_cast<void>(D);
+            OPM_THROW(std::runtime_error, "Cannot use DirectSolverD without UMFPACK. "
+                      "Reconfigure opm-simulator with SuiteSparse/UMFPACK support and recompile.");
+#endif // HAVE_UMFPACK
+        }
+
+        // obtain y = D^-1 * x with the factorization from the last factorize()
+        template <typename VectorType>
+        VectorType solve(const VectorType& x) const
+        {
+#if HAVE_UMFPACK
+            assert(numeric_ != nullptr);
+
+            VectorType y(x.size());
+            y = 0.;
+
+            // UMFPACK does not change the right hand side, it only takes a non-const pointer
+            VectorType b(x);
+
+            double info[UMFPACK_INFO];
+            Caller::solve(UMFPACK_A,
+                          col_comp_matrix_.getColStart(),
+                          col_comp_matrix_.getRowIndex(),
+                          reinterpret_cast<double*>(col_comp_matrix_.getValues()),
+                          reinterpret_cast<double*>(&y[0]),
+                          reinterpret_cast<double*>(&b[0]),
+                          numeric_, control_, info);
+
+            // Checking if there is any inf or nan in y
+            // it will be the solution before we find a way to catch the singularity of the matrix
+            for (size_t i_block = 0; i_block < y.size(); ++i_block) {
+                for (size_t i_elem = 0; i_elem < y[i_block].size(); ++i_elem) {
+                    if (std::isinf(y[i_block][i_elem]) || std::isnan(y[i_block][i_elem]) ) {
+                        OPM_THROW(Opm::NumericalIssue, "nan or inf value found in DirectSolverD::solve due to singular matrix");
+                    }
+                }
+            }
+
+            return y;
+#else
+            static_cast<void>(x);
+            OPM_THROW(std::runtime_error, "Cannot use DirectSolverD without UMFPACK. "
+                      "Reconfigure opm-simulator with SuiteSparse/UMFPACK support and recompile.");
+#endif // HAVE_UMFPACK
+        }
+
+        // release both the numeric factorization and the symbolic analysis,
+        // to be called when the sparsity pattern of D is rebuilt
+        void clear()
+        {
+#if HAVE_UMFPACK
+            freeNumeric();
+            freeSymbolic();
+#endif // HAVE_UMFPACK
+        }
+
+    private:
+#if HAVE_UMFPACK
+        typedef typename MatrixType::field_type Scalar;
+        typedef Dune::UMFPackMethodChooser<Scalar> Caller;
+        typedef typename Dune::UMFPack<MatrixType>::UMFPackMatrix UMFPackMatrix;
+
+        void freeNumeric()
+        {
+            if (numeric_ != nullptr) {
+                Caller::free_numeric(&numeric_);
+                numeric_ = nullptr;
+            }
+        }
+
+        void freeSymbolic()
+        {
+            if (symbolic_ != nullptr) {
+                Caller::free_symbolic(&symbolic_);
+                symbolic_ = nullptr;
+            }
+            num_rows_ = 0;
+            num_nonzeroes_ = 0;
+        }
+
+        // UMFPACK takes non-const pointers to the matrix also for the solve
+        mutable UMFPackMatrix col_comp_matrix_;
+        mutable double control_[UMFPACK_CONTROL];
+        void* symbolic_;
+        void* numeric_;
+        // the pattern for which the symbolic analysis was done
+        size_t num_rows_;
+        size_t num_nonzeroes_;
+#endif // HAVE_UMFPACK
+    };
+
+
+
+
+
     // obtain y = D^-1 * x with a BICSSTAB iterative solver
     template <typename MatrixType, typename VectorType>
     VectorType
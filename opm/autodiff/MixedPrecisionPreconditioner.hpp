@@ -0,0 +1,180 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+#define OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+
+#include <cstddef>
+#include <memory>
+
+#include <dune/common/version.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+
+namespace Opm
+{
+
+/// \brief Whether two block matrices have the same size and the same column
+///        indices in each row, regardless of their field types.
+template <class SourceMatrix, class TargetMatrix>
+bool sameSparsityPattern(const SourceMatrix& source, const TargetMatrix& target)
+{
+    if (target.N() != source.N() || target.M() != source.M()
+        || target.nonzeroes() != source.nonzeroes())
+    {
+        return false;
+    }
+    for (auto row = source.begin(); row != source.end(); ++row) {
+        const auto& targetRow = target[row.index()];
+        if (targetRow.size() != row->size()) {
+            return false;
+        }
+        auto targetCol = targetRow.begin();
+        for (auto col = row->begin(); col != row->end(); ++col, ++targetCol) {
+            if (targetCol.index() != col.index()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// \brief Copy the values of a block matrix into a matrix with a different
+///        field type, e.g. a float copy of a double matrix.
+///
+/// The target is only (re)created if it does not exist yet or if its
+/// sparsity pattern differs from the one of the source, so a target that is
+/// kept between the linear solves is not reallocated.
+template <class SourceMatrix, class TargetMatrix>
+void copyMatrixValues(const SourceMatrix& source, std::unique_ptr<TargetMatrix>& target)
+{
+    if (!target || !sameSparsityPattern(source, *target))
+    {
+        target.reset(new TargetMatrix(source.N(), source.M(), source.nonzeroes(),
+                                      TargetMatrix::row_wise));
+        for (auto row = target->createbegin(); row != target->createend(); ++row) {
+            const auto& sourceRow = source[row.index()];
+            for (auto col = sourceRow.begin(); col != sourceRow.end(); ++col) {
+                row.insert(col.index());
+            }
+        }
+    }
+
+    for (auto row = source.begin(); row != source.end(); ++row) {
+        auto targetCol = (*target)[row.index()].begin();
+        for (auto col = row->begin(); col != row->end(); ++col, ++targetCol) {
+            const auto& block = *col;
+            auto& targetBlock = *targetCol;
+            for (int i = 0; i < block.rows; ++i) {
+                for (int j = 0; j < block.cols; ++j) {
+                    targetBlock[i][j] = block[i][j];
+                }
+            }
+        }
+    }
+}
+
+/// \brief Copy a block vector into a vector with a different field type.
+template <class SourceVector, class TargetVector>
+void copyVectorValues(const SourceVector& source, TargetVector& target)
+{
+    target.resize(source.size());
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        for (int j = 0; j < source[i].dimension; ++j) {
+            target[i][j] = source[i][j];
+        }
+    }
+}
+
+/// \brief Applies a preconditioner set up in a lower precision, usually
+///        float, to the vectors of a solver working in double precision.
+///
+/// The defects are converted to the field type of the wrapped preconditioner
+/// and its updates are converted back, so only the preconditioner works
+/// with the reduced memory bandwidth while the Krylov method and the
+/// residuals keep their full precision.
+/// \tparam X The vector type of the outer solver.
+/// \tparam Precond The type of the wrapped preconditioner.
+template <class X, class Precond>
+class MixedPrecisionPreconditioner
+    : public Dune::Preconditioner<X, X>
+{
+public:
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef X range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief The vector type of the wrapped preconditioner.
+    typedef typename Precond::domain_type LowVector;
+
+    /// \brief Constructor.
+    /// \param precond The wrapped preconditioner, it must outlive this object.
+    explicit MixedPrecisionPreconditioner(Precond& precond)
+        : precond_(precond)
+    {
+    }
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return precond_.category();
+    }
+#else
+    enum {
+        //! \brief The category the preconditioner is part of.
+        category = Precond::category
+    };
+#endif
+
+    virtual void pre(X& x, X& b)
+    {
+        copyVectorValues(x, x_);
+        copyVectorValues(b, b_);
+        precond_.pre(x_, b_);
+        copyVectorValues(x_, x);
+        copyVectorValues(b_, b);
+    }
+
+    virtual void apply(X& v, const X& d)
+    {
+        copyVectorValues(d, b_);
+        x_.resize(b_.size());
+        x_ = 0.0;
+        precond_.apply(x_, b_);
+        copyVectorValues(x_, v);
+    }
+
+    virtual void post(X& x)
+    {
+        copyVectorValues(x, x_);
+        precond_.post(x_);
+        copyVectorValues(x_, x);
+    }
+
+private:
+    Precond& precond_;
+    // work vectors in the precision of the wrapped preconditioner
+    LowVector x_;
+    LowVector b_;
+};
+
+} // namespace Opm
+
+#endif // OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
@@ -24,6 +24,7 @@
 
 
 #include <opm/autodiff/WellInterface.hpp>
+#include <opm/autodiff/MSWellHelpers.hpp>
 
 namespace Opm
 {
@@ -130,6 +131,8 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const;
 
+        virtual void writeSystemSnapshot(LinearSystemSnapshotWriter& writer) const;
+
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
         virtual void recoverWellSolutionAndUpdateWellState(const BVector& x,
@@ -218,6 +221,10 @@ namespace Opm
         // diagonal matrix for the well
         mutable DiagMatWell duneD_;
 
+        // the factorization of duneD_, it is updated at the end of each assembly
+        // and reused by all the solves with duneD_ until the next assembly
+        mutable mswellhelpers::DirectSolverD<DiagMatWell> duneDSolver_;
+
         // residuals of the well equations
         mutable BVectorWell resWell_;
 
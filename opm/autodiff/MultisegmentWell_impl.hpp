@@ -139,6 +139,9 @@ namespace Opm
     MultisegmentWell<TypeTag>::
     initMatrixAndVectors(const int num_cells) const
     {
+        // the sparsity pattern of duneD_ is rebuilt, the old symbolic analysis can not be used anymore
+        duneDSolver_.clear();
+
         duneB_.setBuildMode( OffDiagMatWell::row_wise );
         duneC_.setBuildMode( OffDiagMatWell::row_wise );
         duneD_.setBuildMode( DiagMatWell::row_wise );
@@ -495,7 +498,7 @@ namespace Opm
         duneB_.mv(x, Bx);
 
         // invDBx = duneD^-1 * Bx_
-        const BVectorWell invDBx = mswellhelpers::invDXDirect(duneD_, Bx);
+        const BVectorWell invDBx = duneDSolver_.solve(Bx);
 
         // Ax = Ax - duneC_^T * invDBx
         duneC_.mmtv(invDBx,Ax);
@@ -511,7 +514,7 @@ namespace Opm
     apply(BVector& r) const
     {
         // invDrw_ = duneD^-1 * resWell_
-        const BVectorWell invDrw = mswellhelpers::invDXDirect(duneD_, resWell_);
+        const BVectorWell invDrw = duneDSolver_.solve(resWell_);
         // r = r - duneC_^T * invDrw
         duneC_.mmtv(invDrw, r);
     }
@@ -520,6 +523,21 @@ namespace Opm
 
 
 
+    template <typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    writeSystemSnapshot(LinearSystemSnapshotWriter& writer) const
+    {
+        const std::string prefix = "well/" + name() + "/";
+        writer.writeMatrix(prefix + "B", duneB_);
+        writer.writeMatrix(prefix + "C", duneC_);
+        writer.writeMatrix(prefix + "D", duneD_);
+    }
+
+
+
+
+
     template <typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
@@ -629,7 +647,7 @@ namespace Opm
         // resWell = resWell - B * x
         duneB_.mmv(x, resWell);
         // xw = D^-1 * resWell
-        xw = mswellhelpers::invDXDirect(duneD_, resWell);
+        xw = duneDSolver_.solve(resWell);
     }
 
 
@@ -643,7 +661,7 @@ namespace Opm
     {
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
-        const BVectorWell dx_well = mswellhelpers::invDXDirect(duneD_, resWell_);
+        const BVectorWell dx_well = duneDSolver_.solve(resWell_);
 
         updateWellState(dx_well, false, well_state);
     }
@@ -1718,7 +1736,7 @@ namespace Opm
 
             assembleWellEqWithoutIteration(ebosSimulator, dt, well_state, true);
 
-            const BVectorWell dx_well = mswellhelpers::invDXDirect(duneD_, resWell_);
+            const BVectorWell dx_well = duneDSolver_.solve(resWell_);
 
             // TODO: use these small values for now, not intend to reach the convergence
             // in this stage, but, should we?
@@ -1859,6 +1877,9 @@ namespace Opm
                 assemblePressureEq(seg);
             }
         }
+
+        // the factorization of duneD_ is used by all the solves until the next assembly
+        duneDSolver_.factorize(duneD_);
     }
 
 }
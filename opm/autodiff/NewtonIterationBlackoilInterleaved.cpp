@@ -38,6 +38,11 @@
 
 #include <opm/autodiff/ISTLSolver.hpp>
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 
 #if HAVE_UMFPACK
@@ -107,90 +112,37 @@ namespace Opm
         const boost::any& parallelInformation() const { return istlSolver_.parallelInformation(); }
 
     public:
-        void formInterleavedSystem(const std::vector<LinearisedBlackoilResidual::ADB>& eqs,
-                                   Mat& istlA) const
+        /// Form the interleaved (block structured) system of the
+        /// equations. The sparsity pattern of the system and the position
+        /// of each nonzero of the derivatives in it are created on the
+        /// first call, and reused as long as the sparsity patterns of the
+        /// derivatives do not change, e.g. until the wells change. The
+        /// returned matrix is valid until the next call.
+        Mat& formInterleavedSystem(const std::vector<LinearisedBlackoilResidual::ADB>& eqs) const
         {
             assert( np == int(eqs.size()) );
-            // Find sparsity structure as union of basic block sparsity structures,
-            // corresponding to the jacobians with respect to pressure.
-            // Use our custom PointOneOp to get to the union structure.
-            // As default we only iterate over the pressure derivatives.
-            Eigen::SparseMatrix<double, Eigen::ColMajor> col_major = eqs[0].derivative()[0].getSparse();
-            detail::PointOneOp<double> point_one;
-            for (int phase = 1; phase < np; ++phase) {
-                const AutoDiffMatrix::SparseRep& mat = eqs[phase].derivative()[0].getSparse();
-                col_major = col_major.binaryExpr(mat, point_one);
-            }
-            // For some cases (for instance involving Solvent flow) the reasoning for only adding
-            // the pressure derivatives fails. As getting the sparsity pattern is non-trivial, in terms
-            // of work, the full sparsity pattern is only added when required.
-            if (parameters_.require_full_sparsity_pattern_) {
-                for (int p1 = 0; p1 < np; ++p1) {
-                    for (int p2 = 1; p2 < np; ++p2) { // pressure is already added
-                        const AutoDiffMatrix::SparseRep& mat = eqs[p1].derivative()[p2].getSparse();
-                        col_major = col_major.binaryExpr(mat, point_one);
-                    }
-                }
-            }
-
-            // Automatically convert the column major structure to a row-major structure
-            Eigen::SparseMatrix<double, Eigen::RowMajor> row_major = col_major;
-
-            const int size = row_major.rows();
-            assert(size == row_major.cols());
-
-            {
-                // Create ISTL matrix with interleaved rows and columns (block structured).
-                istlA.setSize(row_major.rows(), row_major.cols(), row_major.nonZeros());
-                istlA.setBuildMode(Mat::row_wise);
-                const int* ia = row_major.outerIndexPtr();
-                const int* ja = row_major.innerIndexPtr();
-                const typename Mat::CreateIterator endrow = istlA.createend();
-                for (typename Mat::CreateIterator row = istlA.createbegin(); row != endrow; ++row) {
-                    const int ri = row.index();
-                    for (int i = ia[ri]; i < ia[ri + 1]; ++i) {
-                        row.insert(ja[i]);
-                    }
+            Derivatives derivatives;
+            for (int p1 = 0; p1 < np; ++p1) {
+                for (int p2 = 0; p2 < np; ++p2) {
+                    derivatives[p1 * np + p2] = &eqs[p1].derivative()[p2].getSparse();
                 }
             }
 
-            /*
-            // not neeeded since MatrixBlock initially zeros all elements during construction
-            // Set all blocks to zero.
-            for (auto row = istlA.begin(), rowend = istlA.end(); row != rowend; ++row ) {
-                for (auto col = row->begin(), colend = row->end(); col != colend; ++col ) {
-                    *col = 0.0;
-                }
+            if (!samePattern(derivatives)) {
+                createInterleavedPattern(derivatives);
             }
-            */
 
-            /**
-             * Go through all jacobians, and insert in correct spot
-             *
-             * The straight forward way to do this would be to run through each
-             * element in the output matrix, and set all block entries by gathering
-             * from all "input matrices" (derivatives).
-             *
-             * A faster alternative is to instead run through each "input matrix" and
-             * insert its elements in the correct spot in the output matrix.
-             *
-             */
-            for (int p1 = 0; p1 < np; ++p1) {
-                for (int p2 = 0; p2 < np; ++p2) {
-                    // Note that that since these are CSC and not CSR matrices,
-                    // ja contains row numbers instead of column numbers.
-                    const AutoDiffMatrix::SparseRep& s = eqs[p1].derivative()[p2].getSparse();
-                    const int* ia = s.outerIndexPtr();
-                    const int* ja = s.innerIndexPtr();
-                    const double* sa = s.valuePtr();
-                    for (int col = 0; col < size; ++col) {
-                        for (int elem_ix = ia[col]; elem_ix < ia[col + 1]; ++elem_ix) {
-                            const int row = ja[elem_ix];
-                            istlA[row][col][p1][p2] = sa[elem_ix];
-                        }
-                    }
+            // Scatter the values of all jacobians into their positions in
+            // the blocks. Positions not covered by any jacobian are zero.
+            for (int d = 0; d < np * np; ++d) {
+                const double* sa = derivatives[d]->valuePtr();
+                Scalar* const* position = positions_[d].data();
+                const int nnz = positions_[d].size();
+                for (int elem_ix = 0; elem_ix < nnz; ++elem_ix) {
+                    *position[elem_ix] = sa[elem_ix];
                 }
             }
+            return *istlA_;
         }
 
 
@@ -202,7 +154,6 @@ namespace Opm
         SolutionVector computeNewtonIncrement(const LinearisedBlackoilResidual& residual) const
         {
             typedef LinearisedBlackoilResidual::ADB  ADB;
-            typedef ADB::V   V;
 
             // Build the vector of equations.
             //const int np = residual.material_balance_eq.size();
@@ -235,50 +186,32 @@ namespace Opm
                 eqs[phase] = eqs[phase] * residual.matbalscale[phase];
             }
 
-            // calculating the size for b
-            int size_b = 0;
-            for (int elem = 0; elem < np; ++elem) {
-                const int loc_size = eqs[elem].size();
-                size_b += loc_size;
-            }
-
-            V b(size_b);
-
-            int pos = 0;
-            for (int elem = 0; elem < np; ++elem) {
-                const int loc_size = eqs[elem].size();
-                b.segment(pos, loc_size) = eqs[elem].value();
-                pos += loc_size;
-            }
-            assert(pos == size_b);
-
             // Create ISTL matrix with interleaved rows and columns (block structured).
-            Mat istlA;
-            formInterleavedSystem(eqs, istlA);
-
-            // Solve reduced system.
-            SolutionVector dx(SolutionVector::Zero(b.size()));
+            Mat& istlA = formInterleavedSystem(eqs);
 
-            // Right hand side.
+            // Right hand side, interleaved directly from the equations.
             const int size = istlA.N();
-            Vector istlb(size);
-            for (int i = 0; i < size; ++i) {
-                for( int p = 0, idx = i; p<np; ++p, idx += size ) {
-                    istlb[i][p] = b(idx);
+            istlb_.resize(size);
+            for (int p = 0; p < np; ++p) {
+                assert(eqs[p].size() == size);
+                const double* b = eqs[p].value().data();
+                for (int i = 0; i < size; ++i) {
+                    istlb_[i][p] = b[i];
                 }
             }
 
             // System solution
-            Vector x(istlA.M());
-            x = 0.0;
+            x_.resize(istlA.M());
+            x_ = 0.0;
 
             // solve linear system using ISTL methods
-            istlSolver_.solve( istlA, x, istlb );
+            istlSolver_.solve( istlA, x_, istlb_ );
 
             // Copy solver output to dx.
+            SolutionVector dx(np * size);
             for (int i = 0; i < size; ++i) {
                 for( int p=0, idx = i; p<np; ++p, idx += size ) {
-                    dx(idx) = x[i][p];
+                    dx(idx) = x_[i][p];
                 }
             }
 
@@ -292,8 +225,122 @@ namespace Opm
         }
 
     protected:
+        typedef std::array<const AutoDiffMatrix::SparseRep*, np * np> Derivatives;
+
+        /// Whether the sparsity patterns of the derivatives are the ones
+        /// the interleaved system was created for.
+        bool samePattern(const Derivatives& derivatives) const
+        {
+            if (!istlA_) {
+                return false;
+            }
+            for (int d = 0; d < np * np; ++d) {
+                const AutoDiffMatrix::SparseRep& s = *derivatives[d];
+                const std::vector<int>& outer = pattern_outer_[d];
+                const std::vector<int>& inner = pattern_inner_[d];
+                if (int(outer.size()) != s.outerSize() + 1
+                    || int(inner.size()) != s.nonZeros()
+                    || !std::equal(outer.begin(), outer.end(), s.outerIndexPtr())
+                    || !std::equal(inner.begin(), inner.end(), s.innerIndexPtr())) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Create the sparsity pattern of the interleaved system, and the
+        /// position of each nonzero of the derivatives in it.
+        void createInterleavedPattern(const Derivatives& derivatives) const
+        {
+            // Find sparsity structure as union of basic block sparsity structures,
+            // corresponding to the jacobians with respect to pressure.
+            // Use our custom PointOneOp to get to the union structure.
+            // As default we only iterate over the pressure derivatives.
+            Eigen::SparseMatrix<double, Eigen::ColMajor> col_major = *derivatives[0];
+            detail::PointOneOp<double> point_one;
+            for (int phase = 1; phase < np; ++phase) {
+                col_major = col_major.binaryExpr(*derivatives[phase * np], point_one);
+            }
+            // For some cases (for instance involving Solvent flow) the reasoning for only adding
+            // the pressure derivatives fails. As getting the sparsity pattern is non-trivial, in terms
+            // of work, the full sparsity pattern is only added when required.
+            if (parameters_.require_full_sparsity_pattern_) {
+                for (int p1 = 0; p1 < np; ++p1) {
+                    for (int p2 = 1; p2 < np; ++p2) { // pressure is already added
+                        col_major = col_major.binaryExpr(*derivatives[p1 * np + p2], point_one);
+                    }
+                }
+            }
+
+            // Automatically convert the column major structure to a row-major structure
+            Eigen::SparseMatrix<double, Eigen::RowMajor> row_major = col_major;
+
+            const int size = row_major.rows();
+            assert(size == row_major.cols());
+
+            {
+                // Create ISTL matrix with interleaved rows and columns (block structured).
+                istlA_.reset(new Mat());
+                Mat& istlA = *istlA_;
+                istlA.setSize(row_major.rows(), row_major.cols(), row_major.nonZeros());
+                istlA.setBuildMode(Mat::row_wise);
+                const int* ia = row_major.outerIndexPtr();
+                const int* ja = row_major.innerIndexPtr();
+                const typename Mat::CreateIterator endrow = istlA.createend();
+                for (typename Mat::CreateIterator row = istlA.createbegin(); row != endrow; ++row) {
+                    const int ri = row.index();
+                    for (int i = ia[ri]; i < ia[ri + 1]; ++i) {
+                        row.insert(ja[i]);
+                    }
+                }
+                // The positions not covered by any jacobian are never written.
+                istlA = 0.0;
+            }
+
+            /**
+             * Record where each element of the jacobians goes.
+             *
+             * The straight forward way to do this would be to run through each
+             * element in the output matrix, and set all block entries by gathering
+             * from all "input matrices" (derivatives).
+             *
+             * A faster alternative is to instead run through each "input matrix" and
+             * record the correct spot in the output matrix for its elements.
+             *
+             */
+            for (int p1 = 0; p1 < np; ++p1) {
+                for (int p2 = 0; p2 < np; ++p2) {
+                    // Note that that since these are CSC and not CSR matrices,
+                    // ja contains row numbers instead of column numbers.
+                    const int d = p1 * np + p2;
+                    const AutoDiffMatrix::SparseRep& s = *derivatives[d];
+                    const int* ia = s.outerIndexPtr();
+                    const int* ja = s.innerIndexPtr();
+                    pattern_outer_[d].assign(ia, ia + s.outerSize() + 1);
+                    pattern_inner_[d].assign(ja, ja + s.nonZeros());
+                    positions_[d].resize(s.nonZeros());
+                    for (int col = 0; col < size; ++col) {
+                        for (int elem_ix = ia[col]; elem_ix < ia[col + 1]; ++elem_ix) {
+                            const int row = ja[elem_ix];
+                            positions_[d][elem_ix] = &(*istlA_)[row][col][p1][p2];
+                        }
+                    }
+                }
+            }
+        }
+
         ISTLSolverType istlSolver_;
         NewtonIterationBlackoilInterleavedParameters parameters_;
+
+        // The interleaved system, and for each derivative (p1, p2), stored
+        // at p1 * np + p2, its sparsity pattern and the position of each of
+        // its nonzeros in the system.
+        mutable std::unique_ptr<Mat> istlA_;
+        mutable std::array<std::vector<int>, np * np> pattern_outer_;
+        mutable std::array<std::vector<int>, np * np> pattern_inner_;
+        mutable std::array<std::vector<Scalar*>, np * np> positions_;
+        mutable Vector istlb_;
+        mutable Vector x_;
     }; // end NewtonIterationBlackoilInterleavedImpl
 
 
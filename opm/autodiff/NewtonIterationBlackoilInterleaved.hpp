@@ -49,6 +49,7 @@ namespace Opm
         bool   ignoreConvergenceFailure_;
         bool   linear_solver_use_amg_;
         bool   use_cpr_;
+        bool   use_float_preconditioner_;
 
         NewtonIterationBlackoilInterleavedParameters() { reset(); }
         // read values from parameter class
@@ -69,6 +70,7 @@ namespace Opm
             linear_solver_use_amg_    = param.getDefault("linear_solver_use_amg", linear_solver_use_amg_ );
             ilu_relaxation_           = param.getDefault("ilu_relaxation", ilu_relaxation_ );
             ilu_fillin_level_         = param.getDefault("ilu_fillin_level",  ilu_fillin_level_ );
+            use_float_preconditioner_ = param.getDefault("linear_solver_float_preconditioner", use_float_preconditioner_ );
 
             // Check whether to use cpr approach
             const std::string cprSolver = "cpr";
@@ -89,6 +91,7 @@ namespace Opm
             linear_solver_use_amg_    = false;
             ilu_fillin_level_         = 0;
             ilu_relaxation_           = 0.9;
+            use_float_preconditioner_ = false;
         }
     };
 
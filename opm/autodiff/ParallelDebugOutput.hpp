@@ -19,7 +19,11 @@
 #ifndef OPM_PARALLELDEBUGOUTPUT_HEADER_INCLUDED
 #define OPM_PARALLELDEBUGOUTPUT_HEADER_INCLUDED
 
+#include <cstdint>
+#include <memory>
+#include <set>
 #include <unordered_set>
+#include <vector>
 
 #include <opm/common/data/SimulationDataContainer.hpp>
 #include <opm/output/eclipse/RestartValue.hpp>
@@ -258,6 +262,7 @@ namespace Opm
               eclipseState_( eclipseState ),
               schedule_(schedule),
               globalCellData_(new data::Solution),
+              wellsManagerStep_(-1),
               isIORank_(true),
               phaseUsage_(phaseUsage)
 
@@ -268,7 +273,8 @@ namespace Opm
             const CollectiveCommunication& comm = otherGrid.comm();
             if( comm.size() > 1 )
             {
-                std::set< int > send, recv;
+                std::set< int >& send = sendRanks_;
+                std::set< int >& recv = recvRanks_;
                 distributed_grid.switchToDistributedView();
                 toIORankComm_ = distributed_grid.comm();
                 isIORank_ = (distributed_grid.comm().rank() == ioRank);
@@ -358,13 +364,13 @@ namespace Opm
             const IndexMapStorageType& indexMaps_;
 
         public:
-            PackUnPackSimulationDataContainer( std::size_t numGlobalCells,
-                                               const data::Solution& localCellData,
+            PackUnPackSimulationDataContainer( const data::Solution& localCellData,
                                                data::Solution& globalCellData,
                                                const WellStateFullyImplicitBlackoil& localWellState,
                                                WellStateFullyImplicitBlackoil& globalWellState,
                                                const IndexMapType& localIndexMap,
                                                const IndexMapStorageType& indexMaps,
+                                               MessageBufferType& localBuffer,
                                                const bool isIORank )
             : localCellData_( localCellData ),
               globalCellData_( globalCellData ),
@@ -376,21 +382,11 @@ namespace Opm
 
                 if( isIORank )
                 {
-                    // add missing data to global cell data
-                    for (const auto& pair : localCellData_) {
-                        const std::string& key = pair.first;
-                        std::size_t container_size = numGlobalCells;
-                        auto ret = globalCellData_.insert(key, pair.second.dim,
-                                                std::vector<double>(container_size),
-                                                pair.second.target);
-                        assert(ret.second);
-                        DUNE_UNUSED_PARAMETER(ret.second); //dummy op to prevent warning with -DNDEBUG
-                    }
-
-                    MessageBufferType buffer;
-                    pack( 0, buffer );
+                    // the buffer keeps its capacity from the previous output step
+                    localBuffer.clear();
+                    pack( 0, localBuffer );
                     // the last index map is the local one
-                    doUnpack( indexMaps.back(), buffer );
+                    doUnpack( indexMaps.back(), localBuffer );
                 }
             }
 
@@ -603,42 +599,53 @@ namespace Opm
         {
             if( isIORank() )
             {
-                Dune::CpGrid& globalGrid = *grid_;
-                // TODO: make a dummy DynamicListEconLimited here for NOW for compilation and development
-                // TODO: NOT SURE whether it will cause problem for parallel running
-                // TODO: TO BE TESTED AND IMPROVED
-                const DynamicListEconLimited dynamic_list_econ_limited;
-                // Create wells and well state.
-                WellsManager wells_manager(eclipseState_,
-                                           schedule_,
-                                           wellStateStepNumber,
-                                           Opm::UgGridHelpers::numCells( globalGrid ),
-                                           Opm::UgGridHelpers::globalCell( globalGrid ),
-                                           Opm::UgGridHelpers::cartDims( globalGrid ),
-                                           Opm::UgGridHelpers::dimensions( globalGrid ),
-                                           Opm::UgGridHelpers::cell2Faces( globalGrid ),
-                                           Opm::UgGridHelpers::beginFaceCentroids( globalGrid ),
-                                           dynamic_list_econ_limited,
-                                           false,
-                                           // We need to pass the optionaly arguments
-                                           // as we get the following error otherwise
-                                           // with c++ (Debian 4.9.2-10) 4.9.2 and -std=c++11
-                                           // converting to ‘const std::unordered_set<std::basic_string<char> >’ from initializer list would use explicit constructor
-                                           std::unordered_set<std::string>());
-
-                const Wells* wells = wells_manager.c_wells();
-                globalWellState_.init(wells, *globalReservoirState_, globalWellState_, phaseUsage_ );
-                globalCellData_->clear();
+                if( ! canReuseWells( wellStateStepNumber ) )
+                {
+                    Dune::CpGrid& globalGrid = *grid_;
+                    // TODO: make a dummy DynamicListEconLimited here for NOW for compilation and development
+                    // TODO: NOT SURE whether it will cause problem for parallel running
+                    // TODO: TO BE TESTED AND IMPROVED
+                    const DynamicListEconLimited dynamic_list_econ_limited;
+                    // Create wells and well state.
+                    wellsManager_.reset( new WellsManager(eclipseState_,
+                                                          schedule_,
+                                                          wellStateStepNumber,
+                                                          Opm::UgGridHelpers::numCells( globalGrid ),
+                                                          Opm::UgGridHelpers::globalCell( globalGrid ),
+                                                          Opm::UgGridHelpers::cartDims( globalGrid ),
+                                                          Opm::UgGridHelpers::dimensions( globalGrid ),
+                                                          Opm::UgGridHelpers::cell2Faces( globalGrid ),
+                                                          Opm::UgGridHelpers::beginFaceCentroids( globalGrid ),
+                                                          dynamic_list_econ_limited,
+                                                          false,
+                                                          // We need to pass the optionaly arguments
+                                                          // as we get the following error otherwise
+                                                          // with c++ (Debian 4.9.2-10) 4.9.2 and -std=c++11
+                                                          // converting to ‘const std::unordered_set<std::basic_string<char> >’ from initializer list would use explicit constructor
+                                                          std::unordered_set<std::string>()) );
+                    wellsManagerStep_ = wellStateStepNumber;
+
+                    const Wells* wells = wellsManager_->c_wells();
+                    globalWellState_.init(wells, *globalReservoirState_, globalWellState_, phaseUsage_ );
+                }
+                prepareGlobalCellData( localCellData );
+            }
+
+            // The receive buffer sizes of the previous exchange are reused
+            // unless the messages have changed on some rank.
+            if( messageLayoutChanged( localWellState, localCellData ) )
+            {
+                // inserting the linkage again clears the cached sizes
+                toIORankComm_.insertRequest( sendRanks_, recvRanks_ );
             }
 
-            PackUnPackSimulationDataContainer packUnpack( numCells(),
-                                                          localCellData, *globalCellData_,
+            PackUnPackSimulationDataContainer packUnpack( localCellData, *globalCellData_,
                                                           localWellState, globalWellState_,
                                                           localIndexMap_, indexMaps_,
+                                                          localBuffer_,
                                                           isIORank() );
 
-            //toIORankComm_.exchangeCached( packUnpack );
-            toIORankComm_.exchange( packUnpack );
+            toIORankComm_.exchangeCached( packUnpack );
 #ifndef NDEBUG
             // make sure every process is on the same page
             toIORankComm_.barrier();
@@ -679,6 +686,75 @@ namespace Opm
         }
 
     protected:
+        // The wells of the global grid only change with the schedule, so
+        // they are kept until a schedule event has occurred.
+        bool canReuseWells( const int reportStep ) const
+        {
+            if( ! wellsManager_ || reportStep < wellsManagerStep_ )
+            {
+                return false;
+            }
+
+            // any schedule event may add wells or modify the wells, their
+            // completions or controls
+            const uint64_t all_events = ~uint64_t(0);
+            const auto& events = schedule_.getEvents();
+            for( int step = wellsManagerStep_ + 1; step <= reportStep; ++step )
+            {
+                if( events.hasEvent( all_events, step ) )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Allocate the global cell data for the fields of the local cell
+        // data, unless they are the same as for the previous output step.
+        // All values are overwritten by the exchange.
+        void prepareGlobalCellData( const data::Solution& localCellData )
+        {
+            bool sameFields = ( globalCellData_->size() == localCellData.size() );
+            for( auto it = localCellData.begin(); sameFields && it != localCellData.end(); ++it )
+            {
+                const auto global = globalCellData_->find( it->first );
+                sameFields = global != globalCellData_->end()
+                    && global->second.dim == it->second.dim
+                    && global->second.target == it->second.target;
+            }
+            if( sameFields )
+            {
+                return;
+            }
+
+            globalCellData_->clear();
+            for (const auto& pair : localCellData) {
+                globalCellData_->insert(pair.first, pair.second.dim,
+                                        std::vector<double>(numCells()),
+                                        pair.second.target);
+            }
+        }
+
+        // Whether the message to the I/O rank has changed its size on any
+        // rank since the previous exchange. The size is given by the
+        // number of fields and the local wells with their perforations.
+        bool messageLayoutChanged( const WellStateFullyImplicitBlackoil& localWellState,
+                                   const data::Solution& localCellData )
+        {
+            std::vector<int> layout;
+            layout.reserve( 2 + 2 * localWellState.wellMap().size() );
+            layout.push_back( localCellData.size() );
+            layout.push_back( localWellState.wellMap().size() );
+            for( const auto& well : localWellState.wellMap() )
+            {
+                layout.push_back( well.first.size() );
+                layout.push_back( well.second[ 2 ] );
+            }
+            const int changed = ( layout != messageLayout_ );
+            messageLayout_.swap( layout );
+            return toIORankComm_.max( changed ) > 0;
+        }
+
         std::unique_ptr< Dune::CpGrid >           grid_;
         const EclipseState&                       eclipseState_;
       const Schedule&                             schedule_;
@@ -690,6 +766,16 @@ namespace Opm
         std::unique_ptr<data::Solution>           globalCellData_;
         // this needs to be revised
         WellStateFullyImplicitBlackoil            globalWellState_;
+        // the wells of the global grid and the report step they were built for
+        std::unique_ptr<WellsManager>             wellsManager_;
+        int                                       wellsManagerStep_;
+        // the ranks sending to and receiving from this rank
+        std::set< int >                           sendRanks_;
+        std::set< int >                           recvRanks_;
+        // the layout of the message to the I/O rank of the previous exchange
+        std::vector<int>                          messageLayout_;
+        // buffer for the local data of the I/O rank
+        MessageBufferType                         localBuffer_;
         // true if we are on I/O rank
         bool                                      isIORank_;
         // Phase usage needed to convert solution to simulation data container
@@ -22,12 +22,19 @@
 
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/simulators/Tracer.hpp>
 #include <dune/common/version.hh>
 #include <dune/istl/preconditioner.hh>
 #include <dune/istl/paamg/smoother.hh>
 #include <dune/istl/paamg/pinfo.hh>
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
 
 namespace Opm
 {
@@ -98,6 +105,10 @@ namespace Opm
         upper.resize( A.N() );
         inv.resize( A.N() );
 
+        // the CRS structures might hold an older decomposition
+        lower.clear();
+        upper.clear();
+
         lower.reserveAdditional( 2*A.N() );
 
         // implement left looking variant with stored inverse
@@ -152,6 +163,49 @@ namespace Opm
           upper.rows_[ row+1 ] = colcount;
         }
       }
+
+      //! compute the level sets (wavefronts) of a triangular CRS structure.
+      //! The rows of one level only depend on rows of lower levels and can
+      //! therefore be processed concurrently. With reversed the CRS stores
+      //! the rows in reverse order (as the upper part of convertToCRS).
+      template<class CRS, class Index>
+      void computeLevelSets( const CRS& crs, const bool reversed,
+                             std::vector< Index >& levelRows,
+                             std::vector< Index >& levelStart )
+      {
+        const Index nRows = crs.rows();
+        std::vector< Index > level( nRows, 0 );
+        Index nLevels = 0;
+        for( Index row = 0; row < nRows; ++row )
+        {
+          Index rowLevel = 0;
+          for( Index col = crs.rows_[ row ]; col < crs.rows_[ row+1 ]; ++col )
+          {
+            const Index dependency = reversed ? nRows - 1 - crs.cols_[ col ] : crs.cols_[ col ];
+            assert( dependency < row );
+            rowLevel = std::max( rowLevel, level[ dependency ] + 1 );
+          }
+          level[ row ] = rowLevel;
+          nLevels = std::max( nLevels, rowLevel + 1 );
+        }
+
+        // sort the rows by level, keeping the row order within each level
+        levelStart.assign( nLevels+1, 0 );
+        for( Index row = 0; row < nRows; ++row )
+        {
+          ++levelStart[ level[ row ]+1 ];
+        }
+        for( Index l = 0; l < nLevels; ++l )
+        {
+          levelStart[ l+1 ] += levelStart[ l ];
+        }
+        std::vector< Index > position( levelStart.begin(), levelStart.end() - 1 );
+        levelRows.resize( nRows );
+        for( Index row = 0; row < nRows; ++row )
+        {
+          levelRows[ position[ level[ row ] ]++ ] = row;
+        }
+      }
     } // end namespace detail
 
 /// \brief A two-step version of an overlapping Schwarz preconditioner using one step ILU0 as
@@ -211,6 +265,12 @@ protected:
           }
       }
 
+      void clear()
+      {
+          values_.clear();
+          cols_.clear();
+      }
+
       void reserveAdditional( const size_type nonZeros )
       {
           const size_type needed = values_.size() + nonZeros ;
@@ -265,7 +325,8 @@ public:
           upper_(),
           inv_(),
           comm_(nullptr), w_(w),
-          relaxation_( std::abs( w - 1.0 ) > 1e-15 )
+          relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
+          iluIteration_( n )
     {
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
@@ -285,7 +346,8 @@ public:
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
-          relaxation_( std::abs( w - 1.0 ) > 1e-15 )
+          relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
+          iluIteration_( n )
     {
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
@@ -319,13 +381,30 @@ public:
           upper_(),
           inv_(),
           comm_(&comm), w_(w),
-          relaxation_( std::abs( w - 1.0 ) > 1e-15 )
+          relaxation_( std::abs( w - 1.0 ) > 1e-15 ),
+          iluIteration_( 0 )
     {
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
         init( reinterpret_cast<const Matrix&>(A), 0 );
     }
 
+    /*!
+      \brief Recompute the decomposition for new matrix values.
+
+      The matrix needs to have the same sparsity pattern as the one
+      the preconditioner was constructed with. The fill in level, the
+      relaxation factor and the communication object are kept.
+      \param A The matrix to operate on.
+    */
+    template<class BlockType, class Alloc>
+    void update (const Dune::BCRSMatrix<BlockType,Alloc>& A)
+    {
+        // BlockMatrix is a Subclass of FieldMatrix that just adds
+        // methods. Therefore this cast should be safe.
+        init( reinterpret_cast<const Matrix&>(A), iluIteration_ );
+    }
+
     /*!
       \brief Prepare the preconditioner.
 
@@ -344,13 +423,10 @@ public:
     */
     virtual void apply (Domain& v, const Range& d)
     {
+        OPM_TRACE_SCOPE("ParallelOverlappingILU0::apply");
         Range& md = const_cast<Range&>(d);
         copyOwnerToAll( md );
 
-        // iterator types
-        typedef typename Range ::block_type  dblock;
-        typedef typename Domain::block_type  vblock;
-
         const size_type iEnd = lower_.rows();
         const size_type lastRow = iEnd - 1;
         if( iEnd != upper_.rows() )
@@ -358,37 +434,33 @@ public:
             OPM_THROW(std::logic_error,"ILU: number of lower and upper rows must be the same");
         }
 
-        // lower triangular solve
-        for( size_type i=0; i<iEnd; ++ i )
+        if( useLevelSets_ )
         {
-          dblock rhs( d[ i ] );
-          const size_type rowI     = lower_.rows_[ i ];
-          const size_type rowINext = lower_.rows_[ i+1 ];
+            // Each row is computed exactly as in the sequential sweeps, only
+            // the rows of one level are distributed among the threads.
+            // Hence the result does not depend on the number of threads.
+            levelSetSolve( lowerLevelRows_, lowerLevelStart_,
+                           [&]( const size_type i ) { lowerSolveRow( i, d, v ); } );
 
-          for( size_type col = rowI; col < rowINext; ++ col )
-          {
-            lower_.values_[ col ].mmv( v[ lower_.cols_[ col ] ], rhs );
-          }
+            copyOwnerToAll( v );
 
-          v[ i ] = rhs;  // Lii = I
+            levelSetSolve( upperLevelRows_, upperLevelStart_,
+                           [&]( const size_type i ) { upperSolveRow( i, lastRow, v ); } );
         }
-
-        copyOwnerToAll( v );
-
-        for( size_type i=0; i<iEnd; ++ i )
+        else
         {
-            vblock& vBlock = v[ lastRow - i ];
-            vblock rhs ( vBlock );
-            const size_type rowI     = upper_.rows_[ i ];
-            const size_type rowINext = upper_.rows_[ i+1 ];
-
-            for( size_type col = rowI; col < rowINext; ++ col )
+            // lower triangular solve
+            for( size_type i=0; i<iEnd; ++ i )
             {
-                upper_.values_[ col ].mmv( v[ upper_.cols_[ col ] ], rhs );
+                lowerSolveRow( i, d, v );
             }
 
-            // apply inverse and store result
-            inv_[ i ].mv( rhs, vBlock);
+            copyOwnerToAll( v );
+
+            for( size_type i=0; i<iEnd; ++ i )
+            {
+                upperSolveRow( i, lastRow, v );
+            }
         }
 
         copyOwnerToAll( v );
@@ -398,6 +470,69 @@ public:
         }
     }
 
+    //! \brief Solve row i of Ly = d, Lii = I.
+    template <class D, class V>
+    void lowerSolveRow( const size_type i, const D& d, V& v ) const
+    {
+        typedef typename D::block_type  dblock;
+
+        dblock rhs( d[ i ] );
+        const size_type rowI     = lower_.rows_[ i ];
+        const size_type rowINext = lower_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            lower_.values_[ col ].mmv( v[ lower_.cols_[ col ] ], rhs );
+        }
+
+        v[ i ] = rhs;  // Lii = I
+    }
+
+    //! \brief Solve row lastRow - i of Ux = y, the upper part is stored in reverse order.
+    template <class V>
+    void upperSolveRow( const size_type i, const size_type lastRow, V& v ) const
+    {
+        typedef typename V::block_type  vblock;
+
+        vblock& vBlock = v[ lastRow - i ];
+        vblock rhs ( vBlock );
+        const size_type rowI     = upper_.rows_[ i ];
+        const size_type rowINext = upper_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            upper_.values_[ col ].mmv( v[ upper_.cols_[ col ] ], rhs );
+        }
+
+        // apply inverse and store result
+        inv_[ i ].mv( rhs, vBlock);
+    }
+
+    //! \brief Process the rows level by level, the rows of one level concurrently.
+    template <class RowSolver>
+    void levelSetSolve( const std::vector< size_type >& levelRows,
+                        const std::vector< size_type >& levelStart,
+                        const RowSolver& rowSolver ) const
+    {
+        const std::ptrdiff_t nLevels = levelStart.size() - 1;
+#if HAVE_OPENMP
+#pragma omp parallel
+#endif // HAVE_OPENMP
+        for( std::ptrdiff_t level = 0; level < nLevels; ++level )
+        {
+            const std::ptrdiff_t levelBegin = levelStart[ level ];
+            const std::ptrdiff_t levelEnd   = levelStart[ level+1 ];
+            // the implicit barrier at the end of the loop separates the levels
+#if HAVE_OPENMP
+#pragma omp for schedule(static)
+#endif // HAVE_OPENMP
+            for( std::ptrdiff_t k = levelBegin; k < levelEnd; ++k )
+            {
+                rowSolver( levelRows[ k ] );
+            }
+        }
+    }
+
     template <class V>
     void copyOwnerToAll( V& v ) const
     {
@@ -473,6 +608,19 @@ protected:
 
         // store ILU in simple CRS format
         detail::convertToCRS( *ILU, lower_, upper_, inv_ );
+
+        // Use level scheduling for the triangular solves if there are several
+        // threads and the levels are wide enough to amortize the synchronization.
+        useLevelSets_ = false;
+#if HAVE_OPENMP
+        if( omp_get_max_threads() > 1 && A.N() > 0 )
+        {
+            detail::computeLevelSets( lower_, false, lowerLevelRows_, lowerLevelStart_ );
+            detail::computeLevelSets( upper_, true, upperLevelRows_, upperLevelStart_ );
+            const size_type nLevels = std::max( lowerLevelStart_.size(), upperLevelStart_.size() ) - 1;
+            useLevelSets_ = A.N() >= minRowsPerLevel * nLevels;
+        }
+#endif // HAVE_OPENMP
     }
 
 protected:
@@ -485,6 +633,19 @@ protected:
     //! \brief The relaxation factor to use.
     const field_type w_;
     const bool relaxation_;
+    //! \brief The ILU fill in level.
+    const int iluIteration_;
+
+    //! \brief The minimum average number of rows per level for using the level sets.
+    static const size_type minRowsPerLevel = 64;
+    //! \brief Whether the triangular solves use the level sets below.
+    bool useLevelSets_;
+    //! \brief The rows of lower_ sorted by level and the start of each level.
+    std::vector< size_type > lowerLevelRows_;
+    std::vector< size_type > lowerLevelStart_;
+    //! \brief The rows of upper_ sorted by level and the start of each level.
+    std::vector< size_type > upperLevelRows_;
+    std::vector< size_type > upperLevelStart_;
 
 };
 
@@ -0,0 +1,141 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PVTCELLGROUPS_HEADER_INCLUDED
+#define OPM_PVTCELLGROUPS_HEADER_INCLUDED
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The cells of a property evaluation grouped by PVT region and by
+    /// a phase presence flag, so that the cells of a group use the same
+    /// tables and take the same branch. The groups are split into
+    /// chunks, which are evaluated in parallel.
+    class PvtCellGroups
+    {
+    public:
+        /// Group the evaluated cells. The grouping only depends on the
+        /// region and flag of each cell, so it is kept if these are the
+        /// same as in the last update, which is the common case for the
+        /// repeated property evaluations of a Newton iteration.
+        /// \param[in] cellPvtRegionIdx  the PVT region of each cell
+        /// \param[in] cells             the n cells evaluated
+        /// \param[in] presence          presence(i) is the flag of the
+        ///                              i'th evaluated cell
+        template <class Presence>
+        void update(const std::vector<int>& cellPvtRegionIdx,
+                    const std::vector<int>& cells,
+                    const Presence& presence)
+        {
+            const int n = cells.size();
+            bool same = (static_cast<int>(key_.size()) == n);
+            for (int i = 0; same && i < n; ++i) {
+                same = (key_[i] == 2 * cellPvtRegionIdx[cells[i]] + (presence(i) ? 1 : 0));
+            }
+            if (same) {
+                return;
+            }
+
+            // Counting sort of the cells by 2 * region + flag.
+            key_.resize(n);
+            int num_keys = 0;
+            for (int i = 0; i < n; ++i) {
+                key_[i] = 2 * cellPvtRegionIdx[cells[i]] + (presence(i) ? 1 : 0);
+                num_keys = std::max(num_keys, key_[i] + 1);
+            }
+            std::vector<int> start(num_keys + 1, 0);
+            for (int i = 0; i < n; ++i) {
+                ++start[key_[i] + 1];
+            }
+            for (int k = 0; k < num_keys; ++k) {
+                start[k + 1] += start[k];
+            }
+            order_.resize(n);
+            std::vector<int> pos(start.begin(), start.end() - 1);
+            for (int i = 0; i < n; ++i) {
+                order_[pos[key_[i]]++] = i;
+            }
+
+            const int chunk_size = 1024;
+            chunks_.clear();
+            for (int k = 0; k < num_keys; ++k) {
+                for (int begin = start[k]; begin < start[k + 1]; begin += chunk_size) {
+                    const int end = std::min(begin + chunk_size, start[k + 1]);
+                    chunks_.push_back(Chunk{ begin, end, unsigned(k / 2), k % 2 == 1 });
+                }
+            }
+        }
+
+        /// The number of chunks evaluated in parallel.
+        int numChunks() const
+        {
+            return chunks_.size();
+        }
+
+        /// Call eval(pvtRegionIdx, flag, i) for each evaluated cell i. An
+        /// exception thrown by eval is rethrown after all chunks are done.
+        template <class Eval>
+        void forEach(const Eval& eval) const
+        {
+            const int num_chunks = chunks_.size();
+            // exceptions must not leave the parallel region
+            std::exception_ptr exc;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic) if(num_chunks > 1)
+#endif // HAVE_OPENMP
+            for (int c = 0; c < num_chunks; ++c) {
+                const Chunk& chunk = chunks_[c];
+                try {
+                    for (int p = chunk.begin; p < chunk.end; ++p) {
+                        eval(chunk.region, chunk.flag, order_[p]);
+                    }
+                }
+                catch (...) {
+#if HAVE_OPENMP
+#pragma omp critical(PvtCellGroups_forEach)
+#endif // HAVE_OPENMP
+                    if (!exc) {
+                        exc = std::current_exception();
+                    }
+                }
+            }
+            if (exc) {
+                std::rethrow_exception(exc);
+            }
+        }
+
+    private:
+        struct Chunk
+        {
+            int begin;
+            int end;
+            unsigned region;
+            bool flag;
+        };
+
+        std::vector<int> key_;
+        std::vector<int> order_;
+        std::vector<Chunk> chunks_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PVTCELLGROUPS_HEADER_INCLUDED
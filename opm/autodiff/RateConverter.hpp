@@ -26,6 +26,7 @@
 #include <opm/core/simulator/BlackoilState.hpp>
 #include <opm/grid/utility/RegionMapping.hpp>
 #include <opm/core/linalg/ParallelIstlInformation.hpp>
+#include <opm/simulators/BatchedAllReduce.hpp>
 
 #include <dune/grid/common/gridenums.hh>
 #include <algorithm>
@@ -36,6 +37,10 @@
 #include <unordered_map>
 #include <utility>
 #include <vector>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
 /**
  * \file
  * Facility for converting component rates at surface conditions to
@@ -468,14 +473,18 @@ namespace Opm {
             void defineState(const EbosSimulator& simulator)
             {
 
-                // create map from cell to region
+                // create map from cell to (dense) region index
                 // and set all attributes to zero
                 const auto& grid = simulator.vanguard().grid();
                 const unsigned numCells = grid.size(/*codim=*/0);
+                const auto& active = rmap_.activeRegions();
+                const std::vector<RegionId> regions(active.begin(), active.end());
+                const int numRegions = regions.size();
                 std::vector<int> cell2region(numCells, -1);
-                for (const auto& reg : rmap_.activeRegions()) {
+                for (int regIdx = 0; regIdx < numRegions; ++regIdx) {
+                    const auto& reg = regions[regIdx];
                     for (const auto& cell : rmap_.cells(reg)) {
-                        cell2region[cell] = reg;
+                        cell2region[cell] = regIdx;
                     }
                     auto& ra = attr_.attributes(reg);
                     ra.pressure = 0.0;
@@ -490,69 +499,89 @@ namespace Opm {
                 const auto& gridView = simulator.gridView();
                 const auto& comm = gridView.comm();
 
-                const auto& elemEndIt = gridView.template end</*codim=*/0>();
-                for (auto elemIt = gridView.template begin</*codim=*/0>();
+                // the intensive quantities of the last linearization are read
+                // directly from the cache if it is valid. The cache is
+                // invalidated for all cells at once.
+                const bool cached = numCells > 0 &&
+                    simulator.model().cachedIntensiveQuantities(0, /*timeIdx=*/0) != nullptr;
+
+                int numThreads = 1;
+#if HAVE_OPENMP
+                if (cached) {
+                    numThreads = omp_get_max_threads();
+                }
+#endif // HAVE_OPENMP
+                // per thread sums of the attributes, reduced in a fixed order
+                std::vector<std::vector<Attributes> > threadSums(numThreads, std::vector<Attributes>(numRegions));
+
+                std::vector<unsigned> interiorCells;
+                if (cached) {
+                    interiorCells.reserve(numCells);
+                }
+
+                const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+                for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
                      elemIt != elemEndIt;
                      ++elemIt)
                 {
-
-                    const auto& elem = *elemIt;
-                    if (elem.partitionType() != Dune::InteriorEntity)
-                        continue;
-
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    elemCtx.updatePrimaryStencil(*elemIt);
                     const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& fs = intQuants.fluidState();
-                    // use pore volume weighted averages.
-                    const double pv_cell =
-                            simulator.model().dofTotalVolume(cellIdx)
-                            * intQuants.porosity().value();
-
-                    // only count oil and gas filled parts of the domain
-                    double hydrocarbon = 1.0;
-                    const auto& pu = phaseUsage_;
-                    if (Details::PhaseUsed::water(pu)) {
-                        hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
+                    if (cached) {
+                        interiorCells.push_back(cellIdx);
+                    }
+                    else {
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                        const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                        addCellAttributes_(simulator, cellIdx, intQuants, cell2region, threadSums[0]);
                     }
+                }
 
-                    int reg = cell2region[cellIdx];
-                    assert(reg >= 0);
-                    auto& ra = attr_.attributes(reg);
-                    auto& p  = ra.pressure;
-                    auto& T  = ra.temperature;
-                    auto& rs  = ra.rs;
-                    auto& rv  = ra.rv;
-                    auto& pv  = ra.pv;
-
-                    // sum p, rs, rv, and T.
-                    double hydrocarbonPV = pv_cell*hydrocarbon;
-                    pv += hydrocarbonPV;
-                    p += fs.pressure(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
-                    rs += fs.Rs().value()*hydrocarbonPV;
-                    rv += fs.Rv().value()*hydrocarbonPV;
-                    T += fs.temperature(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
+                if (cached) {
+                    const int numInterior = interiorCells.size();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif // HAVE_OPENMP
+                    for (int i = 0; i < numInterior; ++i) {
+                        int threadIdx = 0;
+#if HAVE_OPENMP
+                        threadIdx = omp_get_thread_num();
+#endif // HAVE_OPENMP
+                        const unsigned cellIdx = interiorCells[i];
+                        const auto& intQuants = *simulator.model().cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+                        addCellAttributes_(simulator, cellIdx, intQuants, cell2region, threadSums[threadIdx]);
+                    }
                 }
 
-                for (const auto& reg : rmap_.activeRegions()) {
-                      auto& ra = attr_.attributes(reg);
-                      auto& p  = ra.pressure;
-                      auto& T  = ra.temperature;
-                      auto& rs  = ra.rs;
-                      auto& rv  = ra.rv;
-                      auto& pv  = ra.pv;
-                      // communicate sums
-                      p = comm.sum(p);
-                      T = comm.sum(T);
-                      rs = comm.sum(rs);
-                      rv = comm.sum(rv);
-                      pv = comm.sum(pv);
-                      // compute average
-                      p /= pv;
-                      T /= pv;
-                      rs /= pv;
-                      rv /= pv;
+                // communicate the sums of all regions in a single collective
+                BatchedAllReduce reduction(comm);
+                std::vector<BatchedAllReduce::Handle> handles(numRegions);
+                for (int regIdx = 0; regIdx < numRegions; ++regIdx) {
+                    Attributes sum;
+                    for (const auto& sums : threadSums) {
+                        sum.pressure += sums[regIdx].pressure;
+                        sum.temperature += sums[regIdx].temperature;
+                        sum.rs += sums[regIdx].rs;
+                        sum.rv += sums[regIdx].rv;
+                        sum.pv += sums[regIdx].pv;
+                    }
+                    handles[regIdx] = reduction.sum(sum.pressure);
+                    reduction.sum(sum.temperature);
+                    reduction.sum(sum.rs);
+                    reduction.sum(sum.rv);
+                    reduction.sum(sum.pv);
+                }
+                reduction.execute();
+
+                for (int regIdx = 0; regIdx < numRegions; ++regIdx) {
+                    auto& ra = attr_.attributes(regions[regIdx]);
+                    const auto h = handles[regIdx];
+                    const double pv = reduction[h + 4];
+                    // compute average
+                    ra.pressure = reduction[h] / pv;
+                    ra.temperature = reduction[h + 1] / pv;
+                    ra.rs = reduction[h + 2] / pv;
+                    ra.rv = reduction[h + 3] / pv;
+                    ra.pv = pv;
                 }
             }
 
@@ -765,6 +794,43 @@ namespace Opm {
              */
             const RegionMapping<Region> rmap_;
 
+            /**
+             * Add the pore volume weighted hydrocarbon state of a single
+             * cell to the sums of its region.
+             */
+            template <class EbosSimulator, class IntensiveQuantities, class Sums>
+            void addCellAttributes_(const EbosSimulator& simulator,
+                                    const unsigned cellIdx,
+                                    const IntensiveQuantities& intQuants,
+                                    const std::vector<int>& cell2region,
+                                    Sums& sums) const
+            {
+                const auto& fs = intQuants.fluidState();
+                // use pore volume weighted averages.
+                const double pv_cell =
+                        simulator.model().dofTotalVolume(cellIdx)
+                        * intQuants.porosity().value();
+
+                // only count oil and gas filled parts of the domain
+                double hydrocarbon = 1.0;
+                const auto& pu = phaseUsage_;
+                if (Details::PhaseUsed::water(pu)) {
+                    hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
+                }
+
+                const int regIdx = cell2region[cellIdx];
+                assert(regIdx >= 0);
+                auto& ra = sums[regIdx];
+
+                // sum p, rs, rv, and T.
+                const double hydrocarbonPV = pv_cell*hydrocarbon;
+                ra.pv += hydrocarbonPV;
+                ra.pressure += fs.pressure(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
+                ra.rs += fs.Rs().value()*hydrocarbonPV;
+                ra.rv += fs.Rv().value()*hydrocarbonPV;
+                ra.temperature += fs.temperature(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
+            }
+
             /**
              * Derived property attributes for each active region.
              */
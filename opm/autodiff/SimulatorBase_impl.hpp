@@ -322,6 +322,10 @@ namespace Opm
                                            well_state, dynamic_list_econ_limited);
         }
 
+        // make sure all asynchronously dispatched output has been written
+        output_writer_.flush();
+        output_writer_.addOutputStatistics(report);
+
         // Stop timer and create timing report
         total_timer.stop();
         report.total_time = total_timer.secsSinceStart();
@@ -37,6 +37,7 @@
 #include <opm/common/ErrorMacros.hpp>
 
 #include <dune/common/unused.hh>
+#include <algorithm>
 
 namespace Opm {
 
@@ -187,6 +188,18 @@ public:
             ebosSimulator_.model().addAuxiliaryModule(auxMod);
         }
 
+        // The model and the nonlinear solver are kept for all report steps.
+        Dune::Timer setupTimer;
+        setupTimer.start();
+        auto solver = createSolver(well_model);
+        const double solverSetupTime = setupTimer.stop();
+        report.setup_time += solverSetupTime;
+
+        // accumulated time of the report step setups which rebuilt the wells,
+        // used to estimate the time saved by the reused setups
+        double wellRebuildTime = 0.0;
+        int numWellRebuilds = 0;
+
         // Main simulation loop.
         while (!timer.done()) {
             // Report timestep.
@@ -200,9 +213,25 @@ public:
             // Run a multiple steps of the solver depending on the time step control.
             solver_timer.start();
 
+            setupTimer.reset();
+            setupTimer.start();
             well_model.beginReportStep(timer.currentStepNum());
-
-            auto solver = createSolver(well_model);
+            const double stepSetupTime = setupTimer.stop();
+
+            report.setup_time += stepSetupTime;
+            ++report.total_setups;
+            // previously the model and the solver were created for every report step
+            report.setup_time_saved += solverSetupTime;
+            if (well_model.wellsReused()) {
+                ++report.total_setups_reused;
+                if (numWellRebuilds > 0) {
+                    report.setup_time_saved += std::max(wellRebuildTime/numWellRebuilds - stepSetupTime, 0.0);
+                }
+            }
+            else {
+                wellRebuildTime += stepSetupTime;
+                ++numWellRebuilds;
+            }
 
             // write the inital state at the report stage
             if (timer.initialStep()) {
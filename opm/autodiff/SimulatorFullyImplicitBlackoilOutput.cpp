@@ -30,7 +30,7 @@
 #include <opm/core/simulator/BlackoilState.hpp>
 #include <opm/core/utility/DataMap.hpp>
 #include <opm/autodiff/Compat.hpp>
-#include <opm/simulators/vtk/writeVtkData.hpp>
+#include <opm/simulators/vtk/VtkWriter.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
@@ -64,12 +64,22 @@ namespace Opm
                         const int step,
                         const std::string& output_dir)
     {
+        const VtkWriter writer(grid);
+        outputStateVtk(writer, state, step, output_dir);
+    }
+
+    void outputStateVtk(const VtkWriter& writer,
+                        const SimulationDataContainer& state,
+                        const int step,
+                        const std::string& output_dir)
+    {
+        const UnstructuredGrid& grid = writer.grid();
         // Write data in VTK format.
         std::ostringstream vtkfilename;
         vtkfilename << output_dir << "/vtk_files";
         ensureDirectoryExists(vtkfilename.str());
         vtkfilename << "/output-" << std::setw(3) << std::setfill('0') << step << ".vtu";
-        std::ofstream vtkfile(vtkfilename.str().c_str());
+        std::ofstream vtkfile(vtkfilename.str().c_str(), std::ios::binary);
         if (!vtkfile) {
             OPM_THROW(std::runtime_error, "Failed to open " << vtkfilename.str());
         }
@@ -86,7 +96,7 @@ namespace Opm
                                   AutoDiffGrid::dimensions(grid),
                                   state.faceflux(), cell_velocity);
         dm["velocity"] = &cell_velocity;
-        Opm::writeVtkData(grid, dm, vtkfile);
+        writer.write(dm, vtkfile);
     }
 
     void outputWellStateMatlab(const Opm::WellState& well_state,
@@ -166,7 +176,7 @@ namespace Opm
                                   AutoDiffGrid::dimensions(grid),
                                   state.faceflux(), cell_velocity);
         writer.addCellData(cell_velocity, "velocity", Dune::CpGrid::dimension);
-        writer.pwrite(vtkfilename.str(), vtkpath.str(), std::string("."), Dune::VTK::ascii);
+        writer.pwrite(vtkfilename.str(), vtkpath.str(), std::string("."), Dune::VTK::appendedraw);
     }
 #endif
 
@@ -358,6 +368,26 @@ namespace Opm
     }
 
 
+    void BlackoilOutputWriter::flush()
+    {
+        if( asyncOutput_ ) {
+            asyncOutput_->flush();
+        }
+    }
+
+
+    void BlackoilOutputWriter::addOutputStatistics(SimulatorReport& report) const
+    {
+        if( asyncOutput_ ) {
+            const ThreadHandle::Statistics stats = asyncOutput_->statistics();
+            report.total_output_writes = stats.executedObjects;
+            report.output_queue_max_depth = stats.maxQueueDepth;
+            report.output_wait_time = stats.waitTime;
+            report.output_latency_time = stats.latencyTime;
+        }
+    }
+
+
     bool BlackoilOutputWriter::isRestart() const {
         const auto& initconfig = eclipseState_.getInitConfig();
         return initconfig.restartRequested();
@@ -47,9 +47,11 @@
 #include <opm/parser/eclipse/EclipseState/SummaryConfig/SummaryConfig.hpp>
 #include <opm/parser/eclipse/EclipseState/InitConfig/InitConfig.hpp>
 #include <opm/simulators/ensureDirectoryExists.hpp>
+#include <opm/simulators/vtk/VtkWriter.hpp>
 
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <iomanip>
 #include <fstream>
 #include <thread>
@@ -71,6 +73,11 @@ namespace Opm
                         const int step,
                         const std::string& output_dir);
 
+    void outputStateVtk(const VtkWriter& writer,
+                        const Opm::SimulationDataContainer& state,
+                        const int step,
+                        const std::string& output_dir);
+
     void outputWellStateMatlab(const Opm::WellState& well_state,
                                const int step,
                                const std::string& output_dir);
@@ -155,7 +162,8 @@ namespace Opm
     class BlackoilVTKWriter : public BlackoilSubWriter {
         public:
             BlackoilVTKWriter( const Grid& grid,
-                               const std::string& outputDir )
+                               const std::string& outputDir,
+                               const bool /*compressed*/ = false )
                 : BlackoilSubWriter( outputDir )
                 , grid_( grid )
         {}
@@ -172,6 +180,29 @@ namespace Opm
             const Grid& grid_;
     };
 
+    template <>
+    class BlackoilVTKWriter< UnstructuredGrid > : public BlackoilSubWriter {
+        public:
+            BlackoilVTKWriter( const UnstructuredGrid& grid,
+                               const std::string& outputDir,
+                               const bool compressed = false )
+                : BlackoilSubWriter( outputDir )
+                , writer_( grid, compressed )
+        {}
+
+            void writeTimeStep(const SimulatorTimerInterface& timer,
+                    const SimulationDataContainer& state,
+                    const WellStateFullyImplicitBlackoil&,
+                    bool /*substep*/ = false) override
+            {
+                outputStateVtk(writer_, state, timer.currentStepNum(), outputDir_);
+            }
+
+        protected:
+            // keeps the encoded grid between the time steps
+            const VtkWriter writer_;
+    };
+
     template< typename Grid >
     class BlackoilMatlabWriter : public BlackoilSubWriter
     {
@@ -277,6 +308,15 @@ namespace Opm
                                  const RestartValue::ExtraVector& extraRestartData,
                                  bool substep );
 
+        /*!
+         * \brief Block until all pending asynchronous writes have been completed,
+         *        e.g. before a restart file is used or the simulation terminates.
+         */
+        void flush();
+
+        /** \brief Add the counters of the asynchronous output queue to the report. */
+        void addOutputStatistics(SimulatorReport& report) const;
+
         /** \brief return output directory */
         const std::string& outputDirectory() const { return outputDir_; }
 
@@ -358,7 +398,8 @@ namespace Opm
             if ( param.getDefault("output_vtk",false) )
             {
                 vtkWriter_
-                    .reset(new BlackoilVTKWriter< Grid >( grid, outputDir_ ));
+                    .reset(new BlackoilVTKWriter< Grid >( grid, outputDir_,
+                                                          param.getDefault("output_vtk_compressed", false) ));
             }
 
             auto output_matlab = param.getDefault("output_matlab", false );
@@ -394,7 +435,10 @@ namespace Opm
             {
                 const bool isIORank = parallelOutput_ ? parallelOutput_->isIORank() : true;
 #if HAVE_PTHREAD
-                asyncOutput_.reset( new ThreadHandle( isIORank ) );
+                // limit the number of pending writes, each of which holds a
+                // copy of the (global) state
+                const int queueSize = param.getDefault("async_output_queue_size", 4);
+                asyncOutput_.reset( new ThreadHandle( isIORank, std::max( queueSize, 0 ) ) );
 #else
                 OPM_THROW(std::runtime_error,"Pthreads were not found, cannot enable async_output");
 #endif
@@ -29,6 +29,8 @@
 #include <opm/autodiff/RateConverter.hpp>
 #include <opm/autodiff/ISTLSolver.hpp>
 
+#include <array>
+
 namespace Opm
 {
 
@@ -104,6 +106,10 @@ namespace Opm
 
         typedef DenseAd::Evaluation<double, /*size=*/numEq + numWellEq> EvalWell;
 
+        // per component values at a perforation. Only the first num_components_
+        // entries are used, which never exceeds the number of well equations.
+        typedef std::array<EvalWell, numWellEq> EvalWellComponents;
+
         using Base::contiSolventEqIdx;
         using Base::contiPolymerEqIdx;
         static const int contiEnergyEqIdx = Indices::contiEnergyEqIdx;
@@ -139,6 +145,8 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const;
 
+        virtual void writeSystemSnapshot(LinearSystemSnapshotWriter& writer) const;
+
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
         virtual void recoverWellSolutionAndUpdateWellState(const BVector& x,
@@ -227,6 +235,15 @@ namespace Opm
         // the saturations in the well bore under surface conditions at the beginning of the time step
         std::vector<double> F0_;
 
+        // workspaces of computeWellConnectionPressures(), kept between the calls to
+        // avoid reallocating them in every nonlinear iteration
+        std::vector<double> b_perf_;
+        std::vector<double> rsmax_perf_;
+        std::vector<double> rvmax_perf_;
+        std::vector<double> surf_dens_perf_;
+        std::vector<double> perf_component_rates_;
+        std::vector<double> q_out_perf_;
+
         // TODO: this function should be moved to the base class.
         // while it faces chanllenges for MSWell later, since the calculation of bhp
         // based on THP is never implemented for MSWell yet.
@@ -285,9 +302,9 @@ namespace Opm
 
         // TODO: to check whether all the paramters are required
         void computePerfRate(const IntensiveQuantities& intQuants,
-                             const std::vector<EvalWell>& mob_perfcells_dense,
+                             const EvalWellComponents& mob_perfcells_dense,
                              const double Tw, const EvalWell& bhp, const double& cdp,
-                             const bool& allow_cf, std::vector<EvalWell>& cq_s,
+                             const bool& allow_cf, EvalWellComponents& cq_s,
                              double& perf_dis_gas_rate, double& perf_vap_oil_rate) const;
 
         // TODO: maybe we should provide a light version of computePerfRate, which does not include the
@@ -301,18 +318,18 @@ namespace Opm
                                                         const std::vector<double>& initial_potential) const;
 
         template <class ValueType>
-        ValueType calculateBhpFromThp(const std::vector<ValueType>& rates, const int control_index) const;
+        ValueType calculateBhpFromThp(const std::array<ValueType, 3>& rates, const int control_index) const;
 
-        double calculateThpFromBhp(const std::vector<double>& rates, const int control_index, const double bhp) const;
+        double calculateThpFromBhp(const std::array<double, 3>& rates, const int control_index, const double bhp) const;
 
         // get the mobility for specific perforation
         void getMobility(const Simulator& ebosSimulator,
                          const int perf,
-                         std::vector<EvalWell>& mob) const;
+                         EvalWellComponents& mob) const;
 
         void updateWaterMobilityWithPolymer(const Simulator& ebos_simulator,
                                             const int perf,
-                                            std::vector<EvalWell>& mob_water) const;
+                                            EvalWellComponents& mob_water) const;
     };
 
 }
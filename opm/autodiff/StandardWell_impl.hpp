@@ -136,7 +136,8 @@ namespace Opm
             const int control = well_controls_get_current(wc);
 
             const Opm::PhaseUsage& pu = phaseUsage();
-            std::vector<EvalWell> rates(3, 0.0);
+            std::array<EvalWell, 3> rates;
+            rates.fill(0.0);
             if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 rates[ Water ]= getQs(pu.phase_pos[ Water]);
             }
@@ -394,12 +395,13 @@ namespace Opm
     void
     StandardWell<TypeTag>::
     computePerfRate(const IntensiveQuantities& intQuants,
-                    const std::vector<EvalWell>& mob_perfcells_dense,
+                    const EvalWellComponents& mob_perfcells_dense,
                     const double Tw, const EvalWell& bhp, const double& cdp,
-                    const bool& allow_cf, std::vector<EvalWell>& cq_s,
+                    const bool& allow_cf, EvalWellComponents& cq_s,
                     double& perf_dis_gas_rate, double& perf_vap_oil_rate) const
     {
-        std::vector<EvalWell> cmix_s(num_components_,0.0);
+        assert(num_components_ <= numWellEq);
+        EvalWellComponents cmix_s;
         for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
             cmix_s[componentIdx] = wellSurfaceVolumeFraction(componentIdx);
         }
@@ -407,7 +409,8 @@ namespace Opm
         const EvalWell pressure = extendEval(fs.pressure(FluidSystem::oilPhaseIdx));
         const EvalWell rs = extendEval(fs.Rs());
         const EvalWell rv = extendEval(fs.Rv());
-        std::vector<EvalWell> b_perfcells_dense(num_components_, 0.0);
+        EvalWellComponents b_perfcells_dense;
+        b_perfcells_dense.fill(0.0);
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
             if (!FluidSystem::phaseIsActive(phaseIdx)) {
                 continue;
@@ -583,8 +586,10 @@ namespace Opm
 
             const int cell_idx = well_cells_[perf];
             const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
-            std::vector<EvalWell> cq_s(num_components_,0.0);
-            std::vector<EvalWell> mob(num_components_, 0.0);
+            EvalWellComponents cq_s;
+            cq_s.fill(0.0);
+            EvalWellComponents mob;
+            mob.fill(0.0);
             getMobility(ebosSimulator, perf, mob);
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
@@ -786,10 +791,10 @@ namespace Opm
     StandardWell<TypeTag>::
     getMobility(const Simulator& ebosSimulator,
                 const int perf,
-                std::vector<EvalWell>& mob) const
+                EvalWellComponents& mob) const
     {
         const int cell_idx = well_cells_[perf];
-        assert (int(mob.size()) == num_components_);
+        assert (num_components_ <= int(mob.size()));
         const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
         const auto& materialLawManager = ebosSimulator.problem().materialLawManager();
 
@@ -997,7 +1002,7 @@ namespace Opm
                 if (well_controls_iget_type(wc, current) == THP) {
 
                     // Calculate bhp from thp control and well rates
-                    std::vector<double> rates(3, 0.0); // the vfp related only supports three phases for the moment
+                    std::array<double, 3> rates{{0.0, 0.0, 0.0}}; // the vfp related only supports three phases for the moment
 
                     const Opm::PhaseUsage& pu = phaseUsage();
                     if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
@@ -1046,11 +1051,18 @@ namespace Opm
                                 const std::string msg = " Setting all rates to be zero for well " + name()
                                                       + " due to zero target rate for the phase that does not exist in the wellbore."
                                                       + " however, there is no unique solution for the situation";
+                                // the well states may be updated concurrently by BlackoilWellModel
+#if HAVE_OPENMP
+#pragma omp critical(StandardWell_updateWellState_log)
+#endif // HAVE_OPENMP
                                 OpmLog::warning("NOT_UNIQUE_WELL_SOLUTION", msg);
                             } else {
                                 const std::string msg = " Setting all rates to be zero for well " + name()
                                                       + " due to un-solvable situation. There is non-zero target for the phase "
                                                       + " that does not exist in the wellbore for the situation";
+#if HAVE_OPENMP
+#pragma omp critical(StandardWell_updateWellState_log)
+#endif // HAVE_OPENMP
                                 OpmLog::warning("NON_SOLVABLE_WELL_SOLUTION", msg);
                             }
 
@@ -1090,7 +1102,7 @@ namespace Opm
                     well_state.thp()[index_of_well_] = thp_target;
                 } else { // otherwise we calculate the thp from the bhp value
                     const Opm::PhaseUsage& pu = phaseUsage();
-                    std::vector<double> rates(3, 0.0);
+                    std::array<double, 3> rates{{0.0, 0.0, 0.0}};
 
                     if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                         rates[ Water ] = well_state.wellRates()[index_of_well_*np + pu.phase_pos[ Water ] ];
@@ -1147,7 +1159,7 @@ namespace Opm
             well_state.thp()[well_index] = target;
 
             const Opm::PhaseUsage& pu = phaseUsage();
-            std::vector<double> rates(3, 0.0);
+            std::array<double, 3> rates{{0.0, 0.0, 0.0}};
             if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 rates[ Water ] = well_state.wellRates()[well_index*np + pu.phase_pos[ Water ] ];
             }
@@ -1365,7 +1377,8 @@ namespace Opm
         //    component) exiting up the wellbore from each perforation,
         //    taking into account flow from lower in the well, and
         //    in/out-flow at each perforation.
-        std::vector<double> q_out_perf(nperf*num_comp);
+        std::vector<double>& q_out_perf = q_out_perf_;
+        q_out_perf.resize(nperf*num_comp);
 
         // TODO: investigate whether we should use the following techniques to calcuate the composition of flows in the wellbore
         // Iterate over well perforations from bottom to top.
@@ -1387,9 +1400,11 @@ namespace Opm
         //    absolute values of the surface rates divided by their sum.
         //    Then compute volume ratios (formation factors) for each perforation.
         //    Finally compute densities for the segments associated with each perforation.
-        std::vector<double> mix(num_comp,0.0);
-        std::vector<double> x(num_comp);
-        std::vector<double> surf_dens(num_comp);
+        assert(num_comp <= numWellEq);
+        std::array<double, numWellEq> mix;
+        mix.fill(0.0);
+        std::array<double, numWellEq> x;
+        std::array<double, numWellEq> surf_dens;
 
         for (int perf = 0; perf < nperf; ++perf) {
             // Find component mix.
@@ -1441,7 +1456,7 @@ namespace Opm
             }
 
             // Compute segment density.
-            perf_densities_[perf] = std::inner_product(surf_dens.begin(), surf_dens.end(), mix.begin(), 0.0) / volrat;
+            perf_densities_[perf] = std::inner_product(surf_dens.begin(), surf_dens.begin() + num_comp, mix.begin(), 0.0) / volrat;
         }
     }
 
@@ -1570,7 +1585,8 @@ namespace Opm
         // Compute densities
         const int nperf = number_of_perforations_;
         const int np = number_of_phases_;
-        std::vector<double> perfRates(b_perf.size(),0.0);
+        std::vector<double>& perfRates = perf_component_rates_;
+        perfRates.assign(b_perf.size(), 0.0);
 
         for (int perf = 0; perf < nperf; ++perf) {
             for (int comp = 0; comp < np; ++comp) {
@@ -1600,12 +1616,9 @@ namespace Opm
          // 1. Compute properties required by computeConnectionPressureDelta().
          //    Note that some of the complexity of this part is due to the function
          //    taking std::vector<double> arguments, and not Eigen objects.
-         std::vector<double> b_perf;
-         std::vector<double> rsmax_perf;
-         std::vector<double> rvmax_perf;
-         std::vector<double> surf_dens_perf;
-         computePropertiesForWellConnectionPressures(ebosSimulator, well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
-         computeWellConnectionDensitesPressures(well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
+         //    The member workspaces are reused to avoid allocations in every iteration.
+         computePropertiesForWellConnectionPressures(ebosSimulator, well_state, b_perf_, rsmax_perf_, rvmax_perf_, surf_dens_perf_);
+         computeWellConnectionDensitesPressures(well_state, b_perf_, rsmax_perf_, rvmax_perf_, surf_dens_perf_);
     }
 
 
@@ -1704,6 +1717,27 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    writeSystemSnapshot(LinearSystemSnapshotWriter& writer) const
+    {
+        if ( jacobianContainsWellContributions() )
+        {
+            // the well is part of the reservoir matrix
+            return;
+        }
+
+        const std::string prefix = "well/" + name() + "/";
+        writer.writeMatrix(prefix + "B", duneB_);
+        writer.writeMatrix(prefix + "C", duneC_);
+        writer.writeMatrix(prefix + "invD", invDuneD_);
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -1751,8 +1785,10 @@ namespace Opm
             const int cell_idx = well_cells_[perf];
             const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
             // flux for each perforation
-            std::vector<EvalWell> cq_s(num_components_, 0.0);
-            std::vector<EvalWell> mob(num_components_, 0.0);
+            EvalWellComponents cq_s;
+            cq_s.fill(0.0);
+            EvalWellComponents mob;
+            mob.fill(0.0);
             getMobility(ebosSimulator, perf, mob);
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
@@ -1808,7 +1844,7 @@ namespace Opm
                 if (well_controls_iget_type(well_controls_, ctrl_index) == THP) {
                     const Opm::PhaseUsage& pu = phaseUsage();
 
-                    std::vector<double> rates(3, 0.0);
+                    std::array<double, 3> rates{{0.0, 0.0, 0.0}};
                     if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
                         rates[ Water ] = potentials[pu.phase_pos[ Water ] ];
                     }
@@ -2018,7 +2054,7 @@ namespace Opm
     template<class ValueType>
     ValueType
     StandardWell<TypeTag>::
-    calculateBhpFromThp(const std::vector<ValueType>& rates,
+    calculateBhpFromThp(const std::array<ValueType, 3>& rates,
                         const int control_index) const
     {
         // TODO: when well is under THP control, the BHP is dependent on the rates,
@@ -2027,7 +2063,6 @@ namespace Opm
         // so iterations on a higher level will be required. Some investigation might be needed when
         // we face problems under THP control.
 
-        assert(int(rates.size()) == 3); // the vfp related only supports three phases now.
 
         const ValueType aqua = rates[Water];
         const ValueType liquid = rates[Oil];
@@ -2069,11 +2104,10 @@ namespace Opm
     template<typename TypeTag>
     double
     StandardWell<TypeTag>::
-    calculateThpFromBhp(const std::vector<double>& rates,
+    calculateThpFromBhp(const std::array<double, 3>& rates,
                         const int control_index,
                         const double bhp) const
     {
-        assert(int(rates.size()) == 3); // the vfp related only supports three phases now.
 
         const double aqua = rates[Water];
         const double liquid = rates[Oil];
@@ -2118,7 +2152,7 @@ namespace Opm
     StandardWell<TypeTag>::
     updateWaterMobilityWithPolymer(const Simulator& ebos_simulator,
                                    const int perf,
-                                   std::vector<EvalWell>& mob) const
+                                   EvalWellComponents& mob) const
     {
         const int cell_idx = well_cells_[perf];
         const auto& int_quant = *(ebos_simulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
@@ -2142,7 +2176,8 @@ namespace Opm
             // compute the well water velocity with out shear effects.
             const bool allow_cf = crossFlowAllowed(ebos_simulator);
             const EvalWell& bhp = getBhp();
-            std::vector<EvalWell> cq_s(num_components_,0.0);
+            EvalWellComponents cq_s;
+            cq_s.fill(0.0);
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
             computePerfRate(int_quant, mob, well_index_[perf], bhp, perf_pressure_diffs_[perf], allow_cf,
@@ -648,6 +648,13 @@ namespace Opm
 
 
             const Opm::PhaseUsage& pu = fluid_->phaseUsage();
+            // the THP of the producers is computed for all of them in one batch
+            std::vector<int> prod_table_id(nw, -1);
+            std::vector<double> prod_aqua(nw, 0.0);
+            std::vector<double> prod_liquid(nw, 0.0);
+            std::vector<double> prod_vapour(nw, 0.0);
+            std::vector<double> prod_bhp(nw, 0.0);
+            std::vector<double> prod_alq(nw, 0.0);
             //Loop over all wells
 #pragma omp parallel for schedule(static)
             for (int w = 0; w < nw; ++w) {
@@ -689,7 +696,12 @@ namespace Opm
                                     wells(), w, vfp_properties_->getProd()->getTable(table_id)->getDatumDepth(),
                                     wellPerforationDensities()[perf], gravity_);
 
-                            well_state.thp()[w] = vfp_properties_->getProd()->thp(table_id, aqua, liquid, vapour, bhp[w] + dp, alq);
+                            prod_table_id[w] = table_id;
+                            prod_aqua[w] = aqua;
+                            prod_liquid[w] = liquid;
+                            prod_vapour[w] = vapour;
+                            prod_bhp[w] = bhp[w] + dp;
+                            prod_alq[w] = alq;
                         }
                         else {
                             OPM_THROW(std::logic_error, "Expected INJECTOR or PRODUCER well");
@@ -700,6 +712,36 @@ namespace Opm
                     }
                 }
             }
+
+            std::vector<int> thp_wells;
+            for (int w = 0; w < nw; ++w) {
+                if (prod_table_id[w] >= 0) {
+                    const int k = thp_wells.size();
+                    thp_wells.push_back(w);
+                    prod_table_id[k] = prod_table_id[w];
+                    prod_aqua[k] = prod_aqua[w];
+                    prod_liquid[k] = prod_liquid[w];
+                    prod_vapour[k] = prod_vapour[w];
+                    prod_bhp[k] = prod_bhp[w];
+                    prod_alq[k] = prod_alq[w];
+                }
+            }
+
+            if (!thp_wells.empty()) {
+                const int num_thp_wells = thp_wells.size();
+                prod_table_id.resize(num_thp_wells);
+                prod_aqua.resize(num_thp_wells);
+                prod_liquid.resize(num_thp_wells);
+                prod_vapour.resize(num_thp_wells);
+                prod_bhp.resize(num_thp_wells);
+                prod_alq.resize(num_thp_wells);
+
+                const std::vector<double> thp = vfp_properties_->getProd()->thp(prod_table_id, prod_aqua, prod_liquid,
+                                                                                prod_vapour, prod_bhp, prod_alq);
+                for (int k = 0; k < num_thp_wells; ++k) {
+                    well_state.thp()[thp_wells[k]] = thp[k];
+                }
+            }
         }
     }
 
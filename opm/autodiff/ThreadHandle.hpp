@@ -27,6 +27,10 @@
 #include <cassert>
 #include <dune/common/exceptions.hh>
 
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
 #include <thread>
 #include <mutex>
 #include <queue>
@@ -62,8 +66,25 @@ namespace Opm
       void run() { obj_.run(); }
     };
 
+    /// \brief Statistics class
+    /// Counters describing the usage of the queue.
+    struct Statistics
+    {
+      //! number of objects executed by the thread
+      std::size_t executedObjects = 0;
+      //! maximal number of objects waiting in the queue
+      std::size_t maxQueueDepth = 0;
+      //! accumulated time (in seconds) from dispatch until execution finished
+      double latencyTime = 0.0;
+      //! accumulated time (in seconds) the dispatching thread was blocked
+      //! because the queue was full or by a call to flush()
+      double waitTime = 0.0;
+    };
+
   protected:
 
+    typedef std::chrono::steady_clock Clock;
+
     /// \brief EndObject class
     /// Empthy object marking thread termination.
     class EndObject : public ObjectInterface
@@ -78,80 +99,133 @@ namespace Opm
     /// Queue of objects to be handled by this thread.
     class ThreadHandleQueue
     {
+      struct Entry
+      {
+        std::unique_ptr< ObjectInterface > obj;
+        Clock::time_point dispatchTime;
+      };
+
     public:
       //! constructor creating object that is executed by thread
-      ThreadHandleQueue()
-        : objQueue_(), mutex_()
+      //! \param capacity  maximal number of queued objects, 0 means unbounded
+      explicit ThreadHandleQueue( const std::size_t capacity )
+        : objQueue_(), mutex_(), capacity_( capacity ), busy_( false )
+      {
+      }
+
+      //! insert object into threads queue, blocks while the queue is full
+      void push_back( std::unique_ptr< ObjectInterface >&& obj )
       {
+        std::unique_lock< std::mutex > lock( mutex_ );
+        // the end marker is always accepted to not delay the termination
+        if( ! obj->isEndMarker() && isFull() )
+        {
+          const auto start = Clock::now();
+          notFull_.wait( lock, [ this ] () { return ! isFull(); } );
+          statistics_.waitTime += seconds( Clock::now() - start );
+        }
+
+        objQueue_.push( Entry{ std::move( obj ), Clock::now() } );
+        if( objQueue_.size() > statistics_.maxQueueDepth )
+          statistics_.maxQueueDepth = objQueue_.size();
+
+        notEmpty_.notify_one();
       }
 
-      ~ThreadHandleQueue()
+      //! block until all objects in the queue have been executed
+      void flush()
       {
-        // wait until all objects have been written.
-        while( ! objQueue_.empty() )
+        std::unique_lock< std::mutex > lock( mutex_ );
+        const auto start = Clock::now();
+        idle_.wait( lock, [ this ] () { return objQueue_.empty() && ! busy_; } );
+        statistics_.waitTime += seconds( Clock::now() - start );
+
+        // forward exceptions thrown by the executed objects to the caller
+        if( exception_ )
         {
-            wait();
+          std::exception_ptr ex = exception_;
+          exception_ = nullptr;
+          std::rethrow_exception( ex );
         }
       }
 
-      //! insert object into threads queue
-      void push_back( std::unique_ptr< ObjectInterface >&& obj )
+      //! return a copy of the current counters
+      Statistics statistics() const
       {
-        // lock mutex to make sure objPtr is not used
-        mutex_.lock();
-        objQueue_.emplace( std::move(obj) );
-        mutex_.unlock();
+        std::lock_guard< std::mutex > lock( mutex_ );
+        return statistics_;
       }
 
       //! do the work until the queue received an end object
       void run()
       {
-        // wait until objects have been pushed to the queue
-        while( objQueue_.empty() )
+        std::unique_lock< std::mutex > lock( mutex_ );
+        while( true )
         {
-          // sleep one second
-          wait();
+          // wait until objects have been pushed to the queue
+          notEmpty_.wait( lock, [ this ] () { return ! objQueue_.empty(); } );
+
+          // get next object from queue
+          Entry entry( std::move( objQueue_.front() ) );
+          objQueue_.pop();
+
+          // if object is end marker terminate thread
+          if( entry.obj->isEndMarker() )
+          {
+            assert( objQueue_.empty() );
+            idle_.notify_all();
+            return;
+          }
+
+          busy_ = true;
+          notFull_.notify_one();
+
+          // execute object action without holding the lock
+          lock.unlock();
+          std::exception_ptr ex;
+          try {
+            entry.obj->run();
+          }
+          catch( ... ) {
+            ex = std::current_exception();
+          }
+          entry.obj.reset();
+          lock.lock();
+
+          if( ex && ! exception_ )
+            exception_ = ex;
+
+          busy_ = false;
+          ++statistics_.executedObjects;
+          statistics_.latencyTime += seconds( Clock::now() - entry.dispatchTime );
+
+          if( objQueue_.empty() )
+            idle_.notify_all();
         }
-
-        {
-            // lock mutex for access to objQueue_
-            mutex_.lock();
-
-            // get next object from queue
-            std::unique_ptr< ObjectInterface > obj( objQueue_.front().release() );
-            // remove object from queue
-            objQueue_.pop();
-
-            // unlock mutex for access to objQueue_
-            mutex_.unlock();
-
-            // if object is end marker terminate thread
-            if( obj->isEndMarker() ){
-                if( ! objQueue_.empty() ) {
-                    throw std::logic_error("ThreadHandleQueue: not all queued objects were executed");
-                }
-                return;
-            }
-
-            // execute object action
-            obj->run();
-        }
-
-        // keep thread running
-        run();
       }
 
     protected:
-      std::queue< std::unique_ptr< ObjectInterface > > objQueue_;
-      std::mutex  mutex_;
+      std::queue< Entry > objQueue_;
+      mutable std::mutex  mutex_;
+      std::condition_variable notEmpty_;
+      std::condition_variable notFull_;
+      std::condition_variable idle_;
+      const std::size_t capacity_;
+      bool busy_;
+      std::exception_ptr exception_;
+      Statistics statistics_;
 
       // no copying
       ThreadHandleQueue( const ThreadHandleQueue& ) = delete;
 
-      // wait duration of 10 milli seconds
-      void wait() const
+      bool isFull() const
       {
-          std::this_thread::sleep_for( std::chrono::milliseconds(10) );
+        return capacity_ > 0 && objQueue_.size() >= capacity_;
+      }
+
+      static double seconds( const Clock::duration& d )
+      {
+        return std::chrono::duration< double >( d ).count();
       }
     }; // end ThreadHandleQueue
 
@@ -174,16 +248,16 @@ namespace Opm
 
   public:
     //! constructor creating ThreadHandle
-    //! \param isIORank  if true thread is created
-    ThreadHandle( const bool createThread )
-      : threadObjectQueue_(),
+    //! \param createThread  if true thread is created
+    //! \param capacity      maximal number of pending objects before dispatch
+    //!                      blocks, 0 means unbounded
+    explicit ThreadHandle( const bool createThread, const std::size_t capacity = 0 )
+      : threadObjectQueue_( capacity ),
         thread_()
     {
         if( createThread )
         {
            thread_.reset( new std::thread( startThread, &threadObjectQueue_ ) );
-           // detach thread into nirvana
-           thread_->detach();
         }
     } // end constructor
 
@@ -205,13 +279,30 @@ namespace Opm
         }
     }
 
-    //! destructor terminating the thread
+    //! block until all dispatched objects have been executed,
+    //! rethrows the first exception thrown by one of these objects
+    void flush()
+    {
+        if( thread_ )
+        {
+            threadObjectQueue_.flush();
+        }
+    }
+
+    //! return counters describing the usage of the queue
+    Statistics statistics() const
+    {
+        return threadObjectQueue_.statistics();
+    }
+
+    //! destructor terminating the thread after all objects have been executed
     ~ThreadHandle()
     {
         if( thread_ )
         {
             // dispatch end object which will terminate the thread
             threadObjectQueue_.push_back( std::unique_ptr< ObjectInterface > (new EndObject()) ) ;
+            thread_->join();
         }
     }
   };
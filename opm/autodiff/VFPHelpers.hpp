@@ -28,6 +28,10 @@
 #include <opm/material/densead/Math.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+
 /**
  * This file contains a set of helper functions used by VFPProd / VFPInj.
  */
@@ -232,14 +236,11 @@ inline InterpData findInterpData(const double& value, const std::vector<double>&
             retval.ind_[1] = nvalues-1;
         }
         else {
-            //Search internal intervals
-            for (int i=1; i<nvalues; ++i) {
-                if (values[i] >= value) {
-                    retval.ind_[0] = i-1;
-                    retval.ind_[1] = i;
-                    break;
-                }
-            }
+            //Binary search for the first internal end point not below value
+            const auto upper = std::lower_bound(values.begin() + 1, values.end(), value);
+            const int i = upper - values.begin();
+            retval.ind_[0] = i-1;
+            retval.ind_[1] = i;
         }
 
         const double start = values[retval.ind_[0]];
@@ -340,21 +341,28 @@ inline VFPEvaluation interpolate(
     //This is not really required, but performance-wise it may pay off, since the 32-elements
     //we copy to (nn) will fit better in cache than the full original table for the
     //interpolation below.
+    //The table is stored contiguously, so the elements are addressed by flat offsets
+    //instead of going through the nested sub-array views of array[ti][wi][gi][ai][fi].
+    const double* data = array.data();
+    const auto* strides = array.strides();
+    std::ptrdiff_t offset[5][2];
+    for (int i=0; i<=1; ++i) {
+        offset[0][i] = thp_i.ind_[i] * strides[0];
+        offset[1][i] = wfr_i.ind_[i] * strides[1];
+        offset[2][i] = gfr_i.ind_[i] * strides[2];
+        offset[3][i] = alq_i.ind_[i] * strides[3];
+        offset[4][i] = flo_i.ind_[i] * strides[4];
+    }
+
     //The following ladder of for loops will presumably be unrolled by a reasonable compiler.
     for (int t=0; t<=1; ++t) {
         for (int w=0; w<=1; ++w) {
             for (int g=0; g<=1; ++g) {
                 for (int a=0; a<=1; ++a) {
+                    const std::ptrdiff_t base = offset[0][t] + offset[1][w] + offset[2][g] + offset[3][a];
                     for (int f=0; f<=1; ++f) {
-                        //Shorthands for indexing
-                        const int ti = thp_i.ind_[t];
-                        const int wi = wfr_i.ind_[w];
-                        const int gi = gfr_i.ind_[g];
-                        const int ai = alq_i.ind_[a];
-                        const int fi = flo_i.ind_[f];
-
                         //Copy element
-                        nn[t][w][g][a][f].value = array[ti][wi][gi][ai][fi];
+                        nn[t][w][g][a][f].value = data[base + offset[4][f]];
                     }
                 }
             }
@@ -452,6 +460,8 @@ inline VFPEvaluation interpolate(
 
     //Pick out nearest neighbors (nn) to our evaluation point
     //The following ladder of for loops will presumably be unrolled by a reasonable compiler.
+    const double* data = array.data();
+    const auto* strides = array.strides();
     for (int t=0; t<=1; ++t) {
         for (int f=0; f<=1; ++f) {
             //Shorthands for indexing
@@ -459,7 +469,7 @@ inline VFPEvaluation interpolate(
             const int fi = flo_i.ind_[f];
 
             //Copy element
-            nn[t][f].value = array[ti][fi];
+            nn[t][f].value = data[ti*strides[0] + fi*strides[1]];
         }
     }
 
@@ -553,7 +563,7 @@ inline VFPEvaluation bhp(const VFPInjTable* table,
  * Returns the table from the map if found, or throws an exception
  */
 template <typename T>
-const T* getTable(const std::map<int, T*> tables, int table_id) {
+const T* getTable(const std::map<int, T*>& tables, int table_id) {
     auto entry = tables.find(table_id);
     if (entry == tables.end()) {
         OPM_THROW(std::invalid_argument, "Nonexistent table " << table_id << " referenced.");
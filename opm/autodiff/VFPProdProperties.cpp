@@ -28,6 +28,9 @@
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/autodiff/VFPHelpers.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 
 
 namespace Opm {
@@ -195,6 +198,87 @@ double VFPProdProperties::thp(int table_id,
         const double& bhp_arg,
         const double& alq) const {
     const VFPProdTable* table = detail::getTable(m_tables, table_id);
+    return thpFromTable(table, aqua, liquid, vapour, bhp_arg, alq);
+}
+
+
+
+template <class Function>
+void VFPProdProperties::forEachTable(const std::vector<int>& table_id, const Function& f) const {
+    const int nw = table_id.size();
+
+    // order the wells by table, such that each table is looked up once and
+    // its data is reused by the consecutive evaluations
+    std::vector<int> order(nw);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&table_id](const int a, const int b) { return table_id[a] < table_id[b]; });
+
+    std::vector<const VFPProdTable*> tables(nw, nullptr);
+    for (int k = 0; k < nw; ++k) {
+        const int i = order[k];
+        if (k == 0 || table_id[i] != table_id[order[k-1]]) {
+            tables[k] = detail::getTable(m_tables, table_id[i]);
+        }
+        else {
+            tables[k] = tables[k-1];
+        }
+    }
+
+    // the evaluations are independent, with a static schedule every thread
+    // handles a contiguous range of wells sharing few tables
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+    for (int k = 0; k < nw; ++k) {
+        f(tables[k], order[k]);
+    }
+}
+
+
+
+std::vector<detail::VFPEvaluation> VFPProdProperties::bhp(const std::vector<int>& table_id,
+        const std::vector<double>& aqua,
+        const std::vector<double>& liquid,
+        const std::vector<double>& vapour,
+        const std::vector<double>& thp_arg,
+        const std::vector<double>& alq) const {
+    const int nw = table_id.size();
+    std::vector<detail::VFPEvaluation> retval(nw);
+
+    forEachTable(table_id, [&](const VFPProdTable* table, const int i) {
+            retval[i] = detail::bhp(table, aqua[i], liquid[i], vapour[i], thp_arg[i], alq[i]);
+        });
+
+    return retval;
+}
+
+
+
+std::vector<double> VFPProdProperties::thp(const std::vector<int>& table_id,
+        const std::vector<double>& aqua,
+        const std::vector<double>& liquid,
+        const std::vector<double>& vapour,
+        const std::vector<double>& bhp_arg,
+        const std::vector<double>& alq) const {
+    const int nw = table_id.size();
+    std::vector<double> retval(nw);
+
+    forEachTable(table_id, [&](const VFPProdTable* table, const int i) {
+            retval[i] = thpFromTable(table, aqua[i], liquid[i], vapour[i], bhp_arg[i], alq[i]);
+        });
+
+    return retval;
+}
+
+
+
+double VFPProdProperties::thpFromTable(const VFPProdTable* table,
+        const double& aqua,
+        const double& liquid,
+        const double& vapour,
+        const double& bhp_arg,
+        const double& alq) {
     const VFPProdTable::array_type& data = table->getTable();
 
     //Find interpolation variables
@@ -202,7 +286,7 @@ double VFPProdProperties::thp(int table_id,
     double wfr = detail::getWFR(aqua, liquid, vapour, table->getWFRType());
     double gfr = detail::getGFR(aqua, liquid, vapour, table->getGFRType());
 
-    const std::vector<double> thp_array = table->getTHPAxis();
+    const std::vector<double>& thp_array = table->getTHPAxis();
     int nthp = thp_array.size();
 
     /**
@@ -227,9 +311,6 @@ double VFPProdProperties::thp(int table_id,
 
 
 
-
-
-
 const VFPProdTable* VFPProdProperties::getTable(const int table_id) const {
     return detail::getTable(m_tables, table_id);
 }
@@ -197,6 +197,40 @@ public:
             const double& bhp,
             const double& alq) const;
 
+    /**
+     * Linear interpolation of bhp and its partial derivatives for several wells
+     * in one call. Wells sharing a table are evaluated together, so that every
+     * table is looked up only once.
+     * @param table_id Table number to use for each well
+     * @param aqua Water phase for each well
+     * @param liquid Oil phase for each well
+     * @param vapour Gas phase for each well
+     * @param thp Tubing head pressure for each well
+     * @param alq Artificial lift or other parameter for each well
+     *
+     * @return The bottom hole pressure and its partial derivatives with
+     * respect to the table axes for each well.
+     */
+    std::vector<detail::VFPEvaluation> bhp(const std::vector<int>& table_id,
+            const std::vector<double>& aqua,
+            const std::vector<double>& liquid,
+            const std::vector<double>& vapour,
+            const std::vector<double>& thp,
+            const std::vector<double>& alq) const;
+
+    /**
+     * Linear interpolation of thp for several wells in one call, see
+     * the batched bhp() above.
+     *
+     * @return The tubing head pressure for each well.
+     */
+    std::vector<double> thp(const std::vector<int>& table_id,
+            const std::vector<double>& aqua,
+            const std::vector<double>& liquid,
+            const std::vector<double>& vapour,
+            const std::vector<double>& bhp,
+            const std::vector<double>& alq) const;
+
     /**
      * Returns the table associated with the ID, or throws an exception if
      * the table does not exist
@@ -213,6 +247,18 @@ public:
 private:
     // Map which connects the table number with the table itself
     std::map<int, const VFPProdTable*> m_tables;
+
+    // thp for a single well using the given table
+    static double thpFromTable(const VFPProdTable* table,
+            const double& aqua,
+            const double& liquid,
+            const double& vapour,
+            const double& bhp,
+            const double& alq);
+
+    // call f(table, i) for every well i, grouping the wells by their table
+    template <class Function>
+    void forEachTable(const std::vector<int>& table_id, const Function& f) const;
 };
 
 
@@ -39,6 +39,7 @@
 #include <opm/autodiff/WellHelpers.hpp>
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/autodiff/BlackoilModelParameters.hpp>
+#include <opm/autodiff/LinearSystemSnapshot.hpp>
 #include <opm/autodiff/RateConverter.hpp>
 
 #include <opm/simulators/WellSwitchingLogger.hpp>
@@ -124,6 +125,10 @@ namespace Opm
 
         void setVFPProperties(const VFPProperties* vfp_properties_arg);
 
+        /// Move a well that is kept alive across report steps to a new report
+        /// step, the schedule properties are read for this step afterwards.
+        void setReportStep(const int time_step);
+
         virtual void init(const PhaseUsage* phase_usage_arg,
                           const std::vector<double>& depth_arg,
                           const double gravity_arg,
@@ -189,6 +194,10 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const = 0;
 
+        /// Write the blocks B, C and D^-1, or D, of the well equations to
+        /// a snapshot of the linear system, as records well/<name>/B etc.
+        virtual void writeSystemSnapshot(LinearSystemSnapshotWriter& writer) const = 0;
+
         // TODO: before we decide to put more information under mutable, this function is not const
         virtual void computeWellPotentials(const Simulator& ebosSimulator,
                                            const WellState& well_state,
@@ -223,7 +232,7 @@ namespace Opm
 
         const Well* well_ecl_;
 
-        const int current_step_;
+        int current_step_;
 
         // the index of well in Wells struct
         int index_of_well_;
@@ -137,6 +137,18 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    setReportStep(const int time_step)
+    {
+        current_step_ = time_step;
+    }
+
+
+
+
+
     template<typename TypeTag>
     const std::string&
     WellInterface<TypeTag>::
@@ -31,7 +31,6 @@
 #include <cassert>
 #include <string>
 #include <utility>
-#include <map>
 #include <algorithm>
 #include <array>
 
@@ -130,11 +129,28 @@ namespace Opm
             // order may change so the mapping is based on the well name
             if( ! prevState.wellMap().empty() )
             {
+                // when the wells and their perforations are the same as
+                // before, which is the common case, copy the arrays as a whole
+                const bool same_wells = prevState.wellMap() == wellMap()
+                    && prevState.perfPhaseRates().size() == perfPhaseRates().size();
+                if( same_wells )
+                {
+                    bhp() = prevState.bhp();
+                    thp() = prevState.thp();
+                    wellRates() = prevState.wellRates();
+                    perfPhaseRates() = prevState.perfPhaseRates();
+                    perfPress() = prevState.perfPress();
+                    if (pu.has_solvent) {
+                        perfRateSolvent() = prevState.perfRateSolvent();
+                    }
+                    std::fill(is_new_well_.begin(), is_new_well_.end(), false);
+                }
+
                 typedef typename WellMapType :: const_iterator const_iterator;
                 const_iterator end = prevState.wellMap().end();
                 for (int w = 0; w < nw; ++w) {
                     std::string name( wells->name[ w ] );
-                    const_iterator it = prevState.wellMap().find( name );
+                    const_iterator it = same_wells ? end : prevState.wellMap().find( name );
                     if( it != end )
                     {
                         // this is not a new added well
@@ -450,7 +466,20 @@ namespace Opm
             assert(int(segrates_.size()) == nseg_ * numPhases() );
 
             if (!prev_well_state.wellMap().empty()) {
-                // copying MS well related
+                // copying MS well related, as a whole when the wells and
+                // their segments are the same as before
+                bool same_segments = prev_well_state.wellMap() == wellMap()
+                    && prev_well_state.numSegment() == nseg_
+                    && prev_well_state.segRates().size() == segrates_.size();
+                for (int w = 0; same_segments && w < nw; ++w) {
+                    same_segments = prev_well_state.topSegmentIndex(w) == topSegmentIndex(w);
+                }
+                if (same_segments) {
+                    segrates_ = prev_well_state.segRates();
+                    segpress_ = prev_well_state.segPress();
+                    return;
+                }
+
                 const auto& end = prev_well_state.wellMap().end();
                 const int np = numPhases();
                 for (int w = 0; w < nw; ++w) {
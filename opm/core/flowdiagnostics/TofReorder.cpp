@@ -37,7 +37,11 @@ namespace Opm
     /// \param[in] use_multidim_upwind  If true, use multidimensional tof upwinding.
     TofReorder::TofReorder(const UnstructuredGrid& grid,
                            const bool use_multidim_upwind)
-        : grid_(grid),
+        // The multidimensional upwinding reads face tofs written by cells
+        // that only share a vertex with the cell, so the components are
+        // then solved in sequence.
+        : ReorderSolverInterface(!use_multidim_upwind),
+          grid_(grid),
           darcyflux_(0),
           porevolume_(0),
           source_(0),
@@ -304,8 +308,6 @@ namespace Opm
 
     void TofReorder::solveMultiCell(const int num_cells, const int* cells)
     {
-        ++num_multicell_;
-        max_size_multicell_ = std::max(max_size_multicell_, num_cells);
         // std::cout << "Multiblock solve with " << num_cells << " cells." << std::endl;
 
         // Using a Gauss-Seidel approach.
@@ -322,7 +324,15 @@ namespace Opm
             }
             // std::cout << "Max delta = " << max_delta << std::endl;
         }
-        max_iter_multicell_ = std::max(max_iter_multicell_, num_iter);
+        // the components may be solved concurrently
+#if HAVE_OPENMP
+#pragma omp critical(TofReorder_solveMultiCell)
+#endif // HAVE_OPENMP
+        {
+            ++num_multicell_;
+            max_size_multicell_ = std::max(max_size_multicell_, num_cells);
+            max_iter_multicell_ = std::max(max_iter_multicell_, num_iter);
+        }
     }
 
 
@@ -21,6 +21,7 @@
 
 #include <opm/core/simulator/SimulatorReport.hpp>
 
+#include <algorithm>
 #include <iomanip>
 #include <ostream>
 #include <sstream>
@@ -36,10 +37,18 @@ namespace Opm
           linear_solve_time(0.0),
           update_time(0.0),
           output_write_time(0.0),
+          output_wait_time(0.0),
+          output_latency_time(0.0),
+          setup_time(0.0),
+          setup_time_saved(0.0),
           total_well_iterations(0),
           total_linearizations( 0 ),
           total_newton_iterations( 0 ),
           total_linear_iterations( 0 ),
+          total_output_writes( 0 ),
+          output_queue_max_depth( 0 ),
+          total_setups( 0 ),
+          total_setups_reused( 0 ),
           converged(false),
           verbose_(verbose)
     {
@@ -54,11 +63,19 @@ namespace Opm
         assemble_time += sr.assemble_time;
         update_time += sr.update_time;
         output_write_time += sr.output_write_time;
+        output_wait_time += sr.output_wait_time;
+        output_latency_time += sr.output_latency_time;
+        setup_time += sr.setup_time;
+        setup_time_saved += sr.setup_time_saved;
         total_time += sr.total_time;
         total_well_iterations += sr.total_well_iterations;
         total_linearizations += sr.total_linearizations;
         total_newton_iterations += sr.total_newton_iterations;
         total_linear_iterations += sr.total_linear_iterations;
+        total_output_writes += sr.total_output_writes;
+        output_queue_max_depth = std::max(output_queue_max_depth, sr.output_queue_max_depth);
+        total_setups += sr.total_setups;
+        total_setups_reused += sr.total_setups_reused;
     }
 
     void SimulatorReport::report(std::ostream& os)
@@ -131,6 +148,24 @@ namespace Opm
                 os << " Output write time (seconds): " << t;
                 os << std::endl;
 
+                if (total_output_writes > 0) {
+                    os << "  Async output writes:        " << total_output_writes
+                       << " (max queue depth: " << output_queue_max_depth << ")";
+                    os << std::endl;
+                    os << "  Async output wait (seconds):    " << output_wait_time;
+                    os << std::endl;
+                    os << "  Async output latency (seconds): " << output_latency_time;
+                    os << std::endl;
+                }
+
+                if (total_setups > 0) {
+                    os << " Report step setup time (seconds): " << setup_time;
+                    os << std::endl;
+                    os << "  Reused setups:              " << total_setups_reused << "/" << total_setups
+                       << " (estimated saving: " << setup_time_saved << " sec)";
+                    os << std::endl;
+                }
+
             }
 
             int n = total_well_iterations + (failureReport ? failureReport->total_well_iterations : 0);
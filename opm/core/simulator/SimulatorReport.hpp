@@ -36,11 +36,19 @@ namespace Opm
         double linear_solve_time;
         double update_time;
         double output_write_time;
+        double output_wait_time;
+        double output_latency_time;
+        double setup_time;
+        double setup_time_saved;
 
         unsigned int total_well_iterations;
         unsigned int total_linearizations;
         unsigned int total_newton_iterations;
         unsigned int total_linear_iterations;
+        unsigned int total_output_writes;
+        unsigned int output_queue_max_depth;
+        unsigned int total_setups;
+        unsigned int total_setups_reused;
 
         bool converged;
 
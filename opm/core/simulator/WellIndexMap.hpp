@@ -0,0 +1,149 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_WELLINDEXMAP_HEADER_INCLUDED
+#define OPM_WELLINDEXMAP_HEADER_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Mapping from well names to the well index, the index of the first
+    /// perforation and the number of perforations of the wells of a
+    /// WellState.
+    ///
+    /// The entries are stored contiguously in the order they are inserted,
+    /// i.e. in well index order, and names are looked up in an open
+    /// addressing hash table of entry positions. Unlike a std::map, copying
+    /// the map copies two flat arrays, and since the Eclipse well names are
+    /// short, the names are kept inside the strings themselves.
+    class WellIndexMap
+    {
+    public:
+        typedef std::array<int, 3> mapped_type;
+        typedef std::pair<std::string, mapped_type> value_type;
+        typedef std::vector<value_type>::const_iterator const_iterator;
+        // The names are the keys of the hash table and must not change.
+        typedef const_iterator iterator;
+
+        /// Remove all wells.
+        void clear()
+        {
+            entries_.clear();
+            slots_.clear();
+        }
+
+        /// Reserve space for the given number of wells.
+        void reserve(const std::size_t n)
+        {
+            entries_.reserve(n);
+            if (slots_.size() < 2 * n) {
+                rehash(n);
+            }
+        }
+
+        /// The entry of a well, inserted at the end if it is not present.
+        mapped_type& operator[](const std::string& name)
+        {
+            const std::size_t slot = findSlot(name);
+            if (!slots_.empty() && slots_[slot] >= 0) {
+                return entries_[slots_[slot]].second;
+            }
+            if (slots_.size() < 2 * (entries_.size() + 1)) {
+                rehash(entries_.size() + 1);
+                return insert(findSlot(name), name);
+            }
+            return insert(slot, name);
+        }
+
+        const_iterator find(const std::string& name) const
+        {
+            if (slots_.empty()) {
+                return end();
+            }
+            const int pos = slots_[findSlot(name)];
+            return pos < 0 ? end() : entries_.begin() + pos;
+        }
+
+        const_iterator begin() const { return entries_.begin(); }
+        const_iterator end() const { return entries_.end(); }
+
+        std::size_t size() const { return entries_.size(); }
+        bool empty() const { return entries_.empty(); }
+
+        /// Whether the maps have the same wells, in the same order and with
+        /// the same perforations, so that the per well and per perforation
+        /// arrays of their states can be copied as a whole.
+        bool operator==(const WellIndexMap& other) const
+        {
+            return entries_ == other.entries_;
+        }
+
+        bool operator!=(const WellIndexMap& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        // The slot of the name, or the empty slot where it belongs.
+        std::size_t findSlot(const std::string& name) const
+        {
+            if (slots_.empty()) {
+                return 0;
+            }
+            const std::size_t mask = slots_.size() - 1;
+            std::size_t slot = std::hash<std::string>()(name) & mask;
+            while (slots_[slot] >= 0 && entries_[slots_[slot]].first != name) {
+                slot = (slot + 1) & mask;
+            }
+            return slot;
+        }
+
+        mapped_type& insert(const std::size_t slot, const std::string& name)
+        {
+            slots_[slot] = entries_.size();
+            entries_.emplace_back(name, mapped_type{{ 0, 0, 0 }});
+            return entries_.back().second;
+        }
+
+        // Resize the table to a power of two at least twice the given
+        // number of wells, and reinsert the present wells.
+        void rehash(const std::size_t n)
+        {
+            std::size_t capacity = 8;
+            while (capacity < 2 * n) {
+                capacity *= 2;
+            }
+            slots_.assign(capacity, -1);
+            for (std::size_t pos = 0; pos < entries_.size(); ++pos) {
+                slots_[findSlot(entries_[pos].first)] = pos;
+            }
+        }
+
+        std::vector<value_type> entries_;
+        std::vector<int> slots_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_WELLINDEXMAP_HEADER_INCLUDED
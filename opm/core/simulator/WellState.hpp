@@ -21,12 +21,12 @@
 #define OPM_WELLSTATE_HEADER_INCLUDED
 
 #include <opm/core/props/BlackoilPhases.hpp>
+#include <opm/core/simulator/WellIndexMap.hpp>
 #include <opm/core/wells.h>
 #include <opm/core/well_controls.h>
 #include <opm/output/data/Wells.hpp>
 
 #include <array>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,8 +39,8 @@ namespace Opm
     class WellState
     {
     public:
-        typedef std::array< int, 3 >  mapentry_t;
-        typedef std::map< std::string, mapentry_t > WellMapType;
+        typedef WellIndexMap::mapped_type mapentry_t;
+        typedef WellIndexMap WellMapType;
 
         template <class State>
         void init(const Wells* wells, const State& state)
@@ -57,11 +57,12 @@ namespace Opm
         {
             // clear old name mapping
             wellMap_.clear();
-            wells_.reset( clone_wells( wells ) );
+            wells_.reset( clone_wells( wells ), wdel() );
 
             if (wells) {
                 const int nw = wells->number_of_wells;
                 const int np = wells->number_of_phases;
+                wellMap_.reserve(nw);
                 bhp_.resize(nw);
                 thp_.resize(nw);
                 temperature_.resize(nw, 273.15 + 20); // standard temperature for now
@@ -273,30 +274,10 @@ namespace Opm
 
         virtual ~WellState() {}
 
+        // The copies share the Wells, which are not modified after init().
         WellState() = default;
-        WellState( const WellState& rhs ) :
-            bhp_( rhs.bhp_ ),
-            thp_( rhs.thp_ ),
-            temperature_( rhs.temperature_ ),
-            wellrates_( rhs.wellrates_ ),
-            perfrates_( rhs.perfrates_ ),
-            perfpress_( rhs.perfpress_ ),
-            wellMap_( rhs.wellMap_ ),
-            wells_( clone_wells( rhs.wells_.get() ) )
-        {}
-
-        WellState& operator=( const WellState& rhs ) {
-            this->bhp_ = rhs.bhp_;
-            this->thp_ = rhs.thp_;
-            this->temperature_ = rhs.temperature_;
-            this->wellrates_ = rhs.wellrates_;
-            this->perfrates_ = rhs.perfrates_;
-            this->perfpress_ = rhs.perfpress_;
-            this->wellMap_ = rhs.wellMap_;
-            this->wells_.reset( clone_wells( rhs.wells_.get() ) );
-
-            return *this;
-        }
+        WellState( const WellState& rhs ) = default;
+        WellState& operator=( const WellState& rhs ) = default;
 
     private:
         std::vector<double> bhp_;
@@ -312,7 +293,7 @@ namespace Opm
         struct wdel {
             void operator()( Wells* w ) { destroy_wells( w ); }
         };
-        std::unique_ptr< Wells, wdel > wells_;
+        std::shared_ptr< const Wells > wells_;
     };
 
 } // namespace Opm
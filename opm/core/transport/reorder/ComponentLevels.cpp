@@ -0,0 +1,129 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/transport/reorder/ComponentLevels.hpp>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <algorithm>
+
+
+namespace Opm
+{
+
+    ComponentLevels::ComponentLevels()
+        : num_components_(0)
+    {
+    }
+
+
+
+    void ComponentLevels::compute(const UnstructuredGrid& grid,
+                                  const int* sequence,
+                                  const int* components,
+                                  const int num_components)
+    {
+        num_components_ = num_components;
+
+        std::vector<int> cell_component(grid.number_of_cells, -1);
+        for (int comp = 0; comp < num_components; ++comp) {
+            for (int i = components[comp]; i < components[comp + 1]; ++i) {
+                cell_component[sequence[i]] = comp;
+            }
+        }
+
+        // The components are in topological order, so the levels of the
+        // preceding neighbours are known when a component is reached.
+        std::vector<int> level(num_components, 0);
+        int num_levels = 0;
+        for (int comp = 0; comp < num_components; ++comp) {
+            int comp_level = 0;
+            for (int i = components[comp]; i < components[comp + 1]; ++i) {
+                const int cell = sequence[i];
+                for (int hf = grid.cell_facepos[cell]; hf < grid.cell_facepos[cell + 1]; ++hf) {
+                    const int f = grid.cell_faces[hf];
+                    const int other = (grid.face_cells[2*f] == cell)
+                        ? grid.face_cells[2*f + 1] : grid.face_cells[2*f];
+                    if (other < 0) {
+                        continue; // Boundary.
+                    }
+                    const int other_comp = cell_component[other];
+                    if (other_comp < comp) {
+                        comp_level = std::max(comp_level, level[other_comp] + 1);
+                    }
+                }
+            }
+            level[comp] = comp_level;
+            num_levels = std::max(num_levels, comp_level + 1);
+        }
+
+        // Sort the components by level, keeping the sequence order within each level.
+        level_start_.assign(num_levels + 1, 0);
+        for (int comp = 0; comp < num_components; ++comp) {
+            ++level_start_[level[comp] + 1];
+        }
+        for (int l = 0; l < num_levels; ++l) {
+            level_start_[l + 1] += level_start_[l];
+        }
+        std::vector<int> position(level_start_.begin(), level_start_.end() - 1);
+        level_components_.resize(num_components);
+        for (int comp = 0; comp < num_components; ++comp) {
+            level_components_[position[level[comp]]++] = comp;
+        }
+    }
+
+
+
+    int ComponentLevels::numComponents() const
+    {
+        return num_components_;
+    }
+
+
+
+    int ComponentLevels::numLevels() const
+    {
+        return level_start_.empty() ? 0 : level_start_.size() - 1;
+    }
+
+
+
+    const std::vector<int>& ComponentLevels::levelComponents() const
+    {
+        return level_components_;
+    }
+
+
+
+    const std::vector<int>& ComponentLevels::levelStart() const
+    {
+        return level_start_;
+    }
+
+
+
+    bool ComponentLevels::useLevels() const
+    {
+#if HAVE_OPENMP
+        return omp_get_max_threads() > 1
+            && num_components_ >= min_average_level_size_ * numLevels();
+#else
+        return false;
+#endif // HAVE_OPENMP
+    }
+
+} // namespace Opm
@@ -0,0 +1,135 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_COMPONENTLEVELS_HEADER_INCLUDED
+#define OPM_COMPONENTLEVELS_HEADER_INCLUDED
+
+#include <exception>
+#include <vector>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    /// Groups the strongly connected components of a reordered grid, as
+    /// computed by compute_sequence(), into levels (wavefronts).
+    ///
+    /// A component is placed one level above the highest level of the
+    /// components that precede it in the sequence and share a face with
+    /// it. Components of the same level are therefore never neighbours,
+    /// and all neighbours of a component that come earlier in the sequence
+    /// belong to lower levels. A solver that only reads the state of the
+    /// face neighbours of the cells it solves for, and only writes to the
+    /// state of those cells, thus gives the same result whether the
+    /// components are processed in sequence or level by level with the
+    /// components of each level processed concurrently.
+    class ComponentLevels
+    {
+    public:
+        ComponentLevels();
+
+        /// Compute the levels of the components.
+        /// \param[in] grid           The grid the sequence was computed for.
+        /// \param[in] sequence       Cell sequence from compute_sequence().
+        /// \param[in] components     Component start positions in sequence,
+        ///                           num_components + 1 entries.
+        /// \param[in] num_components Number of components.
+        void compute(const UnstructuredGrid& grid,
+                     const int* sequence,
+                     const int* components,
+                     const int num_components);
+
+        /// The number of components.
+        int numComponents() const;
+
+        /// The number of levels.
+        int numLevels() const;
+
+        /// The components sorted by level, keeping the sequence order
+        /// within each level.
+        const std::vector<int>& levelComponents() const;
+
+        /// The start of each level in levelComponents(), numLevels() + 1 entries.
+        const std::vector<int>& levelStart() const;
+
+        /// Call f(comp) once for every component. With several OpenMP
+        /// threads the levels are processed in order, and the components
+        /// of each level concurrently. Otherwise, or if the levels are too
+        /// narrow to be worth it, the components are processed in sequence.
+        /// An exception thrown by f while processing the levels concurrently
+        /// is rethrown once the remaining components have been processed.
+        template <class Function>
+        void forEachComponent(const Function& f) const;
+
+    private:
+        // whether forEachComponent() processes the levels concurrently
+        bool useLevels() const;
+
+        // Minimum average number of components per level for processing
+        // the levels concurrently.
+        static const int min_average_level_size_ = 4;
+
+        int num_components_;
+        std::vector<int> level_components_;
+        std::vector<int> level_start_;
+    };
+
+
+
+    template <class Function>
+    void ComponentLevels::forEachComponent(const Function& f) const
+    {
+#if HAVE_OPENMP
+        if (useLevels()) {
+            const int num_levels = numLevels();
+            // exceptions must not leave the parallel region
+            std::exception_ptr exc;
+#pragma omp parallel
+            for (int level = 0; level < num_levels; ++level) {
+                // the implicit barrier at the end of the loop separates the levels
+#pragma omp for schedule(dynamic)
+                for (int k = level_start_[level]; k < level_start_[level + 1]; ++k) {
+                    try {
+                        f(level_components_[k]);
+                    }
+                    catch (...) {
+#pragma omp critical(ComponentLevels_forEachComponent)
+                        if (!exc) {
+                            exc = std::current_exception();
+                        }
+                    }
+                }
+            }
+            if (exc) {
+                std::rethrow_exception(exc);
+            }
+            return;
+        }
+#endif // HAVE_OPENMP
+        for (int comp = 0; comp < num_components_; ++comp) {
+            f(comp);
+        }
+    }
+
+} // namespace Opm
+
+#endif // OPM_COMPONENTLEVELS_HEADER_INCLUDED
@@ -28,6 +28,12 @@
 #include <iostream>
 
 
+Opm::ReorderSolverInterface::ReorderSolverInterface(const bool concurrent_components)
+    : concurrent_components_(concurrent_components)
+{
+}
+
+
 void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& grid, const double* darcyflux)
 {
     // Compute reordered sequence of single-cell problems
@@ -44,23 +50,21 @@ void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& gr
     components_.resize(ncomponents + 1);
 
     // Invoke appropriate solve method for each interdependent component.
-    for (int comp = 0; comp < ncomponents; ++comp) {
-#if 0
-#ifdef MATLAB_MEX_FILE
-	// \TODO replace this with general signal handling code, check if it costs performance.
-        if (interrupt_signal) {
-            mexPrintf("Reorder loop interrupted by user: %d of %d "
-                      "cells finished.\n", i, grid.number_of_cells);
-            break;
-        }
-#endif
-#endif
+    const auto solveComponent = [this](const int comp) {
 	const int comp_size = components_[comp + 1] - components_[comp];
 	if (comp_size == 1) {
 	    solveSingleCell(sequence_[components_[comp]]);
 	} else {
 	    solveMultiCell(comp_size, &sequence_[components_[comp]]);
 	}
+    };
+    if (concurrent_components_) {
+        levels_.compute(grid, sequence_.data(), components_.data(), ncomponents);
+        levels_.forEachComponent(solveComponent);
+    } else {
+        for (int comp = 0; comp < ncomponents; ++comp) {
+            solveComponent(comp);
+        }
     }
 }
 
@@ -20,6 +20,8 @@
 #ifndef OPM_REORDERSOLVERINTERFACE_HEADER_INCLUDED
 #define OPM_REORDERSOLVERINTERFACE_HEADER_INCLUDED
 
+#include <opm/core/transport/reorder/ComponentLevels.hpp>
+
 #include <vector>
 
 struct UnstructuredGrid;
@@ -35,10 +37,20 @@ namespace Opm
     /// class.) The reorderAndTransport() method is provided as an aid
     /// to implementing solve() in subclasses, together with the
     /// sequence() and components() methods for accessing the ordering.
+    ///
+    /// A subclass may allow the components to be solved concurrently,
+    /// see ComponentLevels. This requires solveSingleCell() and
+    /// solveMultiCell() to only modify the state of the cells passed,
+    /// and to only read the state of those cells and their face
+    /// neighbours, and to be safe to call from several threads.
     class ReorderSolverInterface
     {
     public:
     virtual ~ReorderSolverInterface() {}
+    protected:
+        /// \param[in] concurrent_components  If true, the components of the
+        ///                                   same level may be solved concurrently.
+        explicit ReorderSolverInterface(const bool concurrent_components = false);
     private:
 	virtual void solveSingleCell(const int cell) = 0;
 	virtual void solveMultiCell(const int num_cells, const int* cells) = 0;
@@ -49,6 +61,8 @@ namespace Opm
     private:
         std::vector<int> sequence_;
         std::vector<int> components_;
+        bool concurrent_components_;
+        ComponentLevels levels_;
     };
 
 
@@ -48,7 +48,8 @@ namespace Opm
                                                                    const double* gravity,
                                                                    const double tol,
                                                                    const int maxit)
-        : grid_(grid),
+        : ReorderSolverInterface(true),
+          grid_(grid),
           props_(props),
           tol_(tol),
           maxit_(maxit),
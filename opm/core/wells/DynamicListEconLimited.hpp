@@ -24,6 +24,7 @@
 #include <map>
 
 #include <cassert>
+#include <cstddef>
 
 namespace Opm
 {
@@ -80,6 +81,15 @@ namespace Opm
             }
         }
 
+        /// The total number of shut and stopped wells and closed connections.
+        std::size_t size() const {
+            std::size_t num_entries = m_shut_wells.size() + m_stopped_wells.size();
+            for (const auto& closed_connections : m_cells_closed_connections) {
+                num_entries += closed_connections.second.size();
+            }
+            return num_entries;
+        }
+
     private:
         std::vector <std::string> m_shut_wells;
         std::vector <std::string> m_stopped_wells;
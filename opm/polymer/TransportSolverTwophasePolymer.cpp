@@ -176,7 +176,8 @@ namespace Opm
 						 const SingleCellMethod method,
 						 const double tol,
 						 const int maxit)
-	: grid_(grid),
+	: ReorderSolverInterface(true),
+	  grid_(grid),
 	  porosity_(props.porosity()),
 	  porevolume_(NULL),
 	  props_(props),
@@ -1023,7 +1024,7 @@ namespace Opm
             computeMc(concentration_[cell], mc_[cell]);
 	    s0[i] = saturation_[cell];
 	    c0[i] = concentration_[cell];
-	    cmax0[i] = cmax_[i];
+	    cmax0[i] = cmax_[cell];
 	}
 	do {
 	    // int max_s_change_cell = -1;
@@ -0,0 +1,182 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <opm/simulators/BatchedAllReduce.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace Opm
+{
+
+#if HAVE_MPI
+namespace
+{
+    // The packed buffer is transferred as a single element of a contiguous
+    // datatype, so the reduction operation always sees the complete buffer.
+    // Its first entry is the number of sums, which are stored next, and the
+    // remaining entries are reduced by maximum (minima are stored negated).
+    void batchedReduction(void* invec, void* inoutvec, int* len, MPI_Datatype* datatype)
+    {
+        int bytes = 0;
+        MPI_Type_size(*datatype, &bytes);
+        const int size = bytes / sizeof(double);
+
+        for (int e = 0; e < *len; ++e) {
+            const double* in = static_cast<const double*>(invec) + e * size;
+            double* inout = static_cast<double*>(inoutvec) + e * size;
+            const int numSums = static_cast<int>(in[0]);
+            for (int i = 1; i <= numSums; ++i) {
+                inout[i] += in[i];
+            }
+            for (int i = numSums + 1; i < size; ++i) {
+                inout[i] = std::max(inout[i], in[i]);
+            }
+        }
+    }
+} // anonymous namespace
+#endif // HAVE_MPI
+
+BatchedAllReduce::BatchedAllReduce(const Communication& cc)
+    : cc_(cc),
+      pending_(false)
+{
+#if HAVE_MPI
+    request_ = MPI_REQUEST_NULL;
+#endif
+}
+
+BatchedAllReduce::~BatchedAllReduce()
+{
+#if HAVE_MPI
+    if (pending_) {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized) {
+            MPI_Wait(&request_, MPI_STATUS_IGNORE);
+        }
+    }
+#endif
+}
+
+void BatchedAllReduce::pack()
+{
+    const int numSums = std::count(operations_.begin(), operations_.end(), Sum);
+    sendBuffer_.resize(values_.size() + 1);
+    sendBuffer_[0] = numSums;
+
+    int sumPos = 1;
+    int maxPos = 1 + numSums;
+    for (std::size_t i = 0; i < values_.size(); ++i) {
+        switch (operations_[i]) {
+        case Sum:
+            sendBuffer_[sumPos++] = values_[i];
+            break;
+        case Max:
+            sendBuffer_[maxPos++] = values_[i];
+            break;
+        case Min:
+            sendBuffer_[maxPos++] = -values_[i];
+            break;
+        }
+    }
+}
+
+void BatchedAllReduce::unpack()
+{
+    const int numSums = static_cast<int>(recvBuffer_[0]);
+    results_.resize(values_.size());
+
+    int sumPos = 1;
+    int maxPos = 1 + numSums;
+    for (std::size_t i = 0; i < values_.size(); ++i) {
+        switch (operations_[i]) {
+        case Sum:
+            results_[i] = recvBuffer_[sumPos++];
+            break;
+        case Max:
+            results_[i] = recvBuffer_[maxPos++];
+            break;
+        case Min:
+            results_[i] = -recvBuffer_[maxPos++];
+            break;
+        }
+    }
+}
+
+void BatchedAllReduce::start()
+{
+    assert(!pending_);
+
+    if (cc_.size() == 1 || values_.empty()) {
+        results_ = values_;
+        return;
+    }
+
+#if HAVE_MPI
+    pack();
+    recvBuffer_.resize(sendBuffer_.size());
+
+    MPI_Datatype bufferType;
+    MPI_Type_contiguous(sendBuffer_.size(), MPI_DOUBLE, &bufferType);
+    MPI_Type_commit(&bufferType);
+    MPI_Op op;
+    MPI_Op_create(&batchedReduction, /* commute = */ 1, &op);
+
+    const MPI_Comm comm = cc_;
+#if MPI_VERSION >= 3
+    MPI_Iallreduce(sendBuffer_.data(), recvBuffer_.data(), 1, bufferType, op, comm, &request_);
+    pending_ = true;
+#else
+    MPI_Allreduce(sendBuffer_.data(), recvBuffer_.data(), 1, bufferType, op, comm);
+    unpack();
+#endif // MPI_VERSION >= 3
+
+    // Freeing is deferred by MPI until a pending operation has completed.
+    MPI_Op_free(&op);
+    MPI_Type_free(&bufferType);
+#else
+    results_ = values_;
+#endif // HAVE_MPI
+}
+
+void BatchedAllReduce::wait()
+{
+    if (!pending_) {
+        return;
+    }
+
+#if HAVE_MPI
+    MPI_Wait(&request_, MPI_STATUS_IGNORE);
+    pending_ = false;
+    unpack();
+#endif // HAVE_MPI
+}
+
+void BatchedAllReduce::clear()
+{
+    assert(!pending_);
+    values_.clear();
+    operations_.clear();
+    results_.clear();
+}
+
+} // namespace Opm
@@ -0,0 +1,180 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BATCHEDALLREDUCE_HEADER_INCLUDED
+#define OPM_BATCHEDALLREDUCE_HEADER_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+namespace Opm
+{
+
+/// \brief Collects global sums, maxima and minima of several quantities
+///        and computes them with a single collective operation.
+///
+/// Values are queued with sum(), max() and min(), which return a handle to
+/// the global result. execute() reduces all queued values with one
+/// MPI_Allreduce on a packed buffer. Alternatively start() initiates a
+/// non-blocking reduction that is completed by wait(), allowing to overlap
+/// the communication with computations. Afterwards the results can be
+/// accessed by their handles until clear() is called.
+///
+/// Without MPI or on a single process no communication takes place.
+class BatchedAllReduce
+{
+public:
+    /// \brief The type of the collective communication used.
+    typedef Dune::CollectiveCommunication<typename Dune::MPIHelper::MPICommunicator>
+    Communication;
+
+    /// \brief Handle to access the result of a queued reduction.
+    typedef std::size_t Handle;
+
+    /// \brief Constructor.
+    ///
+    /// \param cc The collective communication to use.
+    explicit BatchedAllReduce(const Communication& cc =
+                              Dune::MPIHelper::getCollectiveCommunication());
+
+    ~BatchedAllReduce();
+
+    /// \brief Queue a value for the global sum.
+    Handle sum(const double value)
+    {
+        return push(Sum, value);
+    }
+
+    /// \brief Queue a value for the global maximum.
+    Handle max(const double value)
+    {
+        return push(Max, value);
+    }
+
+    /// \brief Queue a value for the global minimum.
+    Handle min(const double value)
+    {
+        return push(Min, value);
+    }
+
+    /// \brief Queue the entries of a container for the global sum.
+    /// \return The handle of the first entry, the others follow consecutively.
+    template <class Container>
+    Handle sum(const Container& values)
+    {
+        return pushRange(Sum, values);
+    }
+
+    /// \brief Queue the entries of a container for the global maximum.
+    /// \return The handle of the first entry, the others follow consecutively.
+    template <class Container>
+    Handle max(const Container& values)
+    {
+        return pushRange(Max, values);
+    }
+
+    /// \brief Queue the entries of a container for the global minimum.
+    /// \return The handle of the first entry, the others follow consecutively.
+    template <class Container>
+    Handle min(const Container& values)
+    {
+        return pushRange(Min, values);
+    }
+
+    /// \brief Compute all queued reductions.
+    void execute()
+    {
+        start();
+        wait();
+    }
+
+    /// \brief Start the reduction of all queued values.
+    ///
+    /// If the MPI implementation does not support non-blocking collectives
+    /// the reduction is completed immediately.
+    void start();
+
+    /// \brief Wait for the reduction initiated by start() to complete.
+    void wait();
+
+    /// \brief The global result of a queued value, valid after execute() or wait().
+    double operator[](const Handle handle) const
+    {
+        return results_[handle];
+    }
+
+    /// \brief Copy the consecutive results starting at a handle into a container.
+    template <class Container>
+    void get(const Handle first, Container& values) const
+    {
+        Handle handle = first;
+        for (auto& value : values) {
+            value = results_[handle++];
+        }
+    }
+
+    /// \brief Remove all queued values and results.
+    void clear();
+
+    /// \brief The number of queued values.
+    std::size_t size() const
+    {
+        return values_.size();
+    }
+
+private:
+    enum Operation { Sum, Max, Min };
+
+    Handle push(const Operation op, const double value)
+    {
+        values_.push_back(value);
+        operations_.push_back(op);
+        return values_.size() - 1;
+    }
+
+    template <class Container>
+    Handle pushRange(const Operation op, const Container& values)
+    {
+        const Handle first = values_.size();
+        for (const auto& value : values) {
+            push(op, value);
+        }
+        return first;
+    }
+
+    // fill the send buffer from the queued values
+    void pack();
+    // extract the results from the receive buffer
+    void unpack();
+
+    Communication cc_;
+    std::vector<double> values_;
+    std::vector<Operation> operations_;
+    std::vector<double> results_;
+    std::vector<double> sendBuffer_;
+    std::vector<double> recvBuffer_;
+    bool pending_;
+#if HAVE_MPI
+    MPI_Request request_;
+#endif
+};
+
+} // namespace Opm
+
+#endif // OPM_BATCHEDALLREDUCE_HEADER_INCLUDED
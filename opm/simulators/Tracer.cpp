@@ -0,0 +1,202 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <opm/simulators/Tracer.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+namespace Opm
+{
+
+namespace
+{
+    // append a string with the characters special to JSON escaped
+    void appendEscaped(std::string& out, const char* str)
+    {
+        for (const char* c = str; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out += '\\';
+            }
+            out += *c;
+        }
+    }
+
+    // append a time in nanoseconds as microseconds, the unit of the trace format
+    void appendMicroseconds(std::string& out, const std::int64_t ns)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f", ns * 1e-3);
+        out += buffer;
+    }
+} // anonymous namespace
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer()
+    : origin_(Clock::now())
+{
+}
+
+Tracer::ThreadBuffer& Tracer::threadBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.emplace_back(new ThreadBuffer);
+        buffer = buffers_.back().get();
+        buffer->thread = buffers_.size() - 1;
+        buffer->events.reserve(1024);
+    }
+    return *buffer;
+}
+
+void Tracer::record(const char* name, const std::int64_t start, const std::int64_t end)
+{
+    threadBuffer().events.push_back(Event{name, start, end - start});
+}
+
+std::size_t Tracer::numEvents() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t num = 0;
+    for (const auto& buffer : buffers_) {
+        num += buffer->events.size();
+    }
+    return num;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& buffer : buffers_) {
+        buffer->events.clear();
+    }
+}
+
+void Tracer::appendEvents(std::string& out, const int rank) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string pid = std::to_string(rank);
+
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + pid
+        + ",\"tid\":0,\"args\":{\"name\":\"rank " + pid + "\"}}";
+
+    for (const auto& buffer : buffers_) {
+        const std::string tid = std::to_string(buffer->thread);
+        out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid
+            + ",\"tid\":" + tid + ",\"args\":{\"name\":\"thread " + tid + "\"}}";
+
+        for (const auto& event : buffer->events) {
+            out += ",\n{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"ph\":\"X\",\"ts\":";
+            appendMicroseconds(out, event.start);
+            out += ",\"dur\":";
+            appendMicroseconds(out, event.duration);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid + "}";
+        }
+    }
+}
+
+void Tracer::writeChromeTrace(std::ostream& os, const int rank) const
+{
+    std::string events;
+    appendEvents(events, rank);
+    os << "{\"traceEvents\":[\n" << events << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void Tracer::writeChromeTrace(const std::string& filename, const Communication& cc,
+                              const std::size_t maxGatherBytes) const
+{
+    std::string events;
+    appendEvents(events, cc.rank());
+
+    long long length = events.size();
+    std::vector<long long> lengths(cc.size());
+    cc.allgather(&length, 1, lengths.data());
+
+    std::ofstream os;
+    if (cc.rank() == 0) {
+        os.open(filename);
+        if (!os) {
+            OPM_THROW(std::runtime_error, "Could not open trace file " << filename);
+        }
+        os << "{\"traceEvents\":[\n";
+    }
+
+    // Gather the events of all processes on the root process in rounds.
+    // Each round takes the next bytes in rank order, at most
+    // maxGatherBytes in total, since the counts and displacements of
+    // gatherv are int and would overflow for the trace of a long run.
+    const long long piece = std::max(1LL, static_cast<long long>(std::min(maxGatherBytes, std::size_t(INT_MAX))));
+    std::vector<long long> offset(cc.size(), 0);
+    std::vector<int> counts(cc.size());
+    std::vector<int> displ(cc.size() + 1, 0);
+    std::vector<char> buffer;
+    int first = 0;
+    for (;;) {
+        while (first < cc.size() && offset[first] == lengths[first]) {
+            ++first;
+        }
+        if (first == cc.size()) {
+            break;
+        }
+
+        long long budget = piece;
+        for (int i = 0; i < cc.size(); ++i) {
+            const long long count = (i < first) ? 0 : std::min(budget, lengths[i] - offset[i]);
+            counts[i] = static_cast<int>(count);
+            displ[i + 1] = displ[i] + counts[i];
+            budget -= count;
+        }
+        buffer.resize(displ.back());
+        const int rank = cc.rank();
+        cc.gatherv(const_cast<char*>(events.data()) + offset[rank], counts[rank], buffer.data(),
+                   counts.data(), displ.data(), 0);
+
+        for (int i = first; i < cc.size(); ++i) {
+            if (cc.rank() == 0 && counts[i] > 0) {
+                if (i > 0 && offset[i] == 0) {
+                    os << ",\n";
+                }
+                os.write(buffer.data() + displ[i], counts[i]);
+            }
+            offset[i] += counts[i];
+        }
+    }
+
+    if (cc.rank() == 0) {
+        os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+}
+
+} // namespace Opm
@@ -0,0 +1,155 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_TRACER_HEADER_INCLUDED
+#define OPM_TRACER_HEADER_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <dune/common/parallel/mpihelper.hh>
+
+namespace Opm
+{
+
+/// \brief Records the durations of nested scopes of the simulator and
+///        writes them in the Chrome trace event format.
+///
+/// Each thread records into its own buffer, so recording only needs a
+/// lock the first time a thread records an event. The trace can be
+/// inspected with chrome://tracing or the Perfetto UI, showing one track
+/// per MPI rank and thread.
+///
+/// The scopes are usually marked with the OPM_TRACE_SCOPE macro, which
+/// expands to nothing unless the simulator is configured with
+/// ENABLE_TRACING, so the instrumentation has no cost in normal builds.
+class Tracer
+{
+public:
+    /// \brief The type of the collective communication used.
+    typedef Dune::CollectiveCommunication<typename Dune::MPIHelper::MPICommunicator>
+    Communication;
+
+    /// \brief The tracer of the process.
+    static Tracer& instance();
+
+    /// \brief The time in nanoseconds since the creation of the tracer.
+    std::int64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin_).count();
+    }
+
+    /// \brief Record a scope of the calling thread.
+    /// \param name  name of the scope, must be a string literal or outlive the tracer
+    /// \param start start time as returned by now()
+    /// \param end   end time as returned by now()
+    void record(const char* name, const std::int64_t start, const std::int64_t end);
+
+    /// \brief Write the events recorded on this process as a Chrome trace.
+    /// \param os   stream to write to
+    /// \param rank the process id used for the events
+    void writeChromeTrace(std::ostream& os, const int rank) const;
+
+    /// \brief Gather the events of all processes and write them as a single
+    ///        Chrome trace on the process with rank zero.
+    /// \param filename       file written by the process with rank zero
+    /// \param cc             communication of the processes
+    /// \param maxGatherBytes the most bytes gathered in one collective
+    ///                       operation, at most INT_MAX
+    void writeChromeTrace(const std::string& filename,
+                          const Communication& cc = Dune::MPIHelper::getCollectiveCommunication(),
+                          const std::size_t maxGatherBytes = std::size_t(1) << 30) const;
+
+    /// \brief The number of events recorded on this process.
+    std::size_t numEvents() const;
+
+    /// \brief Remove all recorded events.
+    void clear();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Event
+    {
+        const char* name;
+        std::int64_t start;
+        std::int64_t duration;
+    };
+
+    struct ThreadBuffer
+    {
+        int thread;
+        std::vector<Event> events;
+    };
+
+    Tracer();
+
+    // the buffer of the calling thread, created on first use
+    ThreadBuffer& threadBuffer();
+
+    // append the events of this process as comma separated JSON objects
+    void appendEvents(std::string& out, const int rank) const;
+
+    Clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer> > buffers_;
+};
+
+/// \brief Records the lifetime of a scope with the Tracer.
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : name_(name),
+          start_(Tracer::instance().now())
+    {
+    }
+
+    ~TraceScope()
+    {
+        Tracer& tracer = Tracer::instance();
+        tracer.record(name_, start_, tracer.now());
+    }
+
+private:
+    const char* name_;
+    std::int64_t start_;
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+} // namespace Opm
+
+#define OPM_TRACE_CONCAT_IMPL(a, b) a##b
+#define OPM_TRACE_CONCAT(a, b) OPM_TRACE_CONCAT_IMPL(a, b)
+
+#if OPM_ENABLE_TRACING
+/// Trace the enclosing scope under the given name (a string literal).
+#define OPM_TRACE_SCOPE(name) \
+    ::Opm::TraceScope OPM_TRACE_CONCAT(opmTraceScope, __LINE__)(name)
+#else
+#define OPM_TRACE_SCOPE(name) static_cast<void>(0)
+#endif // OPM_ENABLE_TRACING
+
+#endif // OPM_TRACER_HEADER_INCLUDED
@@ -26,6 +26,7 @@
 #include <opm/simulators/timestepping/SimulatorTimer.hpp>
 #include <opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp>
 #include <opm/simulators/timestepping/TimeStepControl.hpp>
+#include <opm/simulators/timestepping/StateCheckpoint.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
@@ -207,9 +208,10 @@ namespace Opm {
         // create adaptive step timer with previously used sub step size
         AdaptiveSimulatorTimer substepTimer( simulatorTimer, suggested_next_timestep_, max_time_step_ );
 
-        // copy states in case solver has to be restarted (to be revised)
-        State  last_state( state );
-        WState last_well_state( well_state );
+        // checkpoints of the states in case solver has to be restarted,
+        // the copies are only made before a substep modifies the states
+        StateCheckpoint< State >  state_checkpoint( state );
+        StateCheckpoint< WState > well_state_checkpoint( well_state );
 
         // reset the statistics for the failed substeps
         failureReport_ = SimulatorReport();
@@ -230,6 +232,9 @@ namespace Opm {
                 OpmLog::info(ss.str());
             }
 
+            state_checkpoint.prepare();
+            well_state_checkpoint.prepare();
+
             SimulatorReport substepReport;
             std::string cause_of_failure = "";
             try {
@@ -288,7 +293,7 @@ namespace Opm {
 
                 // create object to compute the time error, simply forwards the call to the model
                 detail::SolutionTimeErrorSolverWrapper< Solver, State >
-                    relativeChange( solver, last_state, state );
+                    relativeChange( solver, state_checkpoint.snapshot(), state );
 
                 // compute new time step estimate
                 const int iterations = use_newton_iteration_ ? substepReport.total_newton_iterations
@@ -332,9 +337,9 @@ namespace Opm {
                 // set new time step length
                 substepTimer.provideTimeStepEstimate( dtEstimate );
 
-                // update states
-                last_state      = state ;
-                last_well_state = well_state;
+                // accept states
+                state_checkpoint.commit();
+                well_state_checkpoint.commit();
 
                 report.converged = substepTimer.done();
                 substepTimer.setLastStepFailed(false);
@@ -366,8 +371,8 @@ namespace Opm {
                     OpmLog::problem(msg);
                 }
                 // reset states
-                state      = last_state;
-                well_state = last_well_state;
+                state_checkpoint.rollback();
+                well_state_checkpoint.rollback();
 
                 ++restarts;
             }
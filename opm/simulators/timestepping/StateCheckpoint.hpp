@@ -0,0 +1,103 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_STATECHECKPOINT_HEADER_INCLUDED
+#define OPM_STATECHECKPOINT_HEADER_INCLUDED
+
+#include <cassert>
+#include <memory>
+
+namespace Opm
+{
+
+    /// Checkpoint of a simulator state used to roll back failed time steps.
+    ///
+    /// The snapshot is taken lazily: commit() only marks the modified state
+    /// as accepted and the copy into the snapshot is deferred until prepare()
+    /// is called right before the state is modified again. A state that is
+    /// committed but never modified afterwards, e.g. after the last substep of
+    /// a report step, is therefore never copied. The snapshot buffer is
+    /// allocated once and reused by all later copies.
+    template <class State>
+    class StateCheckpoint
+    {
+    public:
+        /// \param state  state to checkpoint, it must outlive the checkpoint
+        explicit StateCheckpoint(State& state)
+            : state_(state),
+              snapshot_(),
+              upToDate_(false),
+              copies_(0)
+        {
+        }
+
+        /// Make sure the snapshot equals the current state. Must be called
+        /// before a step that may be rolled back modifies the state.
+        void prepare()
+        {
+            if (upToDate_) {
+                return;
+            }
+
+            if (snapshot_) {
+                *snapshot_ = state_;
+            } else {
+                snapshot_.reset(new State(state_));
+            }
+            upToDate_ = true;
+            ++copies_;
+        }
+
+        /// Accept the current state as the new checkpoint.
+        void commit()
+        {
+            upToDate_ = false;
+        }
+
+        /// Reset the state to the last checkpoint.
+        void rollback()
+        {
+            assert(upToDate_);
+            state_ = *snapshot_;
+        }
+
+        /// The state at the last checkpoint, only valid after prepare().
+        const State& snapshot() const
+        {
+            assert(upToDate_);
+            return *snapshot_;
+        }
+
+        /// The number of copies made into the snapshot.
+        int copies() const
+        {
+            return copies_;
+        }
+
+    private:
+        State& state_;
+        std::unique_ptr<State> snapshot_;
+        bool upToDate_;
+        int copies_;
+
+        // no copying
+        StateCheckpoint(const StateCheckpoint&) = delete;
+        StateCheckpoint& operator=(const StateCheckpoint&) = delete;
+    };
+
+} // namespace Opm
+
+#endif // OPM_STATECHECKPOINT_HEADER_INCLUDED
@@ -0,0 +1,260 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/simulators/vtk/VtkWriter.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/grid/UnstructuredGrid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif // HAVE_ZLIB
+
+
+namespace Opm
+{
+
+    namespace
+    {
+        // Size of the blocks compressed separately, as used by VTK.
+        const std::size_t compressionBlockSize = 32768;
+
+        template <class T>
+        void appendBytes(const T& value, std::vector<char>& appended)
+        {
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            appended.insert(appended.end(), bytes, bytes + sizeof(T));
+        }
+
+        const char* byteOrder()
+        {
+            const std::uint16_t one = 1;
+            return *reinterpret_cast<const unsigned char*>(&one) == 1
+                ? "LittleEndian" : "BigEndian";
+        }
+
+        // Attributes of the VTKFile element shared by all files.
+        std::string fileAttributes(const bool compress)
+        {
+            std::string attributes = std::string("version=\"1.0\" byte_order=\"")
+                + byteOrder() + "\" header_type=\"UInt64\"";
+            if (compress) {
+                attributes += " compressor=\"vtkZLibDataCompressor\"";
+            }
+            return attributes;
+        }
+
+        std::string scalarsAttribute(const DataMap& data)
+        {
+            if (data.find("saturation") != data.end()) {
+                return " Scalars=\"saturation\"";
+            } else if (data.find("pressure") != data.end()) {
+                return " Scalars=\"pressure\"";
+            }
+            return std::string();
+        }
+
+        int numComponents(const std::vector<double>& field, const int num_cells)
+        {
+            return num_cells > 0 ? field.size()/num_cells : 1;
+        }
+    } // anonymous namespace
+
+
+
+    VtkWriter::VtkWriter(const UnstructuredGrid& grid,
+                         const bool compress)
+        : grid_(grid),
+          compress_(compress)
+    {
+        if (grid.dimensions != 3) {
+            OPM_THROW(std::runtime_error, "Vtk output for 3d grids only");
+        }
+#if ! HAVE_ZLIB
+        if (compress) {
+            OPM_THROW(std::runtime_error, "Compressed vtk output requires zlib");
+        }
+#endif // ! HAVE_ZLIB
+
+        const int num_cells = grid.number_of_cells;
+        std::vector<std::int32_t> connectivity;
+        std::vector<std::int32_t> offsets;
+        std::vector<std::int32_t> faces;
+        std::vector<std::int32_t> face_offsets;
+        offsets.reserve(num_cells);
+        face_offsets.reserve(num_cells);
+        std::vector<int> cell_pts;
+        for (int c = 0; c < num_cells; ++c) {
+            // The points of a cell are the unique points of its faces.
+            cell_pts.clear();
+            faces.push_back(grid.cell_facepos[c + 1] - grid.cell_facepos[c]);
+            for (int hf = grid.cell_facepos[c]; hf < grid.cell_facepos[c + 1]; ++hf) {
+                const int f = grid.cell_faces[hf];
+                const int* fnbeg = grid.face_nodes + grid.face_nodepos[f];
+                const int* fnend = grid.face_nodes + grid.face_nodepos[f + 1];
+                cell_pts.insert(cell_pts.end(), fnbeg, fnend);
+                faces.push_back(fnend - fnbeg);
+                faces.insert(faces.end(), fnbeg, fnend);
+            }
+            std::sort(cell_pts.begin(), cell_pts.end());
+            cell_pts.erase(std::unique(cell_pts.begin(), cell_pts.end()), cell_pts.end());
+            connectivity.insert(connectivity.end(), cell_pts.begin(), cell_pts.end());
+            offsets.push_back(connectivity.size());
+            face_offsets.push_back(faces.size());
+        }
+        // All cells are polyhedra.
+        const std::vector<std::uint8_t> types(num_cells, 42);
+
+        geometry_offset_[Points] = geometry_.size();
+        appendArray(reinterpret_cast<const char*>(grid.node_coordinates),
+                    3*grid.number_of_nodes*sizeof(double), geometry_);
+        geometry_offset_[Connectivity] = geometry_.size();
+        appendArray(reinterpret_cast<const char*>(connectivity.data()),
+                    connectivity.size()*sizeof(std::int32_t), geometry_);
+        geometry_offset_[Offsets] = geometry_.size();
+        appendArray(reinterpret_cast<const char*>(offsets.data()),
+                    offsets.size()*sizeof(std::int32_t), geometry_);
+        geometry_offset_[Faces] = geometry_.size();
+        appendArray(reinterpret_cast<const char*>(faces.data()),
+                    faces.size()*sizeof(std::int32_t), geometry_);
+        geometry_offset_[FaceOffsets] = geometry_.size();
+        appendArray(reinterpret_cast<const char*>(face_offsets.data()),
+                    face_offsets.size()*sizeof(std::int32_t), geometry_);
+        geometry_offset_[Types] = geometry_.size();
+        appendArray(reinterpret_cast<const char*>(types.data()),
+                    types.size()*sizeof(std::uint8_t), geometry_);
+    }
+
+
+
+    const UnstructuredGrid& VtkWriter::grid() const
+    {
+        return grid_;
+    }
+
+
+
+    void VtkWriter::write(const DataMap& data, std::ostream& os) const
+    {
+        const int num_cells = grid_.number_of_cells;
+
+        // Encode the fields after the geometry in the appended data.
+        std::vector<char> appended;
+        std::vector<std::size_t> field_offset;
+        std::vector<double> values;
+        for (auto dit = data.begin(); dit != data.end(); ++dit) {
+            const std::vector<double>& field = *(dit->second);
+            values.resize(numComponents(field, num_cells)*num_cells);
+            std::transform(field.begin(), field.begin() + values.size(), values.begin(),
+                           [](const double value) {
+                               // Avoiding denormal numbers to work around
+                               // bug in Paraview.
+                               return std::fabs(value) < std::numeric_limits<double>::min()
+                                   ? 0.0 : value;
+                           });
+            field_offset.push_back(geometry_.size() + appended.size());
+            appendArray(reinterpret_cast<const char*>(values.data()),
+                        values.size()*sizeof(double), appended);
+        }
+
+        os << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"UnstructuredGrid\" " << fileAttributes(compress_) << ">\n"
+           << "  <UnstructuredGrid>\n"
+           << "    <Piece NumberOfPoints=\"" << grid_.number_of_nodes
+           << "\" NumberOfCells=\"" << num_cells << "\">\n"
+           << "      <Points>\n"
+           << "        <DataArray type=\"Float64\" Name=\"Coordinates\" NumberOfComponents=\"3\""
+           << " format=\"appended\" offset=\"" << geometry_offset_[Points] << "\"/>\n"
+           << "      </Points>\n"
+           << "      <Cells>\n";
+        const char* cell_arrays[] = { "connectivity", "offsets", "faces", "faceoffsets" };
+        for (int i = 0; i < 4; ++i) {
+            os << "        <DataArray type=\"Int32\" Name=\"" << cell_arrays[i] << "\""
+               << " format=\"appended\" offset=\"" << geometry_offset_[Connectivity + i] << "\"/>\n";
+        }
+        os << "        <DataArray type=\"UInt8\" Name=\"types\""
+           << " format=\"appended\" offset=\"" << geometry_offset_[Types] << "\"/>\n"
+           << "      </Cells>\n"
+           << "      <CellData" << scalarsAttribute(data) << ">\n";
+        int field = 0;
+        for (auto dit = data.begin(); dit != data.end(); ++dit, ++field) {
+            os << "        <DataArray type=\"Float64\" Name=\"" << dit->first << "\""
+               << " NumberOfComponents=\"" << numComponents(*(dit->second), num_cells) << "\""
+               << " format=\"appended\" offset=\"" << field_offset[field] << "\"/>\n";
+        }
+        os << "      </CellData>\n"
+           << "    </Piece>\n"
+           << "  </UnstructuredGrid>\n"
+           << "  <AppendedData encoding=\"raw\">\n"
+           << "_";
+        os.write(geometry_.data(), geometry_.size());
+        os.write(appended.data(), appended.size());
+        os << "\n"
+           << "  </AppendedData>\n"
+           << "</VTKFile>\n";
+    }
+
+
+
+    void VtkWriter::appendArray(const char* bytes, const std::size_t num_bytes,
+                                std::vector<char>& appended) const
+    {
+        if (!compress_) {
+            appendBytes(std::uint64_t(num_bytes), appended);
+            appended.insert(appended.end(), bytes, bytes + num_bytes);
+            return;
+        }
+
+#if HAVE_ZLIB
+        // The header is the number of blocks, the block size, the size of
+        // the last block and the compressed size of each block.
+        const std::size_t num_blocks = (num_bytes + compressionBlockSize - 1) / compressionBlockSize;
+        const std::size_t last_block_size = num_bytes - (num_blocks > 0 ? (num_blocks - 1)*compressionBlockSize : 0);
+        const std::size_t header_pos = appended.size();
+        appendBytes(std::uint64_t(num_blocks), appended);
+        appendBytes(std::uint64_t(compressionBlockSize), appended);
+        appendBytes(std::uint64_t(last_block_size), appended);
+        appended.resize(appended.size() + num_blocks*sizeof(std::uint64_t));
+
+        for (std::size_t block = 0; block < num_blocks; ++block) {
+            const std::size_t block_size = (block + 1 == num_blocks) ? last_block_size : compressionBlockSize;
+            uLongf compressed_size = compressBound(block_size);
+            const std::size_t pos = appended.size();
+            appended.resize(pos + compressed_size);
+            const int status = compress2(reinterpret_cast<Bytef*>(&appended[pos]), &compressed_size,
+                                         reinterpret_cast<const Bytef*>(bytes + block*compressionBlockSize),
+                                         block_size, Z_BEST_SPEED);
+            if (status != Z_OK) {
+                OPM_THROW(std::runtime_error, "Failed to compress vtk data, zlib error " << status);
+            }
+            appended.resize(pos + compressed_size);
+            const std::uint64_t size = compressed_size;
+            std::copy_n(reinterpret_cast<const char*>(&size), sizeof(size),
+                        &appended[header_pos + (3 + block)*sizeof(std::uint64_t)]);
+        }
+#endif // HAVE_ZLIB
+    }
+
+} // namespace Opm
@@ -0,0 +1,71 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_VTKWRITER_HEADER_INCLUDED
+#define OPM_VTKWRITER_HEADER_INCLUDED
+
+#include <opm/core/utility/DataMap.hpp>
+
+#include <array>
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    /// Vtk output of cell data on general 3d grids, in the XML format with
+    /// all arrays appended as raw binary data, optionally compressed with
+    /// zlib. The points and connectivity of the grid are encoded once, when
+    /// the writer is created, and reused for every file written.
+    class VtkWriter
+    {
+    public:
+        /// \param[in] grid      The grid, must outlive the writer.
+        /// \param[in] compress  Compress the arrays with zlib. Requires
+        ///                      zlib to be found when building.
+        explicit VtkWriter(const UnstructuredGrid& grid,
+                           const bool compress = false);
+
+        /// The grid written.
+        const UnstructuredGrid& grid() const;
+
+        /// Write a .vtu file with the grid and the cell data. The number
+        /// of components of each field is its size divided by the number
+        /// of cells.
+        void write(const DataMap& data, std::ostream& os) const;
+
+    private:
+        // Append the header and the possibly compressed bytes of an array
+        // to the appended data.
+        void appendArray(const char* bytes, const std::size_t num_bytes,
+                         std::vector<char>& appended) const;
+
+        const UnstructuredGrid& grid_;
+        const bool compress_;
+
+        // The encoded points and cell arrays, and their offsets in it.
+        enum { Points, Connectivity, Offsets, Faces, FaceOffsets, Types, NumGeometryArrays };
+        std::vector<char> geometry_;
+        std::array<std::size_t, NumGeometryArrays> geometry_offset_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_VTKWRITER_HEADER_INCLUDED
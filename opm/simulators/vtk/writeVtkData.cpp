@@ -22,7 +22,6 @@
 #include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/grid/UnstructuredGrid.h>
-#include <set>
 #include <cmath>
 #include <algorithm>
 #include <iostream>
@@ -184,14 +183,17 @@ namespace Opm
                pm["Name"] = "connectivity";
                Tag t("DataArray", pm, os);
                int hf = 0;
+               std::vector<int> cell_pts;
                for (int c = 0; c < num_cells; ++c) {
-                   std::set<int> cell_pts;
+                   cell_pts.clear();
                    for (; hf < grid.cell_facepos[c+1]; ++hf) {
                        int f = grid.cell_faces[hf];
                        const int* fnbeg = grid.face_nodes + grid.face_nodepos[f];
                        const int* fnend = grid.face_nodes + grid.face_nodepos[f+1];
-                       cell_pts.insert(fnbeg, fnend);
+                       cell_pts.insert(cell_pts.end(), fnbeg, fnend);
                    }
+                   std::sort(cell_pts.begin(), cell_pts.end());
+                   cell_pts.erase(std::unique(cell_pts.begin(), cell_pts.end()), cell_pts.end());
                    cell_numpts.push_back(cell_pts.size());
                    Tag::indent(os);
                    std::copy(cell_pts.begin(), cell_pts.end(),
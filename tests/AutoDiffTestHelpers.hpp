@@ -0,0 +1,63 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_AUTODIFFTESTHELPERS_HEADER
+#define OPM_AUTODIFFTESTHELPERS_HEADER
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+
+#include <cmath>
+
+/// \brief Check that two AutoDiffBlocks have the same values and
+///        jacobians, up to rounding.
+///
+/// The jacobians are compared as sparse matrices, so this also works for
+/// blocks with many rows.
+/// \param tol Tolerance relative to the size of the entries.
+inline void checkEqual(const Opm::AutoDiffBlock<double>& a,
+                       const Opm::AutoDiffBlock<double>& b,
+                       const double tol = 1e-12)
+{
+    BOOST_REQUIRE_EQUAL(a.value().size(), b.value().size());
+    for (int i = 0; i < a.value().size(); ++i) {
+        BOOST_CHECK(std::abs(a.value()[i] - b.value()[i]) <= tol * (1.0 + std::abs(b.value()[i])));
+    }
+    BOOST_REQUIRE_EQUAL(a.numBlocks(), b.numBlocks());
+    for (int block = 0; block < a.numBlocks(); ++block) {
+        const Eigen::SparseMatrix<double>& ja = a.derivative()[block].getSparse();
+        const Eigen::SparseMatrix<double>& jb = b.derivative()[block].getSparse();
+        BOOST_REQUIRE_EQUAL(ja.rows(), jb.rows());
+        BOOST_REQUIRE_EQUAL(ja.cols(), jb.cols());
+        const Eigen::SparseMatrix<double> diff = ja - jb;
+        BOOST_CHECK(diff.norm() <= tol * (1.0 + jb.norm()));
+    }
+}
+
+/// \brief A 4x4 matrix with a general sparsity pattern, to form jacobians
+///        that are neither zero, identity nor diagonal.
+inline Eigen::SparseMatrix<double> generalSparseMatrix()
+{
+    Eigen::SparseMatrix<double> mix(4, 4);
+    mix.insert(0, 0) = 1.0;
+    mix.insert(0, 3) = 2.0;
+    mix.insert(1, 2) = -1.0;
+    mix.insert(3, 1) = 0.5;
+    mix.insert(3, 3) = 3.0;
+    mix.makeCompressed();
+    return mix;
+}
+
+#endif // OPM_AUTODIFFTESTHELPERS_HEADER
@@ -0,0 +1,117 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE AutoDiffProductTest
+
+#include <opm/autodiff/AutoDiffProduct.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "AutoDiffTestHelpers.hpp"
+
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    typedef AutoDiffBlock<double> ADB;
+    typedef ADB::V V;
+    typedef Eigen::SparseMatrix<double> S;
+
+    const std::vector<int> blocksizes = { 4, 3, 4 };
+
+    V values(const double a, const double b, const double c, const double d)
+    {
+        V v(4);
+        v << a, b, c, d;
+        return v;
+    }
+
+    // A variable of the first block, with an identity jacobian.
+    ADB identityQuantity()
+    {
+        return ADB::variable(0, values(1.0, 3.0, -2.0, 0.5), blocksizes);
+    }
+
+    // A function of the first block, with a diagonal jacobian.
+    ADB diagonalQuantity()
+    {
+        const ADB x = ADB::variable(0, values(2.0, -1.0, 0.25, 4.0), blocksizes);
+        return x * x;
+    }
+
+    // A function of the first and last blocks, with general sparse
+    // jacobians.
+    ADB sparseQuantity()
+    {
+        const ADB z = ADB::variable(2, values(0.25, -1.0, 4.0, 2.0), blocksizes);
+        return identityQuantity() + generalSparseMatrix() * z;
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE(Products)
+{
+    const ADB x = identityQuantity();
+    const ADB y = diagonalQuantity();
+    const ADB z = sparseQuantity();
+    const V v = values(1.5, -2.0, 0.0, 3.0);
+
+    checkEqual(fusedProduct(x) * y, x * y);
+    checkEqual(fusedProduct(x) * y * z, x * y * z);
+    checkEqual(fusedProduct(v) * z * x, v * z * x);
+    checkEqual(fusedProduct(z) * v * z, z * v * z);
+    // Only one factor with derivatives.
+    checkEqual(fusedProduct(v) * v * z, v * v * z);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(Quotients)
+{
+    const ADB x = identityQuantity();
+    const ADB y = diagonalQuantity();
+    const ADB z = sparseQuantity();
+    const V v = values(1.5, -2.0, 0.5, 3.0);
+
+    checkEqual(fusedProduct(x) * y / z, x * y / z);
+    checkEqual(fusedProduct(z) / x / v, z / x / v);
+    checkEqual(fusedProduct(v) / y, v / y);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(Constants)
+{
+    const ADB c = ADB::constant(values(1.0, 2.0, 3.0, 4.0));
+    const V v = values(1.5, -2.0, 0.5, 3.0);
+    const ADB x = identityQuantity();
+
+    const ADB cv = fusedProduct(c) * v;
+    BOOST_CHECK_EQUAL(cv.numBlocks(), 0);
+    checkEqual(cv, c * v);
+    checkEqual(fusedProduct(c) * x, c * x);
+
+    // Factors with zero jacobian blocks give zero blocks.
+    const ADB p = fusedProduct(x) * x;
+    BOOST_CHECK_EQUAL(p.derivative()[1].nonZeros(), 0);
+    BOOST_CHECK_EQUAL(p.derivative()[2].nonZeros(), 0);
+}
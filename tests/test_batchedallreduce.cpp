@@ -0,0 +1,81 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <config.h>
+
+#define BOOST_TEST_MODULE BatchedAllReduceTests
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/BatchedAllReduce.hpp>
+
+#include <vector>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(MixedOperations)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const int size = cc.size();
+    const int rank = cc.rank();
+
+    Opm::BatchedAllReduce reduction(cc);
+    const auto sumHandle = reduction.sum(rank + 1.0);
+    const auto maxHandle = reduction.max(static_cast<double>(rank));
+    const auto minHandle = reduction.min(rank - 1.0);
+    const std::vector<double> values(10, 2.0);
+    const auto rangeHandle = reduction.sum(values);
+    BOOST_CHECK_EQUAL(reduction.size(), 13u);
+
+    reduction.execute();
+
+    BOOST_CHECK_CLOSE(reduction[sumHandle], 0.5 * size * (size + 1), 1e-12);
+    BOOST_CHECK_EQUAL(reduction[maxHandle], size - 1.0);
+    BOOST_CHECK_EQUAL(reduction[minHandle], -1.0);
+
+    std::vector<double> sums(values.size());
+    reduction.get(rangeHandle, sums);
+    for (const double s : sums) {
+        BOOST_CHECK_CLOSE(s, 2.0 * size, 1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Reuse)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const int size = cc.size();
+
+    Opm::BatchedAllReduce reduction(cc);
+    for (int i = 0; i < 3; ++i) {
+        reduction.clear();
+        const auto handle = reduction.sum(static_cast<double>(i));
+        reduction.start();
+        reduction.wait();
+        BOOST_CHECK_EQUAL(reduction[handle], static_cast<double>(i * size));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    boost::unit_test::unit_test_main(&init_unit_test_func,
+                                     argc, argv);
+}
@@ -26,7 +26,10 @@
 #include <boost/test/unit_test.hpp>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include "AutoDiffTestHelpers.hpp"
+
 #include <opm/autodiff/BlackoilPropsAdFromDeck.hpp>
+#include <opm/core/props/BlackoilPhases.hpp>
 
 #include <opm/grid/GridManager.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
@@ -39,6 +42,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 
 struct SetupSimple {
@@ -58,6 +62,22 @@ struct SetupSimple {
     Opm::EclipseState eclState;
 };
 
+struct SetupRegions {
+    SetupRegions() :
+        deck( Opm::Parser{}.parseFile("pvt_regions.DATA") ),
+        eclState( deck, Opm::ParseContext() )
+    {
+        param.disableOutput();
+        param.insertParameter("init_rock"       , "false" );
+        param.insertParameter("pvt_tab_size"    , "0"     );
+        param.insertParameter("sat_tab_size"    , "0"     );
+    }
+
+    Opm::ParameterGroup  param;
+    Opm::Deck deck;
+    Opm::EclipseState eclState;
+};
+
 
 template <class Setup>
 struct TestFixture : public Setup
@@ -206,3 +226,153 @@ BOOST_FIXTURE_TEST_CASE(criticalSaturations, TestFixture<SetupSimple>)
     BOOST_CHECK_EQUAL(sogcr[0], 0.13);
 
 }
+
+
+namespace
+{
+    typedef Opm::BlackoilPropsAdFromDeck::ADB ADB;
+    typedef Opm::BlackoilPropsAdFromDeck::V V;
+    typedef Opm::BlackoilPropsAdFromDeck::Cells Cells;
+    typedef Opm::DenseAd::Evaluation<double, /*size=*/2> Eval;
+
+    // The per-cell formulation of a property f(p, r): f is evaluated cell
+    // by cell with the tables of the region of the cell, and the
+    // jacobians are diag(df/dp) * dp + diag(df/dr) * dr.
+    template <class Property>
+    ADB perCellProperty(const ADB& p,
+                        const ADB& r,
+                        const Cells& cells,
+                        const std::vector<int>& pvtRegions,
+                        const Property& property)
+    {
+        const int n = cells.size();
+        V f(n);
+        V dfdp(n);
+        V dfdr(n);
+
+        Eval pEval = 0.0;
+        Eval rEval = 0.0;
+        pEval.setDerivative(0, 1.0);
+        rEval.setDerivative(1, 1.0);
+        for (int i = 0; i < n; ++i) {
+            pEval.setValue(p.value()[i]);
+            rEval.setValue(r.value()[i]);
+            const Eval fEval = property(pvtRegions[cells[i]], i, pEval, rEval);
+            f[i] = fEval.value();
+            dfdp[i] = fEval.derivative(0);
+            dfdr[i] = fEval.derivative(1);
+        }
+
+        const ADB::M dfdp_diag(dfdp.matrix().asDiagonal());
+        const ADB::M dfdr_diag(dfdr.matrix().asDiagonal());
+        std::vector<ADB::M> jacs(p.numBlocks());
+        for (int block = 0; block < p.numBlocks(); ++block) {
+            jacs[block] = dfdp_diag * p.derivative()[block] + dfdr_diag * r.derivative()[block];
+        }
+        return ADB::function(std::move(f), std::move(jacs));
+    }
+
+    // A dissolution factor r that depends on both the pressure (block 0)
+    // and its own primary variable (block 1), so that both terms of the
+    // chain rule contribute to block 0.
+    ADB pressureDependent(const V& r, const std::vector<int>& bp)
+    {
+        const int n = r.size();
+        std::vector<ADB::M> jacs;
+        jacs.push_back(ADB::M(V::Constant(n, 1.0e-7).matrix().asDiagonal()));
+        jacs.push_back(ADB::M::createIdentity(n));
+        return ADB::function(V(r), std::move(jacs));
+    }
+
+    // Phase presence patterns that differ between two calls.
+    std::vector<Opm::PhasePresence> presence(const int n, const int gas_period, const int oil_period)
+    {
+        std::vector<Opm::PhasePresence> cond(n);
+        for (int i = 0; i < n; ++i) {
+            if (i % gas_period == 0) {
+                cond[i].setFreeGas();
+            }
+            if (i % oil_period == 0) {
+                cond[i].setFreeOil();
+            }
+        }
+        return cond;
+    }
+}
+
+// Two PVT regions, more evaluated cells than fit in one chunk, and the
+// same cells evaluated again with a different phase presence.
+BOOST_FIXTURE_TEST_CASE(GroupedPvtJacobians, TestFixtureAd<SetupRegions>)
+{
+    const int nc = grid.c_grid()->number_of_cells;
+    BOOST_REQUIRE(nc > 2 * 1024);
+
+    // All cells, interleaved so that the regions are mixed.
+    Cells cells(nc);
+    for (int i = 0; i < nc; ++i) {
+        cells[i] = (i * 7) % nc;
+    }
+    const std::vector<int>& pvtRegions = props.pvtRegions();
+    BOOST_CHECK_EQUAL(pvtRegions[cells[0]], 0);
+    BOOST_CHECK_EQUAL(pvtRegions[cells[nc / 2]], 1);
+
+    const std::vector<int> bp = { nc, nc };
+    V pv(nc);
+    for (int i = 0; i < nc; ++i) {
+        pv[i] = (100.0 + (100.0 * i) / nc) * Opm::unit::barsa;
+    }
+    const ADB p = ADB::variable(0, pv, bp);
+    const ADB T = ADB::constant(V::Constant(nc, 273.15 + 20));
+    const Eval TEval = 273.15 + 20;
+    const Eval TSat = 293.15;
+
+    const auto& oil = props.oilProps();
+    const auto& gas = props.gasProps();
+
+    const ADB rsSat = props.rsSat(p, cells);
+    checkEqual(rsSat, perCellProperty(p, ADB::constant(V::Zero(nc), bp), cells, pvtRegions,
+                                      [&](const unsigned r, int, const Eval& pe, const Eval&) {
+                                          return oil.saturatedGasDissolutionFactor(r, TSat, pe);
+                                      }));
+    const ADB rvSat = props.rvSat(p, cells);
+    checkEqual(rvSat, perCellProperty(p, ADB::constant(V::Zero(nc), bp), cells, pvtRegions,
+                                      [&](const unsigned r, int, const Eval& pe, const Eval&) {
+                                          return gas.saturatedOilVaporizationFactor(r, TSat, pe);
+                                      }));
+
+    // Undersaturated where the phase is not present.
+    const ADB rs = pressureDependent(0.5 * rsSat.value(), bp);
+    const ADB rv = pressureDependent(0.5 * rvSat.value(), bp);
+
+    const std::vector<std::vector<Opm::PhasePresence>> conds = { presence(nc, 3, 2), presence(nc, 2, 5) };
+    for (const std::vector<Opm::PhasePresence>& cond : conds) {
+        checkEqual(props.muOil(p, T, rs, cond, cells),
+                   perCellProperty(p, rs, cells, pvtRegions,
+                                   [&](const unsigned r, const int i, const Eval& pe, const Eval& rse) {
+                                       return cond[i].hasFreeGas()
+                                           ? oil.saturatedViscosity(r, TEval, pe)
+                                           : oil.viscosity(r, TEval, pe, rse);
+                                   }));
+        checkEqual(props.bOil(p, T, rs, cond, cells),
+                   perCellProperty(p, rs, cells, pvtRegions,
+                                   [&](const unsigned r, const int i, const Eval& pe, const Eval& rse) {
+                                       return cond[i].hasFreeGas()
+                                           ? oil.saturatedInverseFormationVolumeFactor(r, TEval, pe)
+                                           : oil.inverseFormationVolumeFactor(r, TEval, pe, rse);
+                                   }));
+        checkEqual(props.muGas(p, T, rv, cond, cells),
+                   perCellProperty(p, rv, cells, pvtRegions,
+                                   [&](const unsigned r, const int i, const Eval& pe, const Eval& rve) {
+                                       return cond[i].hasFreeOil()
+                                           ? gas.saturatedViscosity(r, TEval, pe)
+                                           : gas.viscosity(r, TEval, pe, rve);
+                                   }));
+        checkEqual(props.bGas(p, T, rv, cond, cells),
+                   perCellProperty(p, rv, cells, pvtRegions,
+                                   [&](const unsigned r, const int i, const Eval& pe, const Eval& rve) {
+                                       return cond[i].hasFreeOil()
+                                           ? gas.saturatedInverseFormationVolumeFactor(r, TEval, pe)
+                                           : gas.inverseFormationVolumeFactor(r, TEval, pe, rve);
+                                   }));
+    }
+}
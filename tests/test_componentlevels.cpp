@@ -0,0 +1,175 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ComponentLevelsTests
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/transport/reorder/ComponentLevels.hpp>
+#include <opm/core/transport/reorder/reordersequence.h>
+#include <opm/grid/UnstructuredGrid.h>
+#include <opm/grid/cart_grid.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    struct Ordering
+    {
+        Ordering(const UnstructuredGrid& grid, const std::vector<double>& flux)
+            : sequence(grid.number_of_cells),
+              components(grid.number_of_cells + 1)
+        {
+            int num_components = 0;
+            compute_sequence(&grid, flux.data(), sequence.data(), components.data(), &num_components);
+            components.resize(num_components + 1);
+            levels.compute(grid, sequence.data(), components.data(), num_components);
+        }
+
+        std::vector<int> sequence;
+        std::vector<int> components;
+        Opm::ComponentLevels levels;
+    };
+
+    // The level of the component of each cell.
+    std::vector<int> cellLevels(const UnstructuredGrid& grid, const Ordering& ordering)
+    {
+        std::vector<int> level(grid.number_of_cells, -1);
+        const auto& start = ordering.levels.levelStart();
+        for (int l = 0; l < ordering.levels.numLevels(); ++l) {
+            for (int k = start[l]; k < start[l + 1]; ++k) {
+                const int comp = ordering.levels.levelComponents()[k];
+                for (int i = ordering.components[comp]; i < ordering.components[comp + 1]; ++i) {
+                    level[ordering.sequence[i]] = l;
+                }
+            }
+        }
+        return level;
+    }
+
+    // Neighbouring cells must either be in the same component or in
+    // different levels, in the order of the sequence.
+    void checkLevels(const UnstructuredGrid& grid, const Ordering& ordering)
+    {
+        std::vector<int> position(grid.number_of_cells);
+        std::vector<int> component(grid.number_of_cells);
+        const int num_components = ordering.components.size() - 1;
+        for (int comp = 0; comp < num_components; ++comp) {
+            for (int i = ordering.components[comp]; i < ordering.components[comp + 1]; ++i) {
+                position[ordering.sequence[i]] = i;
+                component[ordering.sequence[i]] = comp;
+            }
+        }
+        const std::vector<int> level = cellLevels(grid, ordering);
+        for (int f = 0; f < grid.number_of_faces; ++f) {
+            const int c0 = grid.face_cells[2*f];
+            const int c1 = grid.face_cells[2*f + 1];
+            if (c0 < 0 || c1 < 0 || component[c0] == component[c1]) {
+                continue;
+            }
+            const int first = position[c0] < position[c1] ? c0 : c1;
+            const int second = first == c0 ? c1 : c0;
+            BOOST_CHECK_LT(level[first], level[second]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DiagonalFlow)
+{
+    const int nx = 4, ny = 3, nz = 2;
+    std::shared_ptr<UnstructuredGrid> grid(create_grid_cart3d(nx, ny, nz), destroy_grid);
+    // the flux of all faces is from the lower to the higher cell index
+    const std::vector<double> flux(grid->number_of_faces, 1.0);
+    const Ordering ordering(*grid, flux);
+
+    BOOST_CHECK_EQUAL(ordering.levels.numComponents(), nx*ny*nz);
+    BOOST_CHECK_EQUAL(ordering.levels.numLevels(), nx + ny + nz - 2);
+
+    // the levels are the diagonal planes i + j + k = const
+    const std::vector<int> level = cellLevels(*grid, ordering);
+    for (int k = 0; k < nz; ++k) {
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                BOOST_CHECK_EQUAL(level[i + nx*(j + ny*k)], i + j + k);
+            }
+        }
+    }
+    checkLevels(*grid, ordering);
+}
+
+BOOST_AUTO_TEST_CASE(FlowWithLoops)
+{
+    const int nx = 10, ny = 10, nz = 3;
+    std::shared_ptr<UnstructuredGrid> grid(create_grid_cart3d(nx, ny, nz), destroy_grid);
+    std::vector<double> flux(grid->number_of_faces, 1.0);
+    for (int f = 0; f < grid->number_of_faces; f += 7) {
+        flux[f] = -1.0;
+    }
+    // cells without flux between them must be ordered as well
+    for (int f = 3; f < grid->number_of_faces; f += 11) {
+        flux[f] = 0.0;
+    }
+    const Ordering ordering(*grid, flux);
+
+    BOOST_CHECK_LT(ordering.levels.numComponents(), nx*ny*nz);
+    checkLevels(*grid, ordering);
+}
+
+BOOST_AUTO_TEST_CASE(ForEachComponent)
+{
+    const int nx = 20, ny = 20, nz = 5;
+    std::shared_ptr<UnstructuredGrid> grid(create_grid_cart3d(nx, ny, nz), destroy_grid);
+    const std::vector<double> flux(grid->number_of_faces, 1.0);
+    const Ordering ordering(*grid, flux);
+    const int num_components = ordering.levels.numComponents();
+
+    // Every component is visited once, after its upstream neighbours.
+    std::vector<int> visits(num_components, 0);
+    std::vector<int> visit_index(num_components, -1);
+    std::atomic<int> counter(0);
+    ordering.levels.forEachComponent([&](const int comp) {
+            ++visits[comp];
+            visit_index[comp] = counter++;
+        });
+
+    for (int comp = 0; comp < num_components; ++comp) {
+        BOOST_CHECK_EQUAL(visits[comp], 1);
+    }
+    // with one cell per component, the component of a cell is its position in the sequence
+    std::vector<int> component(grid->number_of_cells);
+    for (int comp = 0; comp < num_components; ++comp) {
+        component[ordering.sequence[comp]] = comp;
+    }
+    for (int f = 0; f < grid->number_of_faces; ++f) {
+        const int c0 = grid->face_cells[2*f];
+        const int c1 = grid->face_cells[2*f + 1];
+        if (c0 >= 0 && c1 >= 0) {
+            BOOST_CHECK_LT(visit_index[component[c0]], visit_index[component[c1]]);
+        }
+    }
+
+    // Exceptions are passed on to the caller.
+    BOOST_CHECK_THROW(ordering.levels.forEachComponent([](const int comp) {
+                if (comp == 17) {
+                    throw std::runtime_error("component failed");
+                }
+            }), std::runtime_error);
+}
@@ -0,0 +1,272 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ConnectionOperatorTest
+
+#include <opm/autodiff/ConnectionOperator.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "AutoDiffTestHelpers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
+using namespace Opm;
+
+namespace
+{
+    typedef AutoDiffBlock<double> ADB;
+    typedef ADB::V V;
+    typedef Eigen::SparseMatrix<double> S;
+
+    // A 2x2 grid with a non-neighbouring connection between cells 0 and
+    // 3. The full graph also has the boundary faces.
+    //   2 3
+    //   0 1
+    std::vector<std::array<int, 2>> internalConnections()
+    {
+        return { {{ 0, 1 }}, {{ 2, 3 }}, {{ 0, 2 }}, {{ 1, 3 }}, {{ 0, 3 }} };
+    }
+
+    std::vector<std::array<int, 2>> allConnections()
+    {
+        return { {{ -1, 0 }}, {{ 0, 1 }}, {{ 1, -1 }}, {{ -1, 2 }}, {{ 2, 3 }}, {{ 3, -1 }},
+                 {{ -1, 0 }}, {{ 0, 2 }}, {{ 2, -1 }}, {{ -1, 1 }}, {{ 1, 3 }}, {{ 3, -1 }},
+                 {{ 0, 3 }} };
+    }
+
+    // The operator as an explicit matrix, as HelperOps used to build it.
+    S explicitOperator(const std::vector<std::array<int, 2>>& conns, const int nc,
+                       const double w0, const double w1)
+    {
+        std::vector<Eigen::Triplet<double>> tri;
+        for (int i = 0; i < int(conns.size()); ++i) {
+            if (conns[i][0] >= 0) {
+                tri.emplace_back(i, conns[i][0], w0);
+            }
+            if (conns[i][1] >= 0) {
+                tri.emplace_back(i, conns[i][1], w1);
+            }
+        }
+        S op(conns.size(), nc);
+        op.setFromTriplets(tri.begin(), tri.end());
+        return op;
+    }
+
+    // An AutoDiffBlock with an identity, a zero and a general sparse
+    // jacobian.
+    ADB cellQuantity()
+    {
+        const std::vector<int> blocksizes = { 4, 3, 4 };
+        V p(4);
+        p << 1.0, 3.0, -2.0, 0.5;
+        V q(4);
+        q << 0.25, -1.0, 4.0, 2.0;
+        const ADB x = ADB::variable(0, p, blocksizes);
+        const ADB z = ADB::variable(2, q, blocksizes);
+        return x + x * (generalSparseMatrix() * z);
+    }
+
+    ADB connectionQuantity(const int n)
+    {
+        const std::vector<int> blocksizes = { n, 2 };
+        V v(n);
+        for (int i = 0; i < n; ++i) {
+            v[i] = 1.5 * i - 4.0;
+        }
+        const ADB x = ADB::variable(0, v, blocksizes);
+        return x * x;
+    }
+
+    // The sparsity pattern of the product must be the same as that of
+    // the explicit product, entry by entry in compressed storage, and
+    // the values the same up to rounding.
+    void checkSparse(const S& product, const S& expected)
+    {
+        BOOST_REQUIRE(product.isCompressed());
+        BOOST_REQUIRE_EQUAL(product.rows(), expected.rows());
+        BOOST_REQUIRE_EQUAL(product.cols(), expected.cols());
+        BOOST_REQUIRE_EQUAL(product.nonZeros(), expected.nonZeros());
+        BOOST_CHECK(std::equal(product.outerIndexPtr(), product.outerIndexPtr() + product.cols() + 1,
+                               expected.outerIndexPtr()));
+        BOOST_CHECK(std::equal(product.innerIndexPtr(), product.innerIndexPtr() + product.nonZeros(),
+                               expected.innerIndexPtr()));
+        for (int k = 0; k < product.nonZeros(); ++k) {
+            const double value = expected.valuePtr()[k];
+            BOOST_CHECK(std::abs(product.valuePtr()[k] - value) <= 1e-12 * (1.0 + std::abs(value)));
+        }
+    }
+
+    void checkProduct(const ADB& product, const S& explicit_op, const ADB& x)
+    {
+        const V expected = (explicit_op * x.value().matrix()).array();
+        BOOST_REQUIRE_EQUAL(product.value().size(), expected.size());
+        for (int i = 0; i < expected.size(); ++i) {
+            BOOST_CHECK_CLOSE(product.value()[i], expected[i], 1e-12);
+        }
+        BOOST_REQUIRE_EQUAL(product.numBlocks(), x.numBlocks());
+        for (int block = 0; block < x.numBlocks(); ++block) {
+            const S expected_jac = explicit_op * x.derivative()[block].getSparse();
+            checkSparse(product.derivative()[block].getSparse(), expected_jac);
+        }
+    }
+
+    void checkOperator(const std::vector<std::array<int, 2>>& conns, const ADB& x,
+                       const double w0, const double w1)
+    {
+        const int nc = x.size();
+        auto graph = std::make_shared<const ConnectionGraph>(nc, std::vector<std::array<int, 2>>(conns));
+        const ConnectionOperator op(graph, w0, w1);
+        const S explicit_op = explicitOperator(conns, nc, w0, w1);
+
+        BOOST_CHECK_EQUAL(op.rows(), int(conns.size()));
+        BOOST_CHECK_EQUAL(op.cols(), nc);
+        checkSparse(op.sparse(), explicit_op);
+
+        checkProduct(op * x, explicit_op, x);
+        const Eigen::VectorXd v = op * x.value().matrix();
+        BOOST_CHECK((v - explicit_op * x.value().matrix()).norm() < 1e-12);
+
+        const ConnectionOperator opt = op.transpose();
+        const S explicit_opt = explicit_op.transpose();
+        BOOST_CHECK_EQUAL(opt.rows(), nc);
+        BOOST_CHECK_EQUAL(opt.cols(), int(conns.size()));
+        const ADB f = connectionQuantity(conns.size());
+        checkProduct(opt * f, explicit_opt, f);
+    }
+
+    // A line of n cells with boundary faces at both ends and a
+    // non-neighbouring connection from every seventh cell to the cell
+    // five further on.
+    std::vector<std::array<int, 2>> lineConnections(const int n)
+    {
+        std::vector<std::array<int, 2>> conns = { {{ -1, 0 }} };
+        for (int i = 0; i + 1 < n; ++i) {
+            conns.push_back({{ i, i + 1 }});
+            if (i % 7 == 0 && i + 5 < n) {
+                conns.push_back({{ i, i + 5 }});
+            }
+        }
+        conns.push_back({{ n - 1, -1 }});
+        return conns;
+    }
+
+    // An AutoDiffBlock of n cells with an identity and a banded jacobian.
+    ADB lineQuantity(const int n)
+    {
+        const std::vector<int> blocksizes = { n, n };
+        V p(n);
+        for (int i = 0; i < n; ++i) {
+            p[i] = 0.5 * i - 3.0;
+        }
+        std::vector<Eigen::Triplet<double>> tri;
+        for (int i = 0; i < n; ++i) {
+            for (int j = std::max(0, i - 2); j < std::min(n, i + 3); j += 2) {
+                tri.emplace_back(i, j, 1.0 + 0.25 * i - 0.5 * j);
+            }
+        }
+        S band(n, n);
+        band.setFromTriplets(tri.begin(), tri.end());
+        const ADB x = ADB::variable(0, p, blocksizes);
+        const ADB z = ADB::variable(1, p, blocksizes);
+        return x + band * z;
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE(Graph)
+{
+    const ConnectionGraph graph(4, allConnections());
+    BOOST_CHECK_EQUAL(graph.numCells(), 4);
+    BOOST_CHECK_EQUAL(graph.numConnections(), 13);
+
+    // cell 3 is the second cell of 4, 10, 12 and the first of 5 and 11
+    const std::vector<int> conns = { 4, 5, 10, 11, 12 };
+    const std::vector<int> sides = { 1, 0, 1, 0, 1 };
+    BOOST_REQUIRE_EQUAL(graph.cellEnd(3) - graph.cellBegin(3), 5);
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(graph.connection(graph.cellBegin(3) + i), conns[i]);
+        BOOST_CHECK_EQUAL(graph.side(graph.cellBegin(3) + i), sides[i]);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE(GradAverageDiv)
+{
+    const ADB x = cellQuantity();
+    // ngrad and div
+    checkOperator(internalConnections(), x, 1.0, -1.0);
+    // grad
+    checkOperator(internalConnections(), x, -1.0, 1.0);
+    // caver
+    checkOperator(internalConnections(), x, 0.5, 0.5);
+    // fullngrad and fulldiv
+    checkOperator(allConnections(), x, 1.0, -1.0);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(ManyColumns)
+{
+    // Enough columns for the products to be formed in several chunks.
+#if HAVE_OPENMP
+    const int num_threads = omp_get_max_threads();
+    omp_set_num_threads(std::max(num_threads, 4));
+#endif // HAVE_OPENMP
+    const int n = 4 * 1024 + 123;
+    const ADB x = lineQuantity(n);
+    checkOperator(lineConnections(n), x, 1.0, -1.0);
+    checkOperator(lineConnections(n), x, 0.5, 0.5);
+#if HAVE_OPENMP
+    omp_set_num_threads(num_threads);
+#endif // HAVE_OPENMP
+}
+
+
+
+BOOST_AUTO_TEST_CASE(Upwind)
+{
+    const auto conns = internalConnections();
+    auto graph = std::make_shared<const ConnectionGraph>(4, internalConnections());
+    V flux(5);
+    flux << 1.0, -2.0, 0.0, -0.5, 3.0;
+    const ConnectionSelector selector(graph, flux);
+
+    S select(5, 4);
+    for (int i = 0; i < 5; ++i) {
+        select.insert(i, conns[i][flux[i] >= 0.0 ? 0 : 1]) = 1.0;
+    }
+
+    const ADB x = cellQuantity();
+    checkEqual(selector * x, select * x);
+    const V v = selector * x.value();
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(v[i], x.value()[conns[i][flux[i] >= 0.0 ? 0 : 1]]);
+    }
+}
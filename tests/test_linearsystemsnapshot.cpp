@@ -0,0 +1,161 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSystemSnapshotTests
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/LinearSystemSnapshot.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    typedef Dune::FieldMatrix<double, 3, 3> Block;
+    typedef Dune::BCRSMatrix<Block> Matrix;
+    typedef Dune::FieldMatrix<double, 2, 3> OffDiagBlock;
+    typedef Dune::BCRSMatrix<OffDiagBlock> OffDiagMatrix;
+    typedef Dune::BlockVector<Dune::FieldVector<double, 3> > Vector;
+
+    // A tridiagonal matrix with distinct entries.
+    template <class M>
+    M createMatrix(const int rows, const int cols)
+    {
+        M A(rows, cols, M::row_wise);
+        for (auto row = A.createbegin(); row != A.createend(); ++row) {
+            for (int col = row.index() - 1; col <= int(row.index()) + 1; ++col) {
+                if (col >= 0 && col < cols) {
+                    row.insert(col);
+                }
+            }
+        }
+        double value = 1.0;
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                for (auto i = col->begin(); i != col->end(); ++i) {
+                    for (auto j = i->begin(); j != i->end(); ++j) {
+                        *j = value;
+                        value += 0.5;
+                    }
+                }
+            }
+        }
+        return A;
+    }
+
+    template <class M>
+    void checkEqual(const M& A, const M& B)
+    {
+        BOOST_REQUIRE_EQUAL(A.N(), B.N());
+        BOOST_REQUIRE_EQUAL(A.M(), B.M());
+        BOOST_REQUIRE_EQUAL(A.nonzeroes(), B.nonzeroes());
+        for (auto row = A.begin(); row != A.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                BOOST_REQUIRE(B.exists(row.index(), col.index()));
+                BOOST_CHECK(*col == B[row.index()][col.index()]);
+            }
+        }
+    }
+
+    struct SnapshotFile
+    {
+        SnapshotFile() : name("test_linearsystemsnapshot.linsys") {}
+        ~SnapshotFile() { std::remove(name.c_str()); }
+        std::string name;
+    };
+}
+
+BOOST_AUTO_TEST_CASE(WriteAndRead)
+{
+    const Matrix A = createMatrix<Matrix>(10, 10);
+    const OffDiagMatrix B = createMatrix<OffDiagMatrix>(1, 10);
+    Vector r(10);
+    for (std::size_t i = 0; i < r.size(); ++i) {
+        r[i] = { 1.0*i, -2.0*i, 0.5 };
+    }
+
+    SnapshotFile file;
+    {
+        Opm::LinearSystemSnapshotWriter writer(file.name);
+        writer.writeMatrix("matrix", A);
+        writer.writeVector("residual", r);
+        writer.writeMatrix("well/PROD/B", B);
+    }
+
+    const Opm::LinearSystemSnapshot snapshot(file.name);
+    BOOST_REQUIRE_EQUAL(snapshot.records().size(), 3);
+    BOOST_CHECK(snapshot.has("residual"));
+    BOOST_CHECK(!snapshot.has("preconditioner_matrix"));
+
+    checkEqual(A, snapshot.matrix<Matrix>("matrix"));
+    checkEqual(B, snapshot.matrix<OffDiagMatrix>("well/PROD/B"));
+    const Vector r2 = snapshot.vector<Vector>("residual");
+    BOOST_REQUIRE_EQUAL(r2.size(), r.size());
+    for (std::size_t i = 0; i < r.size(); ++i) {
+        BOOST_CHECK(r2[i] == r[i]);
+    }
+
+    // The raw arrays point into the mapped file.
+    const auto& record = snapshot.record("well/PROD/B");
+    BOOST_CHECK_EQUAL(record.rows, 1);
+    BOOST_CHECK_EQUAL(record.block_rows, 2);
+    BOOST_CHECK_EQUAL(record.block_cols, 3);
+    BOOST_CHECK_EQUAL(record.row_start[1], 2);
+    BOOST_CHECK_EQUAL(record.values[0], B[0][0][0][0]);
+
+    // The block size of the record must match.
+    BOOST_CHECK_THROW(snapshot.matrix<OffDiagMatrix>("matrix"), std::runtime_error);
+    BOOST_CHECK_THROW(snapshot.vector<Vector>("matrix"), std::runtime_error);
+    BOOST_CHECK_THROW(snapshot.record("well/INJ/B"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(Truncated)
+{
+    SnapshotFile file;
+    {
+        Opm::LinearSystemSnapshotWriter writer(file.name);
+        writer.writeMatrix("matrix", createMatrix<Matrix>(10, 10));
+    }
+    std::string content;
+    {
+        std::ifstream is(file.name.c_str(), std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream os(file.name.c_str(), std::ios::binary);
+        os.write(content.data(), content.size() - 8);
+    }
+    BOOST_CHECK_THROW(Opm::LinearSystemSnapshot snapshot(file.name), std::runtime_error);
+
+    {
+        std::ofstream os(file.name.c_str(), std::ios::binary);
+        os << "not a snapshot";
+    }
+    BOOST_CHECK_THROW(Opm::LinearSystemSnapshot snapshot(file.name), std::runtime_error);
+}
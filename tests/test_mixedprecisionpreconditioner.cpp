@@ -0,0 +1,183 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE MixedPrecisionPreconditionerTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/MixedPrecisionPreconditioner.hpp>
+#include <opm/autodiff/ParallelOverlappingILU0.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvers.hh>
+
+#include <memory>
+
+namespace
+{
+    const int blockSize = 2;
+
+    typedef Dune::FieldMatrix<double, blockSize, blockSize> Block;
+    typedef Dune::BCRSMatrix<Block> Matrix;
+    typedef Dune::BlockVector<Dune::FieldVector<double, blockSize> > Vector;
+
+    typedef Dune::BCRSMatrix<Dune::FieldMatrix<float, blockSize, blockSize> > FloatMatrix;
+    typedef Dune::BlockVector<Dune::FieldVector<float, blockSize> > FloatVector;
+
+    // block tridiagonal matrix of a one-dimensional Laplacian with a
+    // coupling between the two unknowns of each cell
+    Matrix laplace1d(const int n)
+    {
+        Matrix A(n, n, 3*n - 2, Matrix::row_wise);
+        for (auto row = A.createbegin(); row != A.createend(); ++row) {
+            const int i = row.index();
+            if (i > 0) {
+                row.insert(i - 1);
+            }
+            row.insert(i);
+            if (i < n - 1) {
+                row.insert(i + 1);
+            }
+        }
+
+        for (int i = 0; i < n; ++i) {
+            Block diag(0.0);
+            diag[0][0] = 2.0 + 1e-3;
+            diag[1][1] = 2.0 + 1e-3;
+            diag[0][1] = 0.5;
+            diag[1][0] = 0.25;
+            A[i][i] = diag;
+            if (i > 0) {
+                A[i][i - 1] = 0.0;
+                A[i][i - 1][0][0] = -1.0;
+                A[i][i - 1][1][1] = -1.0;
+            }
+            if (i < n - 1) {
+                A[i][i + 1] = 0.0;
+                A[i][i + 1][0][0] = -1.0;
+                A[i][i + 1][1][1] = -1.0;
+            }
+        }
+        return A;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CopyMatrixValues)
+{
+    const Matrix A = laplace1d(10);
+    std::unique_ptr<FloatMatrix> B;
+    Opm::copyMatrixValues(A, B);
+
+    BOOST_REQUIRE(B);
+    BOOST_CHECK_EQUAL(B->N(), A.N());
+    BOOST_CHECK_EQUAL(B->nonzeroes(), A.nonzeroes());
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            for (int i = 0; i < blockSize; ++i) {
+                for (int j = 0; j < blockSize; ++j) {
+                    BOOST_CHECK_CLOSE((*B)[row.index()][col.index()][i][j],
+                                      float((*col)[i][j]), 1e-6);
+                }
+            }
+        }
+    }
+
+    // The storage is kept if the sparsity pattern does not change.
+    const FloatMatrix* storage = B.get();
+    Opm::copyMatrixValues(A, B);
+    BOOST_CHECK(B.get() == storage);
+}
+
+BOOST_AUTO_TEST_CASE(CopyMatrixValuesChangedPattern)
+{
+    // The same number of nonzeroes as laplace1d, but the first row is
+    // coupled to the third cell instead of the second.
+    const int n = 10;
+    Matrix A(n, n, 3*n - 2, Matrix::row_wise);
+    for (auto row = A.createbegin(); row != A.createend(); ++row) {
+        const int i = row.index();
+        if (i == 0) {
+            row.insert(0);
+            row.insert(2);
+            continue;
+        }
+        row.insert(i - 1);
+        row.insert(i);
+        if (i < n - 1) {
+            row.insert(i + 1);
+        }
+    }
+    A = 1.0;
+    A[0][2] = 5.0;
+    A[0][0] = 3.0;
+
+    std::unique_ptr<FloatMatrix> B;
+    Opm::copyMatrixValues(laplace1d(n), B);
+    BOOST_REQUIRE_EQUAL(B->nonzeroes(), A.nonzeroes());
+    BOOST_CHECK(!Opm::sameSparsityPattern(A, *B));
+
+    Opm::copyMatrixValues(A, B);
+    BOOST_CHECK(Opm::sameSparsityPattern(A, *B));
+    BOOST_CHECK(B->exists(0, 2));
+    BOOST_CHECK(!B->exists(0, 1));
+    for (auto row = A.begin(); row != A.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            for (int i = 0; i < blockSize; ++i) {
+                for (int j = 0; j < blockSize; ++j) {
+                    BOOST_CHECK_CLOSE((*B)[row.index()][col.index()][i][j],
+                                      float((*col)[i][j]), 1e-6);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolveWithFloatILU0)
+{
+    const int n = 100;
+    Matrix A = laplace1d(n);
+
+    std::unique_ptr<FloatMatrix> floatA;
+    Opm::copyMatrixValues(A, floatA);
+
+    typedef Opm::ParallelOverlappingILU0<FloatMatrix, FloatVector, FloatVector> FloatILU0;
+    FloatILU0 ilu(*floatA, 0, 1.0);
+    Opm::MixedPrecisionPreconditioner<Vector, FloatILU0> precond(ilu);
+
+    Vector x(n), b(n);
+    b = 1.0;
+    x = 0.0;
+    const Vector rhs = b;
+
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+    Dune::SeqScalarProduct<Vector> sp;
+    // The reduction is far below the float precision, which only the
+    // double precision Krylov method can reach.
+    Dune::BiCGSTABSolver<Vector> solver(op, sp, precond, 1e-10, 200, 0);
+    Dune::InverseOperatorResult result;
+    solver.apply(x, b, result);
+    BOOST_CHECK(result.converged);
+
+    Vector residual = rhs;
+    A.mmv(x, residual);
+    BOOST_CHECK_SMALL(residual.two_norm() / rhs.two_norm(), 1e-9);
+}
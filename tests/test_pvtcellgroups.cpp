@@ -0,0 +1,148 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PvtCellGroupsTest
+
+#include <opm/autodiff/PvtCellGroups.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    const int num_cells = 5000;
+
+    // Two regions of 2500 cells each, so that every group of the
+    // evaluated cells spans several chunks.
+    std::vector<int> twoRegions()
+    {
+        std::vector<int> region(num_cells);
+        for (int c = 0; c < num_cells; ++c) {
+            region[c] = (c < num_cells / 2) ? 0 : 1;
+        }
+        return region;
+    }
+
+    // All cells, interleaved so that the groups are not contiguous.
+    std::vector<int> interleavedCells()
+    {
+        std::vector<int> cells(num_cells);
+        for (int i = 0; i < num_cells; ++i) {
+            cells[i] = (i * 7) % num_cells;
+        }
+        return cells;
+    }
+
+    // Check that forEach visits each evaluated cell once, with the
+    // region of its cell and its presence flag.
+    template <class Presence>
+    void checkVisits(const PvtCellGroups& groups,
+                     const std::vector<int>& region,
+                     const std::vector<int>& cells,
+                     const Presence& presence)
+    {
+        const int n = cells.size();
+        std::vector<int> visits(n, 0);
+        std::vector<int> visited_region(n, -1);
+        std::vector<int> visited_flag(n, -1);
+        // Each i is in exactly one chunk, so the writes do not race.
+        groups.forEach([&](const unsigned pvtRegionIdx, const bool flag, const int i) {
+                ++visits[i];
+                visited_region[i] = pvtRegionIdx;
+                visited_flag[i] = flag;
+            });
+        for (int i = 0; i < n; ++i) {
+            BOOST_CHECK_EQUAL(visits[i], 1);
+            BOOST_CHECK_EQUAL(visited_region[i], region[cells[i]]);
+            BOOST_CHECK_EQUAL(visited_flag[i], presence(i) ? 1 : 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TwoRegionsManyChunks)
+{
+    const std::vector<int> region = twoRegions();
+    const std::vector<int> cells = interleavedCells();
+    const auto presence = [](const int i) { return i % 3 == 0; };
+
+    PvtCellGroups groups;
+    groups.update(region, cells, presence);
+    // Four groups: both regions, with and without the flag. The groups
+    // without the flag have more than 1024 cells.
+    BOOST_CHECK(groups.numChunks() > 4);
+    checkVisits(groups, region, cells, presence);
+}
+
+BOOST_AUTO_TEST_CASE(PresenceChange)
+{
+    const std::vector<int> region = twoRegions();
+    const std::vector<int> cells = interleavedCells();
+    const auto all_free = [](const int) { return true; };
+    const auto some_free = [](const int i) { return i % 2 == 0; };
+
+    PvtCellGroups groups;
+    groups.update(region, cells, all_free);
+    const int num_chunks = groups.numChunks();
+    checkVisits(groups, region, cells, all_free);
+
+    // The same keys keep the groups.
+    groups.update(region, cells, all_free);
+    BOOST_CHECK_EQUAL(groups.numChunks(), num_chunks);
+    checkVisits(groups, region, cells, all_free);
+
+    // Changing the presence of the same cells regroups them.
+    groups.update(region, cells, some_free);
+    BOOST_CHECK(groups.numChunks() > num_chunks);
+    checkVisits(groups, region, cells, some_free);
+
+    // And so does evaluating fewer cells with the same presence.
+    const std::vector<int> fewer(cells.begin(), cells.begin() + 1000);
+    groups.update(region, fewer, some_free);
+    BOOST_CHECK_EQUAL(groups.numChunks(), 4);
+    checkVisits(groups, region, fewer, some_free);
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionRethrown)
+{
+    const std::vector<int> region = twoRegions();
+    const std::vector<int> cells = interleavedCells();
+    const auto presence = [](const int i) { return i % 5 == 0; };
+
+    PvtCellGroups groups;
+    groups.update(region, cells, presence);
+    BOOST_CHECK_THROW(groups.forEach([](unsigned, bool, const int i) {
+                if (i == num_cells - 1) {
+                    throw std::runtime_error("evaluation failed");
+                }
+            }), std::runtime_error);
+
+    // Throwing in several chunks rethrows one of the exceptions.
+    BOOST_CHECK_THROW(groups.forEach([](const unsigned pvtRegionIdx, bool, int) {
+                if (pvtRegionIdx == 1) {
+                    throw std::runtime_error("region 1 failed");
+                }
+            }), std::runtime_error);
+
+    // The groups can still be used after a failed evaluation.
+    checkVisits(groups, region, cells, presence);
+}
@@ -0,0 +1,68 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE StateCheckpointTest
+
+#include <opm/simulators/timestepping/StateCheckpoint.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using namespace Opm;
+
+BOOST_AUTO_TEST_CASE(RollbackRestoresSnapshot)
+{
+    std::vector<double> state = { 1.0, 2.0, 3.0 };
+    StateCheckpoint< std::vector<double> > checkpoint(state);
+
+    checkpoint.prepare();
+    state[1] = 5.0;
+    BOOST_CHECK_EQUAL(checkpoint.snapshot()[1], 2.0);
+
+    checkpoint.rollback();
+    BOOST_CHECK_EQUAL(state[1], 2.0);
+
+    // the snapshot stays valid after a rollback
+    checkpoint.prepare();
+    state[2] = 7.0;
+    checkpoint.rollback();
+    BOOST_CHECK_EQUAL(state[2], 3.0);
+    BOOST_CHECK_EQUAL(checkpoint.copies(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(CommitDefersCopy)
+{
+    std::vector<double> state = { 1.0, 2.0 };
+    StateCheckpoint< std::vector<double> > checkpoint(state);
+
+    checkpoint.prepare();
+    state[0] = 4.0;
+    checkpoint.commit();
+    // no copy until the state is about to be modified again
+    BOOST_CHECK_EQUAL(checkpoint.copies(), 1);
+
+    checkpoint.prepare();
+    BOOST_CHECK_EQUAL(checkpoint.copies(), 2);
+    BOOST_CHECK_EQUAL(checkpoint.snapshot()[0], 4.0);
+
+    state[0] = 8.0;
+    checkpoint.rollback();
+    BOOST_CHECK_EQUAL(state[0], 4.0);
+}
@@ -0,0 +1,112 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <config.h>
+
+#define BOOST_TEST_MODULE TracerTests
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/Tracer.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(NestedScopes)
+{
+    Opm::Tracer& tracer = Opm::Tracer::instance();
+    tracer.clear();
+
+    {
+        Opm::TraceScope outer("outer");
+        for (int i = 0; i < 3; ++i) {
+            Opm::TraceScope inner("inner \"quoted\"");
+        }
+    }
+    BOOST_CHECK_EQUAL(tracer.numEvents(), 4u);
+
+    std::ostringstream os;
+    tracer.writeChromeTrace(os, 7);
+    const std::string trace = os.str();
+
+    BOOST_CHECK(trace.find("{\"traceEvents\":[") == 0);
+    BOOST_CHECK(trace.find("\"name\":\"outer\",\"ph\":\"X\"") != std::string::npos);
+    BOOST_CHECK(trace.find("inner \\\"quoted\\\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"pid\":7") != std::string::npos);
+    BOOST_CHECK(trace.find("\"args\":{\"name\":\"rank 7\"}") != std::string::npos);
+
+    tracer.clear();
+    BOOST_CHECK_EQUAL(tracer.numEvents(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(Durations)
+{
+    Opm::Tracer& tracer = Opm::Tracer::instance();
+    tracer.clear();
+
+    const auto start = tracer.now();
+    tracer.record("manual", start, start + 2500);
+    BOOST_CHECK_EQUAL(tracer.numEvents(), 1u);
+
+    std::ostringstream os;
+    tracer.writeChromeTrace(os, 0);
+    // the durations are written in microseconds
+    BOOST_CHECK(os.str().find("\"dur\":2.500") != std::string::npos);
+    tracer.clear();
+}
+
+BOOST_AUTO_TEST_CASE(GatheredTrace)
+{
+    Opm::Tracer& tracer = Opm::Tracer::instance();
+    tracer.clear();
+    for (int i = 0; i < 20; ++i) {
+        Opm::TraceScope scope("gathered");
+    }
+
+    const auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    if (cc.size() == 1) {
+        std::ostringstream expected;
+        tracer.writeChromeTrace(expected, 0);
+
+        // Gathering in pieces of a few bytes must give the same file.
+        const std::string filename = "test_tracer_gathered.json";
+        for (const std::size_t maxGatherBytes : { std::size_t(7), std::size_t(1) << 30 }) {
+            tracer.writeChromeTrace(filename, cc, maxGatherBytes);
+            std::ifstream is(filename);
+            std::stringstream written;
+            written << is.rdbuf();
+            BOOST_CHECK_EQUAL(written.str(), expected.str());
+        }
+        std::remove(filename.c_str());
+    }
+    tracer.clear();
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    boost::unit_test::unit_test_main(&init_unit_test_func,
+                                     argc, argv);
+}
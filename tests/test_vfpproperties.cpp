@@ -972,6 +972,38 @@ BOOST_AUTO_TEST_CASE(THPToBHPAndBackNonTrivial)
 
 
 
+BOOST_AUTO_TEST_CASE(BatchedBHPAndTHP)
+{
+    fillDataRandom();
+    initProperties();
+
+    const std::size_t nw = 5;
+    const std::vector<int> table_id(nw, 1);
+    const std::vector<double> aqua = {-0.5, -0.1, -0.3, -0.7, -0.2};
+    const std::vector<double> liquid = {-0.9, -0.4, -0.6, -0.2, -0.8};
+    const std::vector<double> vapour = {-0.1, -0.3, -0.5, -0.6, -0.05};
+    const std::vector<double> thp = {50.0, 0.2, 0.7, -3.0, 12.0};
+    const std::vector<double> alq = {32.9, 0.1, 0.55, 0.9, -1.0};
+
+    const std::vector<VFPEvaluation> bhp = properties->bhp(table_id, aqua, liquid, vapour, thp, alq);
+    BOOST_REQUIRE_EQUAL(bhp.size(), nw);
+
+    std::vector<double> bhp_val(nw);
+    for (std::size_t w = 0; w < nw; ++w) {
+        bhp_val[w] = properties->bhp(1, aqua[w], liquid[w], vapour[w], thp[w], alq[w]);
+        BOOST_CHECK_EQUAL(bhp[w].value, bhp_val[w]);
+    }
+
+    const std::vector<double> thp_val = properties->thp(table_id, aqua, liquid, vapour, bhp_val, alq);
+    BOOST_REQUIRE_EQUAL(thp_val.size(), nw);
+    for (std::size_t w = 0; w < nw; ++w) {
+        BOOST_CHECK_EQUAL(thp_val[w], properties->thp(1, aqua[w], liquid[w], vapour[w], bhp_val[w], alq[w]));
+        BOOST_CHECK_CLOSE(thp_val[w], thp[w], max_d_tol);
+    }
+}
+
+
+
 
 BOOST_AUTO_TEST_SUITE_END() // Trivial tests
 
@@ -0,0 +1,144 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE VtkWriterTests
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/vtk/VtkWriter.hpp>
+#include <opm/grid/UnstructuredGrid.h>
+#include <opm/grid/cart_grid.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if HAVE_ZLIB
+#include <zlib.h>
+#endif // HAVE_ZLIB
+
+namespace
+{
+    // The offset in the appended data of the array with the given name.
+    std::size_t arrayOffset(const std::string& vtu, const std::string& name)
+    {
+        const std::string::size_type array = vtu.find("Name=\"" + name + "\"");
+        BOOST_REQUIRE(array != std::string::npos);
+        const std::string::size_type offset = vtu.find("offset=\"", array);
+        return std::stoul(vtu.substr(offset + 8));
+    }
+
+    // The bytes of an array, decompressing them if required.
+    std::vector<char> arrayBytes(const std::string& vtu, const std::string& name, const bool compressed)
+    {
+        const std::size_t start = vtu.find("<AppendedData encoding=\"raw\">");
+        BOOST_REQUIRE(start != std::string::npos);
+        const char* pos = vtu.data() + vtu.find('_', start) + 1 + arrayOffset(vtu, name);
+
+        std::vector<std::uint64_t> header(1);
+        std::memcpy(header.data(), pos, sizeof(std::uint64_t));
+        if (!compressed) {
+            pos += sizeof(std::uint64_t);
+            return std::vector<char>(pos, pos + header[0]);
+        }
+
+        const std::size_t num_blocks = header[0];
+        header.resize(3 + num_blocks);
+        std::memcpy(header.data(), pos, header.size()*sizeof(std::uint64_t));
+        pos += header.size()*sizeof(std::uint64_t);
+        std::vector<char> bytes;
+#if HAVE_ZLIB
+        for (std::size_t block = 0; block < num_blocks; ++block) {
+            uLongf size = (block + 1 == num_blocks) ? header[2] : header[1];
+            const std::size_t begin = bytes.size();
+            bytes.resize(begin + size);
+            BOOST_REQUIRE_EQUAL(uncompress(reinterpret_cast<Bytef*>(&bytes[begin]), &size,
+                                           reinterpret_cast<const Bytef*>(pos), header[3 + block]),
+                                Z_OK);
+            pos += header[3 + block];
+        }
+#endif // HAVE_ZLIB
+        return bytes;
+    }
+
+    template <class T>
+    std::vector<T> arrayValues(const std::string& vtu, const std::string& name, const bool compressed)
+    {
+        const std::vector<char> bytes = arrayBytes(vtu, name, compressed);
+        std::vector<T> values(bytes.size() / sizeof(T));
+        std::memcpy(values.data(), bytes.data(), bytes.size());
+        return values;
+    }
+
+    void checkFile(const bool compressed)
+    {
+        std::shared_ptr<UnstructuredGrid> grid(create_grid_cart3d(3, 2, 2), destroy_grid);
+        std::vector<double> pressure(grid->number_of_cells);
+        std::vector<double> saturation(2*grid->number_of_cells);
+        for (int c = 0; c < grid->number_of_cells; ++c) {
+            pressure[c] = 1e5 + c;
+            saturation[2*c] = 0.1*c;
+            saturation[2*c + 1] = 1.0 - 0.1*c;
+        }
+        Opm::DataMap data;
+        data["pressure"] = &pressure;
+        data["saturation"] = &saturation;
+
+        const Opm::VtkWriter writer(*grid, compressed);
+        std::ostringstream os;
+        writer.write(data, os);
+        const std::string vtu = os.str();
+
+        BOOST_CHECK(vtu.find("NumberOfCells=\"12\"") != std::string::npos);
+        BOOST_CHECK_EQUAL(vtu.find("compressor=\"vtkZLibDataCompressor\"") != std::string::npos, compressed);
+
+        const std::vector<double> points = arrayValues<double>(vtu, "Coordinates", compressed);
+        BOOST_CHECK_EQUAL_COLLECTIONS(points.begin(), points.end(),
+                                      grid->node_coordinates,
+                                      grid->node_coordinates + 3*grid->number_of_nodes);
+        // All cells are hexahedra.
+        const std::vector<std::int32_t> offsets = arrayValues<std::int32_t>(vtu, "offsets", compressed);
+        BOOST_REQUIRE_EQUAL(offsets.size(), std::size_t(grid->number_of_cells));
+        BOOST_CHECK_EQUAL(offsets.back(), 8*grid->number_of_cells);
+
+        const std::vector<double> p = arrayValues<double>(vtu, "pressure", compressed);
+        BOOST_CHECK_EQUAL_COLLECTIONS(p.begin(), p.end(), pressure.begin(), pressure.end());
+        const std::vector<double> s = arrayValues<double>(vtu, "saturation", compressed);
+        BOOST_CHECK_EQUAL_COLLECTIONS(s.begin(), s.end(), saturation.begin(), saturation.end());
+
+        // The cached geometry is written again for the next file.
+        std::ostringstream os2;
+        writer.write(data, os2);
+        BOOST_CHECK(os2.str() == vtu);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AppendedRaw)
+{
+    checkFile(false);
+}
+
+#if HAVE_ZLIB
+BOOST_AUTO_TEST_CASE(AppendedCompressed)
+{
+    checkFile(true);
+}
+#endif // HAVE_ZLIB
@@ -0,0 +1,113 @@
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE WellIndexMapTests
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/simulator/WellIndexMap.hpp>
+
+#include <string>
+
+namespace
+{
+    std::string wellName(const int w)
+    {
+        return "W" + std::to_string(w);
+    }
+
+    // Wells with w + 1 perforations each.
+    Opm::WellIndexMap createMap(const int nw)
+    {
+        Opm::WellIndexMap map;
+        int perf = 0;
+        for (int w = 0; w < nw; ++w) {
+            auto& entry = map[wellName(w)];
+            entry[0] = w;
+            entry[1] = perf;
+            entry[2] = w + 1;
+            perf += w + 1;
+        }
+        return map;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Lookup)
+{
+    const int nw = 1000;
+    const Opm::WellIndexMap map = createMap(nw);
+    BOOST_CHECK_EQUAL(map.size(), nw);
+    BOOST_CHECK(!map.empty());
+
+    int perf = 0;
+    for (int w = 0; w < nw; ++w) {
+        const auto it = map.find(wellName(w));
+        BOOST_REQUIRE(it != map.end());
+        BOOST_CHECK_EQUAL(it->first, wellName(w));
+        BOOST_CHECK_EQUAL(it->second[0], w);
+        BOOST_CHECK_EQUAL(it->second[1], perf);
+        BOOST_CHECK_EQUAL(it->second[2], w + 1);
+        perf += w + 1;
+    }
+    BOOST_CHECK(map.find("PROD") == map.end());
+    BOOST_CHECK(Opm::WellIndexMap().find("PROD") == Opm::WellIndexMap().end());
+}
+
+BOOST_AUTO_TEST_CASE(InsertionOrder)
+{
+    Opm::WellIndexMap map;
+    map["PROD"][0] = 0;
+    map["INJ"][0] = 1;
+    map["ABC"][0] = 2;
+    // looking up a present well does not insert it again
+    map["INJ"][2] = 5;
+    BOOST_REQUIRE_EQUAL(map.size(), 3);
+
+    int w = 0;
+    for (const auto& entry : map) {
+        BOOST_CHECK_EQUAL(entry.second[0], w++);
+    }
+    BOOST_CHECK_EQUAL(map.find("INJ")->second[2], 5);
+
+    map.clear();
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.find("PROD") == map.end());
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndCompare)
+{
+    const Opm::WellIndexMap map = createMap(100);
+    Opm::WellIndexMap copy;
+    copy = map;
+    BOOST_CHECK(copy == map);
+    BOOST_CHECK_EQUAL(copy.find(wellName(42))->second[0], 42);
+
+    // The same wells in a different order.
+    Opm::WellIndexMap reordered;
+    reordered.reserve(100);
+    for (int w = 99; w >= 0; --w) {
+        reordered[wellName(w)] = map.find(wellName(w))->second;
+    }
+    BOOST_CHECK(reordered != map);
+
+    // A well with another number of perforations.
+    copy = createMap(100);
+    Opm::WellIndexMap changed = createMap(99);
+    changed["W99"] = {{ 99, map.find("W99")->second[1], 1 }};
+    BOOST_CHECK(changed != copy);
+}